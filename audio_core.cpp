@@ -3,6 +3,7 @@
 
 #include <audio_core/audio_core.h>
 #include <audio_core/sink/sink_details.h>
+#include <audio_core/common/logging/log.h>
 #include <audio_core/common/settings.h>
 #include <core/core.h>
 
@@ -47,6 +48,14 @@ AudioRenderer::ADSP::ADSP& AudioCore::GetADSP() {
     return *adsp;
 }
 
+AudioRenderer::ADSP::CommandTimingReport AudioCore::GetCommandTimingReport(const u32 session_id) {
+    if (session_id >= MaxRendererSessions) {
+        LOG_ERROR(Service_Audio, "Invalid renderer session {}", session_id);
+        return {};
+    }
+    return adsp->GetCommandTimingReport(session_id);
+}
+
 void AudioCore::SetNVDECActive(bool active) {
     nvdec_active = active;
 }
@@ -57,6 +57,16 @@ public:
      */
     AudioRenderer::ADSP::ADSP& GetADSP();
 
+    /**
+     * Get the time taken by each type of command in an AudioRenderer session, with p50/p99/max
+     * per type and the most expensive nodes. Requires
+     * Settings::values.audio_command_timing_statistics to be enabled.
+     *
+     * @param session_id - The renderer session to report (0 or 1).
+     * @return The timing report.
+     */
+    AudioRenderer::ADSP::CommandTimingReport GetCommandTimingReport(u32 session_id);
+
     /**
      * Toggle NVDEC state, used to avoid stall in playback.
      *
@@ -1,10 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
-#include <range/v3/algorithm.hpp>
 #include <audio_core/audio_event.h>
 #include <audio_core/common/assert.h>
-#include <audio_core/common/polyfill_ranges.h>
 
 namespace AudioCore {
 
@@ -25,9 +23,11 @@ size_t Event::GetManagerIndex(const Type type) const {
 }
 
 void Event::SetAudioEvent(const Type type, const bool signalled) {
-    events_signalled[GetManagerIndex(type)] = signalled;
-    if (signalled) {
-        manager_event.notify_one();
+    // Only wake the manager when the event becomes set, it handles every set event once woken.
+    if (!signalled) {
+        events_signalled[GetManagerIndex(type)] = false;
+    } else if (!events_signalled[GetManagerIndex(type)].exchange(true)) {
+        manager_event.signal();
     }
 }
 
@@ -35,22 +35,13 @@ bool Event::CheckAudioEventSet(const Type type) const {
     return events_signalled[GetManagerIndex(type)];
 }
 
-std::mutex& Event::GetAudioEventLock() {
-    return event_lock;
+bool Event::TakeAudioEvent(const Type type) {
+    return events_signalled[GetManagerIndex(type)].exchange(false);
 }
 
-std::condition_variable_any& Event::GetAudioEvent() {
-    return manager_event;
-}
-
-bool Event::Wait(std::unique_lock<std::mutex>& l, const std::chrono::seconds timeout) {
-    bool timed_out{false};
-    if (!manager_event.wait_for(l, timeout, [&]() {
-            return ranges::any_of(events_signalled, [](bool x) { return x; });
-        })) {
-        timed_out = true;
-    }
-    return timed_out;
+bool Event::Wait(const std::chrono::seconds timeout) {
+    const auto timeout_us{std::chrono::duration_cast<std::chrono::microseconds>(timeout)};
+    return !manager_event.wait(timeout_us.count());
 }
 
 void Event::ClearEvents() {
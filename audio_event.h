@@ -6,8 +6,8 @@
 #include <array>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
-#include <mutex>
+
+#include <audio_core/common/atomic_helpers.h>
 
 namespace AudioCore {
 /**
@@ -17,6 +17,7 @@ namespace AudioCore {
  * In a real Switch this is not a separate class, and exists entirely within the audio manager.
  * On the Switch it's implemented more simply through a MultiWaitEventHolder, where it can
  * wait on multiple events at once, and the events are not needed by the backend.
+ * Setting an event never takes a lock, so it's safe from the backend's real-time callbacks.
  */
 class Event {
 public:
@@ -36,7 +37,7 @@ public:
     size_t GetManagerIndex(Type type) const;
 
     /**
-     * Set an audio event to true or false.
+     * Set an audio event to true or false, waking the audio manager when it becomes set.
      *
      * @param type      - The manager type to signal.
      * @param signalled - Its signal state.
@@ -52,28 +53,22 @@ public:
     bool CheckAudioEventSet(Type type) const;
 
     /**
-     * Get the lock for audio events.
-     *
-     * @return Reference to the lock.
-     */
-    std::mutex& GetAudioEventLock();
-
-    /**
-     * Get the manager event, this signals the audio manager to release buffers and signal the game
-     * for more.
+     * Check if the given manager type is signalled, and reset it. It's reset before its buffers
+     * are handled, so an event set meanwhile is kept for the next wait.
      *
-     * @return Reference to the condition variable.
+     * @param type - The manager type to take.
+     * @return True if the event was signalled, otherwise false.
      */
-    std::condition_variable_any& GetAudioEvent();
+    bool TakeAudioEvent(Type type);
 
     /**
-     * Wait on the manager_event.
+     * Wait for an event to be set. May return early without one set, if it was taken after
+     * waking a previous wait.
      *
-     * @param l       - Lock held by the wait.
      * @param timeout - Timeout for the wait. This is 2 seconds by default.
      * @return True if the wait timed out, otherwise false if signalled.
      */
-    bool Wait(std::unique_lock<std::mutex>& l, std::chrono::seconds timeout);
+    bool Wait(std::chrono::seconds timeout);
 
     /**
      * Reset all manager events.
@@ -81,12 +76,10 @@ public:
     void ClearEvents();
 
 private:
-    /// Lock, used by the audio manager
-    std::mutex event_lock;
     /// Array of events, one per system type (see Type), last event is used to terminate
     std::array<std::atomic<bool>, 4> events_signalled;
-    /// Event to signal the audio manager
-    std::condition_variable_any manager_event;
+    /// Signalled whenever an event becomes set, to wake the audio manager
+    Common::spsc_sema::LightweightSemaphore manager_event;
 };
 
 } // namespace AudioCore
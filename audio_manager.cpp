@@ -2,12 +2,17 @@
 // SPDX-License-Identifier: MPL-2.0
 
 #include <audio_core/audio_manager.h>
+#include <audio_core/common/settings.h>
+#include <audio_core/common/thread.h>
 #include <core/core.h>
 #include <core/hle/service/audio/errors.h>
 
 namespace AudioCore {
 
 AudioManager::AudioManager() {
+    // Set up before the thread starts, so a Shutdown straight away isn't undone by it.
+    events.ClearEvents();
+    running = true;
     thread = std::jthread([this]() { ThreadFunc(); });
 }
 
@@ -54,12 +59,12 @@ void AudioManager::SetEvent(const Event::Type type, const bool signalled) {
 }
 
 void AudioManager::ThreadFunc() {
-    std::unique_lock l{events.GetAudioEventLock()};
-    events.ClearEvents();
-    running = true;
+    Common::SetCurrentThreadName("AudioManager");
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    Common::SetCurrentThreadAffinity(Settings::values.audio_thread_cpu_mask);
 
     while (running) {
-        const auto timed_out{events.Wait(l, std::chrono::seconds(2))};
+        const auto timed_out{events.Wait(std::chrono::seconds(2))};
 
         if (events.CheckAudioEventSet(Event::Type::Max)) {
             break;
@@ -68,12 +73,12 @@ void AudioManager::ThreadFunc() {
         for (size_t i = 0; i < buffer_events.size(); i++) {
             const auto event_type = static_cast<Event::Type>(i);
 
-            if (events.CheckAudioEventSet(event_type) || timed_out) {
+            // Taken before handling, so an event set while the buffers are handled isn't lost.
+            if (events.TakeAudioEvent(event_type) || timed_out) {
                 if (buffer_events[i]) {
                     buffer_events[i]();
                 }
             }
-            events.SetAudioEvent(event_type, false);
         }
     }
 }
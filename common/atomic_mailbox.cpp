@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "atomic_mailbox.h"
+
+namespace Common {
+
+namespace {
+void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/// Sleeps until woken, unless the state no longer holds the expected value
+void WaitOnState(std::atomic<u32>& state, u32 expected) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<u32*>(&state), FUTEX_WAIT_PRIVATE, expected, nullptr,
+            nullptr, 0);
+#else
+    state.wait(expected, std::memory_order_relaxed);
+#endif
+}
+
+/// Wakes the thread sleeping on the state
+void WakeState(std::atomic<u32>& state) {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<u32*>(&state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#else
+    state.notify_one();
+#endif
+}
+} // namespace
+
+void AtomicMailbox::Send(u32 message) {
+    u32 current{state.load(std::memory_order_relaxed)};
+    do {
+        // Wait for the receiver to take the previous message, which a request/response exchange
+        // never has to.
+        while ((current & FullBit) != 0) {
+            std::this_thread::yield();
+            current = state.load(std::memory_order_relaxed);
+        }
+    } while (!state.compare_exchange_weak(current, FullBit | (message & ValueMask),
+                                          std::memory_order_release, std::memory_order_relaxed));
+
+    if ((current & WaiterBit) != 0) {
+        WakeState(state);
+    }
+}
+
+u32 AtomicMailbox::Receive() {
+    for (u32 spin = 0; spin < spins; spin++) {
+        if (const u32 current{state.load(std::memory_order_acquire)}; (current & FullBit) != 0) {
+            state.store(0, std::memory_order_relaxed);
+            spins = std::min(spins * 2, MaxSpins);
+            return current & ValueMask;
+        }
+        CpuRelax();
+    }
+
+    // The message didn't arrive while spinning, so spin for less next time.
+    spins = std::max(spins / 2, MinSpins);
+
+    while (true) {
+        u32 current{state.load(std::memory_order_acquire)};
+        if ((current & FullBit) != 0) {
+            state.store(0, std::memory_order_relaxed);
+            return current & ValueMask;
+        }
+
+        // Tell the sender to wake us before sleeping. This fails if a message arrived meanwhile.
+        if ((current & WaiterBit) == 0 &&
+            !state.compare_exchange_weak(current, WaiterBit, std::memory_order_relaxed)) {
+            continue;
+        }
+
+        WaitOnState(state, WaiterBit);
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#pragma once
+
+#include <atomic>
+
+#include "common_types.h"
+
+namespace Common {
+
+/**
+ * @brief A single-slot mailbox passing messages from one thread to another through one atomic word
+ * @details The receiver spins briefly before sleeping on the word with a futex, adapting the spin
+ *          to how often it pays off. Sending only makes a syscall when the receiver is asleep, so a
+ *          handoff costs an atomic exchange rather than a mutex and condition variable round trip
+ * @note Designed for request/response exchanges where the slot is empty when sending, a sender
+ *       waits for an occupied slot to be emptied first
+ */
+class AtomicMailbox {
+public:
+    /**
+     * @brief Places a message in the slot, waking the receiver if it's asleep
+     * @param message The message, must fit in ValueMask
+     */
+    void Send(u32 message);
+
+    /**
+     * @brief Waits for a message and takes it out of the slot
+     * @note Only a single thread may receive from a mailbox
+     */
+    u32 Receive();
+
+private:
+    static constexpr u32 FullBit{1U << 30};      //!< Set while the slot holds a message
+    static constexpr u32 WaiterBit{1U << 31};    //!< Set while the receiver sleeps, or is about to
+    static constexpr u32 ValueMask{FullBit - 1}; //!< The bits holding the message
+    static constexpr u32 MinSpins{16};           //!< Fewest spins before the receiver sleeps
+    static constexpr u32 MaxSpins{128};          //!< Most spins before sleeping, ~6us at 140 cycles
+
+    std::atomic<u32> state{}; //!< The message, FullBit and WaiterBit
+    u32 spins{MinSpins};      //!< The current spin limit, only used by the receiver
+};
+
+} // namespace Common
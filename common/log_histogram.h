@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace Common {
+
+/// Log-linear histogram of unsigned values, recorded by a single thread and readable from any.
+/// @tparam sub_bucket_bits  log2 of the number of buckets per power of two
+/// @tparam value_bits       Values up to 2^value_bits get their own buckets, larger values share
+///                          the last bucket
+template <std::size_t sub_bucket_bits, std::size_t value_bits>
+class LogHistogram {
+public:
+    static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t bucket_count =
+        (value_bits - sub_bucket_bits + 1) * sub_bucket_count;
+
+    /// Copy of the histogram taken at one point in time
+    struct Snapshot {
+        std::array<std::uint32_t, bucket_count> buckets{};
+        std::uint64_t count{};
+        std::uint64_t max{};
+
+        /// Gets the value below which the given percentage of recorded values fall
+        /// @param percent  Percentile to get, 0-100
+        /// @returns The middle of the bucket holding the percentile, capped to the maximum value
+        std::uint64_t Percentile(std::uint64_t percent) const {
+            const std::uint64_t rank = count * percent / 100;
+            std::uint64_t seen = 0;
+            std::size_t index = bucket_count - 1;
+            for (std::size_t i = 0; i < bucket_count; i++) {
+                seen += buckets[i];
+                if (seen > rank) {
+                    index = i;
+                    break;
+                }
+            }
+            std::uint64_t value = GetBucketLowerBound(index);
+            if (index + 1 < bucket_count) {
+                value = (value + GetBucketLowerBound(index + 1)) / 2;
+            }
+            return std::min(value, max);
+        }
+    };
+
+    /// Records a value. Must only be called from one thread at a time.
+    void Record(std::uint64_t value) {
+        // With a single writer, plain loads and stores are enough.
+        constexpr auto order = std::memory_order_relaxed;
+        auto& bucket = m_buckets[GetBucketIndex(value)];
+        bucket.store(bucket.load(order) + 1, order);
+        if (value > m_max.load(order)) {
+            m_max.store(value, order);
+        }
+    }
+
+    /// Copies the current state of the histogram
+    [[nodiscard]] Snapshot GetSnapshot() const {
+        constexpr auto order = std::memory_order_relaxed;
+        Snapshot snapshot{};
+        for (std::size_t i = 0; i < bucket_count; i++) {
+            snapshot.buckets[i] = m_buckets[i].load(order);
+            snapshot.count += snapshot.buckets[i];
+        }
+        snapshot.max = m_max.load(order);
+        return snapshot;
+    }
+
+    /// Clears all recorded values. Values recorded concurrently may be lost.
+    void Reset() {
+        constexpr auto order = std::memory_order_relaxed;
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, order);
+        }
+        m_max.store(0, order);
+    }
+
+    /// Gets the bucket a value falls into
+    static constexpr std::size_t GetBucketIndex(std::uint64_t value) {
+        if (value < sub_bucket_count) {
+            return static_cast<std::size_t>(value);
+        }
+        const std::size_t msb = static_cast<std::size_t>(std::bit_width(value)) - 1;
+        const std::size_t sub = (value >> (msb - sub_bucket_bits)) & (sub_bucket_count - 1);
+        return std::min((msb - sub_bucket_bits + 1) * sub_bucket_count + sub, bucket_count - 1);
+    }
+
+    /// Gets the smallest value which falls into a bucket
+    static constexpr std::uint64_t GetBucketLowerBound(std::size_t index) {
+        if (index < sub_bucket_count) {
+            return index;
+        }
+        const std::size_t msb = index / sub_bucket_count + sub_bucket_bits - 1;
+        const std::size_t sub = index % sub_bucket_count;
+        return static_cast<std::uint64_t>(sub_bucket_count + sub) << (msb - sub_bucket_bits);
+    }
+
+private:
+    std::array<std::atomic<std::uint32_t>, bucket_count> m_buckets{};
+    std::atomic<std::uint64_t> m_max{};
+};
+
+} // namespace Common
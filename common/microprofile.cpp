@@ -0,0 +1,292 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "microprofile.h"
+
+namespace Common::Profiling {
+namespace {
+
+struct Scope {
+    const char* group;
+    const char* name;
+    u32 color;
+};
+
+struct Event {
+    u32 scope;
+    u32 thread;
+    u64 begin_ns;
+    u64 end_ns;
+};
+
+/**
+ * A ring of events written by a single thread. Once full it overwrites its oldest events, so the
+ * most recent are always kept.
+ * The collector reads while the thread may be writing. As with a seqlock, slots overwritten
+ * during the copy are detected through the claimed count and discarded.
+ */
+class EventRing {
+public:
+    /// Events held before the oldest are overwritten
+    static constexpr size_t Capacity{4096};
+
+    /**
+     * Write an event. Must only be called by the owning thread.
+     *
+     * @param scope    - ID of the scope.
+     * @param begin_ns - Time the scope began.
+     * @param end_ns   - Time the scope ended.
+     */
+    void Push(u32 scope, u64 begin_ns, u64 end_ns) {
+        const auto index{committed.load(std::memory_order_relaxed)};
+        claimed.store(index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto& slot{slots[index % Capacity]};
+        slot.scope.store(scope, std::memory_order_relaxed);
+        slot.begin_ns.store(begin_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        committed.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * Append every event written since the last drain which is still held, oldest first.
+     * Must be called with the registry mutex held.
+     *
+     * @param thread - ID of the owning thread, recorded in each event.
+     * @param out    - Container to append the events to.
+     */
+    void Drain(u32 thread, std::deque<Event>& out) {
+        const auto end{committed.load(std::memory_order_acquire)};
+        const auto begin{std::max(drained, end > Capacity ? end - Capacity : 0)};
+
+        std::vector<Event> events;
+        events.reserve(end - begin);
+        for (auto index{begin}; index != end; index++) {
+            const auto& slot{slots[index % Capacity]};
+            events.push_back({
+                .scope = slot.scope.load(std::memory_order_relaxed),
+                .thread = thread,
+                .begin_ns = slot.begin_ns.load(std::memory_order_relaxed),
+                .end_ns = slot.end_ns.load(std::memory_order_relaxed),
+            });
+        }
+
+        // Any slot the writer started overwriting while we copied may be torn, skip past those.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto overwritten{claimed.load(std::memory_order_relaxed)};
+        const auto valid_begin{overwritten > Capacity ? overwritten - Capacity : 0};
+        const auto torn{valid_begin > begin ? valid_begin - begin : 0};
+        const auto skipped{std::min(torn, static_cast<u64>(events.size()))};
+
+        out.insert(out.end(), events.begin() + static_cast<std::ptrdiff_t>(skipped), events.end());
+        drained = end;
+    }
+
+    /**
+     * Check if every written event has been drained.
+     *
+     * @return True if there's nothing left to drain, otherwise false.
+     */
+    bool Empty() const {
+        return drained == committed.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        std::atomic<u32> scope;
+        std::atomic<u64> begin_ns;
+        std::atomic<u64> end_ns;
+    };
+
+    std::array<Slot, Capacity> slots{};
+    /// Number of events the writer has started writing
+    std::atomic<u64> claimed{};
+    /// Number of events the writer has finished writing
+    std::atomic<u64> committed{};
+    /// Number of events already drained, only accessed by the collector
+    u64 drained{};
+};
+
+/// The events of a single thread, only pushed to by that thread and drained by the collector
+struct ThreadEvents {
+    u32 id;
+    std::string name;
+    EventRing events;
+};
+
+/// The collector keeps only the most recent events
+constexpr size_t MaxCollectedEvents{1 << 16};
+
+/// All profiling state shared between threads, guarded by the mutex
+struct Registry {
+    std::mutex mutex;
+    std::vector<Scope> scopes;
+    std::vector<std::shared_ptr<ThreadEvents>> threads;
+    std::deque<Event> collected;
+    /// Names of every thread which recorded events
+    std::vector<std::pair<u32, std::string>> thread_names;
+    u32 next_thread_id{1};
+};
+
+/**
+ * Get the registry. It's constructed on first use, as scopes are registered during static
+ * initialization.
+ *
+ * @return The registry.
+ */
+Registry& GetRegistry() {
+    static Registry registry;
+    return registry;
+}
+
+thread_local std::shared_ptr<ThreadEvents> thread_events;
+
+/**
+ * Get the calling thread's events, registering them with the collector on first use.
+ *
+ * @param name - Name of the thread, or null to name it after its ID.
+ * @return The calling thread's events.
+ */
+ThreadEvents& GetThreadEvents(const char* name = nullptr) {
+    if (!thread_events) [[unlikely]] {
+        auto& registry{GetRegistry()};
+        std::scoped_lock lock{registry.mutex};
+        thread_events = std::make_shared<ThreadEvents>();
+        thread_events->id = registry.next_thread_id++;
+        thread_events->name = name ? name : fmt::format("Thread {}", thread_events->id);
+        registry.threads.push_back(thread_events);
+        registry.thread_names.emplace_back(thread_events->id, thread_events->name);
+    }
+    return *thread_events;
+}
+
+/**
+ * Move all pending events from the thread rings into the bounded collector.
+ * Must be called with the registry mutex held.
+ *
+ * @param registry - The registry to collect into.
+ */
+void CollectEvents(Registry& registry) {
+    auto& threads{registry.threads};
+    auto& collected{registry.collected};
+    for (auto it{threads.begin()}; it != threads.end();) {
+        (*it)->events.Drain((*it)->id, collected);
+
+        // Threads which have exited hold no reference, once drained they can be forgotten.
+        if (it->use_count() == 1 && (*it)->events.Empty()) {
+            it = threads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Threads are drained one after another. Order by time, so trimming drops the oldest events
+    // of all threads.
+    std::sort(collected.begin(), collected.end(),
+              [](const Event& a, const Event& b) { return a.begin_ns < b.begin_ns; });
+    if (collected.size() > MaxCollectedEvents) {
+        const auto excess{static_cast<std::ptrdiff_t>(collected.size() - MaxCollectedEvents)};
+        collected.erase(collected.begin(), collected.begin() + excess);
+    }
+}
+
+/**
+ * Escape a string for use within a JSON string literal.
+ *
+ * @param string - The string to escape.
+ * @return The escaped string.
+ */
+std::string EscapeJson(std::string_view string) {
+    std::string escaped;
+    escaped.reserve(string.size());
+    for (const char character : string) {
+        switch (character) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20) {
+                escaped += fmt::format("\\u{:04X}", static_cast<unsigned char>(character));
+            } else {
+                escaped += character;
+            }
+            break;
+        }
+    }
+    return escaped;
+}
+
+} // namespace
+
+u32 RegisterScope(const char* group, const char* name, u32 color) {
+    auto& registry{GetRegistry()};
+    std::scoped_lock lock{registry.mutex};
+    registry.scopes.push_back({group, name, color});
+    return static_cast<u32>(registry.scopes.size() - 1);
+}
+
+void OnThreadCreate(const char* name) {
+    GetThreadEvents(name);
+}
+
+void RecordScope(u32 scope, u64 begin_ns, u64 end_ns) {
+    GetThreadEvents().events.Push(scope, begin_ns, end_ns);
+}
+
+std::string ExportChromeTrace() {
+    auto& registry{GetRegistry()};
+    std::scoped_lock lock{registry.mutex};
+    CollectEvents(registry);
+
+    std::string json{"{\"traceEvents\":["};
+    bool first{true};
+    const auto separator = [&first]() {
+        if (first) {
+            first = false;
+            return "";
+        }
+        return ",";
+    };
+
+    for (const auto& [id, name] : registry.thread_names) {
+        json += fmt::format("{}{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},"
+                            "\"args\":{{\"name\":\"{}\"}}}}",
+                            separator(), id, EscapeJson(name));
+    }
+
+    for (const auto& event : registry.collected) {
+        const auto& scope{registry.scopes[event.scope]};
+        const auto begin_us{static_cast<f64>(event.begin_ns) / 1000.0};
+        const auto duration_us{static_cast<f64>(event.end_ns - event.begin_ns) / 1000.0};
+        json += fmt::format("{}{{\"ph\":\"X\",\"cat\":\"{}\",\"name\":\"{}\",\"pid\":1,\"tid\":{},"
+                            "\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"color\":\"#{:06X}\"}}}}",
+                            separator(), EscapeJson(scope.group), EscapeJson(scope.name),
+                            event.thread, begin_us, duration_us, scope.color);
+    }
+
+    json += "]}";
+    return json;
+}
+
+} // namespace Common::Profiling
@@ -3,6 +3,96 @@
 
 #pragma once
 
-#define MICROPROFILE_DEFINE(...)
-#define MICROPROFILE_SCOPE(...)
-#define MicroProfileOnThreadCreate(foo) do {} while(0)
+#include <chrono>
+#include <string>
+
+#include "common_types.h"
+#include "settings.h"
+
+/// A lightweight scope profiler behind the MICROPROFILE_* macros.
+/// Each thread records (scope, begin, end) events into its own lock-free ring, which keeps the
+/// most recent events by overwriting the oldest. Rings are only drained when a trace is exported,
+/// and scopes cost a single branch while tracing is disabled.
+namespace Common::Profiling {
+
+/**
+ * Register a named scope which can be timed.
+ *
+ * @param group - The group the scope belongs to, used as the trace event category.
+ * @param name  - The name of the scope.
+ * @param color - The 0xRRGGBB colour of the scope.
+ * @return The ID of the scope.
+ */
+u32 RegisterScope(const char* group, const char* name, u32 color);
+
+/**
+ * Name the calling thread in exported traces.
+ *
+ * @param name - Name of the thread.
+ */
+void OnThreadCreate(const char* name);
+
+/**
+ * Record a completed scope on the calling thread.
+ *
+ * @param scope    - ID of the scope, see RegisterScope.
+ * @param begin_ns - Time the scope began, see GetTimeNs.
+ * @param end_ns   - Time the scope ended, see GetTimeNs.
+ */
+void RecordScope(u32 scope, u64 begin_ns, u64 end_ns);
+
+/**
+ * Drain all recorded scopes into the collector and export the collected events.
+ *
+ * @return The events in the Chrome trace event JSON format, viewable in chrome://tracing or
+ *         Perfetto.
+ */
+std::string ExportChromeTrace();
+
+/**
+ * Get the current time on the clock used for scopes.
+ *
+ * @return The time in nanoseconds.
+ */
+inline u64 GetTimeNs() {
+    const auto now{std::chrono::steady_clock::now().time_since_epoch()};
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+/**
+ * Times the enclosing scope while AudioCore::Settings::values.audio_tracing is enabled.
+ */
+class ScopeTimer {
+public:
+    explicit ScopeTimer(u32 scope_) : scope{scope_} {
+        if (AudioCore::Settings::values.audio_tracing) [[unlikely]] {
+            begin_ns = GetTimeNs();
+        }
+    }
+
+    ~ScopeTimer() {
+        if (begin_ns != 0) [[unlikely]] {
+            RecordScope(scope, begin_ns, GetTimeNs());
+        }
+    }
+
+    ScopeTimer(const ScopeTimer&) = delete;
+    ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+private:
+    /// ID of the timed scope
+    u32 scope;
+    /// Time the scope began, 0 if tracing was disabled
+    u64 begin_ns{};
+};
+
+} // namespace Common::Profiling
+
+#define MP_RGB(r, g, b)                                                                            \
+    ((static_cast<u32>(r) << 16) | (static_cast<u32>(g) << 8) | static_cast<u32>(b))
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    static const u32 microprofile_scope_##var{                                                     \
+        Common::Profiling::RegisterScope(group, name, color)}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    Common::Profiling::ScopeTimer microprofile_timer_##var{microprofile_scope_##var}
+#define MicroProfileOnThreadCreate(name) Common::Profiling::OnThreadCreate(name)
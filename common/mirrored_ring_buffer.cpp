@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "log.h"
+#include "mirrored_ring_buffer.h"
+
+namespace Common {
+
+MirroredMemory::MirroredMemory(std::size_t size, bool mirrored) {
+    std::size_t page_size{4096};
+#ifdef __linux__
+    page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    m_size = (std::max<std::size_t>(size, 1) + page_size - 1) / page_size * page_size;
+
+    if (mirrored) {
+        if (MapMirrored()) {
+            m_mirrored = true;
+            return;
+        }
+        LOG_WARNING(Service_Audio,
+                    "Could not map mirrored memory of size {:#x}, copying at the wrap", m_size);
+    }
+
+    m_fallback = std::make_unique<std::byte[]>(m_size * 2);
+    m_base = m_fallback.get();
+}
+
+MirroredMemory::~MirroredMemory() {
+#ifdef __linux__
+    if (m_mirrored) {
+        munmap(m_base, m_size * 2);
+    }
+#endif
+}
+
+bool MirroredMemory::MapMirrored() {
+#ifdef __linux__
+    // Called through syscall so it's also available on older Android and glibc versions.
+    constexpr unsigned int MfdCloexec{1U};
+    const int fd{static_cast<int>(syscall(SYS_memfd_create, "audio_core_ring", MfdCloexec))};
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+        close(fd);
+        return false;
+    }
+
+    // Reserve the address space for both halves first, so they are guaranteed to be adjacent.
+    void* base{mmap(nullptr, m_size * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    auto* const first{static_cast<std::byte*>(base)};
+    const bool mapped{
+        mmap(first, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+        mmap(first + m_size, m_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) !=
+            MAP_FAILED};
+    close(fd);
+
+    if (!mapped) {
+        munmap(base, m_size * 2);
+        return false;
+    }
+    m_base = base;
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace Common {
+
+/// Memory mapped twice back to back, so accesses running off the end of the first mapping land
+/// at its start again. Where the platform can't do this, it falls back to a plain allocation of
+/// twice the size whose second half must be kept in sync by the user.
+class MirroredMemory {
+public:
+    /// @param size      Minimum size in bytes, rounded up to a multiple of the page size
+    /// @param mirrored  False to always use the fallback, as on platforms which can't mirror
+    explicit MirroredMemory(std::size_t size, bool mirrored = true);
+    ~MirroredMemory();
+
+    MirroredMemory(const MirroredMemory&) = delete;
+    MirroredMemory& operator=(const MirroredMemory&) = delete;
+
+    /// @returns Pointer to the first mapping, followed by its mirror, 2 * Size() bytes in total
+    [[nodiscard]] void* Data() const {
+        return m_base;
+    }
+
+    /// @returns Size of one mapping in bytes
+    [[nodiscard]] std::size_t Size() const {
+        return m_size;
+    }
+
+    /// @returns True if the second half mirrors the first, false if it's a separate allocation
+    [[nodiscard]] bool IsMirrored() const {
+        return m_mirrored;
+    }
+
+private:
+    /// Tries to map the memory twice, leaves it unmapped on failure
+    /// @returns True on success
+    bool MapMirrored();
+
+    void* m_base{};
+    std::size_t m_size{};
+    bool m_mirrored{};
+    std::unique_ptr<std::byte[]> m_fallback;
+};
+
+/// SPSC ring buffer with a capacity chosen at runtime, whose free and filled regions are always
+/// exposed as single contiguous spans, even across the end of the ring. This lets callers process
+/// samples in place in ring memory.
+/// @tparam T  Element type, its size must be a power of two
+template <typename T>
+class MirroredRingBuffer {
+    /// A "slot" is made of a single `T`.
+    static constexpr std::size_t slot_size = sizeof(T);
+    // T must be safely memcpy-able and have a trivial default constructor.
+    static_assert(std::is_trivial_v<T>);
+    // Keeps the capacity a power of two filling whole pages.
+    static_assert(std::has_single_bit(slot_size));
+    // Ensure lock-free.
+    static_assert(std::atomic_size_t::is_always_lock_free);
+
+public:
+    /// @param min_capacity  Minimum number of slots, rounded up to a power of two filling whole
+    ///                      pages
+    /// @param mirrored      False to always copy at the wrap, as on platforms which can't mirror
+    explicit MirroredRingBuffer(std::size_t min_capacity, bool mirrored = true)
+        : m_memory{std::bit_ceil(min_capacity * slot_size), mirrored},
+          m_capacity{m_memory.Size() / slot_size}, m_data{static_cast<T*>(m_memory.Data())} {}
+
+    /// Reserves free slots to be written in place, without making them visible to the reader
+    /// @param slot_count  Number of slots to reserve
+    /// @returns Contiguous writable slots, fewer than requested if the ring is too full
+    std::span<T> ReserveWrite(std::size_t slot_count) {
+        const std::size_t write_index = m_write_index.load();
+        const std::size_t slots_free = m_capacity + m_read_index.load() - write_index;
+        return {m_data + (write_index & (m_capacity - 1)), std::min(slot_count, slots_free)};
+    }
+
+    /// Makes slots written after ReserveWrite visible to the reader
+    /// @param slot_count  Number of slots written, at most the number reserved
+    void CommitWrite(std::size_t slot_count) {
+        const std::size_t write_index = m_write_index.load();
+        if (!m_memory.IsMirrored()) {
+            // Move anything written past the end back to the start of the ring.
+            const std::size_t end = (write_index & (m_capacity - 1)) + slot_count;
+            if (end > m_capacity) {
+                std::memcpy(m_data, m_data + m_capacity, (end - m_capacity) * slot_size);
+            }
+        }
+        m_write_index.store(write_index + slot_count);
+    }
+
+    /// Gets filled slots to be read in place, without freeing them for the writer
+    /// @param max_slots  Maximum number of slots to get
+    /// @returns Contiguous readable slots
+    std::span<const T> PeekRead(std::size_t max_slots = ~std::size_t(0)) {
+        const std::size_t read_index = m_read_index.load();
+        const std::size_t slots_filled = m_write_index.load() - read_index;
+        const std::size_t count = std::min(slots_filled, max_slots);
+        const std::size_t pos = read_index & (m_capacity - 1);
+        if (!m_memory.IsMirrored() && pos + count > m_capacity) {
+            // Copy the slots at the start of the ring past its end, to read them contiguously.
+            std::memcpy(m_data + m_capacity, m_data, (pos + count - m_capacity) * slot_size);
+        }
+        return {m_data + pos, count};
+    }
+
+    /// Frees slots read after PeekRead for the writer
+    /// @param slot_count  Number of slots read, at most the number peeked
+    void CommitRead(std::size_t slot_count) {
+        m_read_index.store(m_read_index.load() + slot_count);
+    }
+
+    /// Pushes slots into the ring buffer
+    /// @param new_slots   Pointer to the slots to push
+    /// @param slot_count  Number of slots to push
+    /// @returns The number of slots actually pushed
+    std::size_t Push(const void* new_slots, std::size_t slot_count) {
+        const auto span = ReserveWrite(slot_count);
+        std::memcpy(span.data(), new_slots, span.size() * slot_size);
+        CommitWrite(span.size());
+        return span.size();
+    }
+
+    std::size_t Push(const std::vector<T>& input) {
+        return Push(input.data(), input.size());
+    }
+
+    /// Pops slots from the ring buffer
+    /// @param output     Where to store the popped slots
+    /// @param max_slots  Maximum number of slots to pop
+    /// @returns The number of slots actually popped
+    std::size_t Pop(void* output, std::size_t max_slots = ~std::size_t(0)) {
+        const auto span = PeekRead(max_slots);
+        std::memcpy(output, span.data(), span.size() * slot_size);
+        CommitRead(span.size());
+        return span.size();
+    }
+
+    std::vector<T> Pop(std::size_t max_slots = ~std::size_t(0)) {
+        std::vector<T> out(std::min(max_slots, m_capacity));
+        const std::size_t count = Pop(out.data(), out.size());
+        out.resize(count);
+        return out;
+    }
+
+    /// @returns Number of slots used
+    [[nodiscard]] std::size_t Size() const {
+        return m_write_index.load() - m_read_index.load();
+    }
+
+    /// @returns Maximum size of ring buffer
+    [[nodiscard]] std::size_t Capacity() const {
+        return m_capacity;
+    }
+
+    /// @returns True if the ring's memory is mirrored, false if it copies at the wrap
+    [[nodiscard]] bool IsMirrored() const {
+        return m_memory.IsMirrored();
+    }
+
+private:
+    MirroredMemory m_memory;
+    const std::size_t m_capacity;
+    T* const m_data;
+
+    // It is important to align the below variables for performance reasons:
+    // Having them on the same cache-line would result in false-sharing between them.
+    alignas(128) std::atomic_size_t m_read_index{0};
+    alignas(128) std::atomic_size_t m_write_index{0};
+};
+
+} // namespace Common
@@ -23,6 +23,23 @@ struct Values {
     Wrapper<std::string> audio_output_device_id{"auto"};
     Wrapper<std::string> audio_input_device_id{"auto"};
     bool dump_audio_commands{};
+    bool adaptive_processing_time_estimation{}; //!< Learn command costs from host timings
+    bool audio_command_timing_statistics{}; //!< Record per-command timing histograms
+    bool audio_tracing{}; //!< Record MICROPROFILE scopes for exporting as a trace
+    bool adaptive_render_queue{}; //!< Adapt the render queue depth to callback jitter
+    u32 render_queue_min_buffers{2}; //!< The fewest render buffers queued in adaptive mode
+    u32 render_queue_max_buffers{8}; //!< The most render buffers queued in adaptive mode
+    u32 render_queue_shrink_seconds{5}; //!< Stable seconds before the adaptive queue shrinks
+    bool audio_drift_compensation{}; //!< Resample output by up to 0.5% to keep sink rings centered
+    bool audio_file_sink_paced{true}; //!< Pace the file sink like a device, not as fast as produced
+    u32 audio_null_sink_speed{1}; //!< Null sink clock speed in multiples of real time, 0 unclocked
+    bool audio_realtime_threads{true}; //!< Use real-time scheduling for audio threads if permitted
+    u64 audio_renderer_cpu_mask{}; //!< CPUs the render thread may run on, 0 for any
+    u64 audio_thread_cpu_mask{}; //!< CPUs the other audio threads may run on, 0 for any
+    bool audio_lock_memory{}; //!< Lock renderer workbuffers and pre-fault audio thread stacks
+    bool audio_pipelined_command_generation{}; //!< Generate lists while rendering, +5ms latency
+    bool audio_out_in_place_buffers{}; //!< Play AudioOut buffers from game memory, not copies
+    bool audio_event_driven_buffer_release{}; //!< Release AudioOut/In buffers as they're consumed
     u8 volume{200};
 };
 
@@ -0,0 +1,398 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AUDIO_CORE_SIMD_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_CORE_SIMD_SSE2
+#endif
+
+#include "common_types.h"
+
+/// Minimal 4 lane f32 vector operations for converting PCM, on NEON, SSE2 or plain scalar code.
+/// Conversions back to s16 truncate like a static_cast and then saturate.
+/// Also 2 lane s64 operations for Q14 fixed point, which match the scalar results exactly, and
+/// 2 lane f64 operations, which round each operation like scalar code does.
+namespace Common::Simd {
+
+/// Number of lanes in a vector
+constexpr std::size_t VectorWidth = 4;
+
+#if defined(AUDIO_CORE_SIMD_NEON)
+using F32x4 = float32x4_t;
+
+inline F32x4 LoadF32x4(const f32* values) {
+    return vld1q_f32(values);
+}
+
+inline F32x4 LoadS16x4(const s16* samples) {
+    return vcvtq_f32_s32(vmovl_s16(vld1_s16(samples)));
+}
+
+inline F32x4 LoadS32x4(const s32* samples) {
+    return vcvtq_f32_s32(vld1q_s32(samples));
+}
+
+inline F32x4 SplatF32x4(f32 value) {
+    return vdupq_n_f32(value);
+}
+
+inline F32x4 MulF32x4(F32x4 a, f32 b) {
+    return vmulq_n_f32(a, b);
+}
+
+inline F32x4 MulAddF32x4(F32x4 acc, F32x4 a, f32 b) {
+    return vmlaq_n_f32(acc, a, b);
+}
+
+inline F32x4 ClampF32x4(F32x4 a, f32 min, f32 max) {
+    return vminq_f32(vmaxq_f32(a, vdupq_n_f32(min)), vdupq_n_f32(max));
+}
+
+inline void StoreSaturatedS16x4(s16* samples, F32x4 values) {
+    vst1_s16(samples, vqmovn_s32(vcvtq_s32_f32(values)));
+}
+
+/// Stores two vectors as 4 interleaved pairs
+inline void StoreInterleavedSaturatedS16x4x2(s16* samples, F32x4 first, F32x4 second) {
+    vst2_s16(samples, int16x4x2_t{vqmovn_s32(vcvtq_s32_f32(first)),
+                                  vqmovn_s32(vcvtq_s32_f32(second))});
+}
+
+using S64x2 = int64x2_t;
+
+inline S64x2 LoadS64x2(const s64* values) {
+    return vld1q_s64(values);
+}
+
+inline void StoreS64x2(s64* values, S64x2 a) {
+    vst1q_s64(values, a);
+}
+
+inline S64x2 SplatS64x2(s64 value) {
+    return vdupq_n_s64(value);
+}
+
+inline S64x2 AddS64x2(S64x2 a, S64x2 b) {
+    return vaddq_s64(a, b);
+}
+
+/// Multiplies Q14 values by Q14 gains which fit in s32, flooring like a 128-bit product would.
+/// Splits each value into its integer and fraction parts, as value * gain >> 14 is then
+/// integer * gain + (fraction * gain >> 14).
+inline S64x2 MulQ14S64x2(S64x2 values, S64x2 gains) {
+    const uint64x2_t integer = vreinterpretq_u64_s64(vshrq_n_s64(values, 14));
+    const int32x2_t fraction = vmovn_s64(vandq_s64(values, vdupq_n_s64(0x3FFF)));
+    const int32x2_t gain = vmovn_s64(gains);
+    const uint32x2_t gain_bits = vreinterpret_u32_s32(gain);
+
+    // integer * gain modulo 2^64, from its low and high halves. The unsigned multiply of the low
+    // half reads a negative gain as gain + 2^32, so take low * 2^32 back off for those.
+    const uint32x2_t low = vmovn_u64(integer);
+    const uint32x2_t high = vshrn_n_u64(integer, 32);
+    const uint64x2_t negative = vreinterpretq_u64_s64(vshrq_n_s64(gains, 63));
+    uint64x2_t product = vmull_u32(low, gain_bits);
+    product = vsubq_u64(product, vandq_u64(negative, vshlq_n_u64(vmovl_u32(low), 32)));
+    product = vaddq_u64(product, vshlq_n_u64(vmull_u32(high, gain_bits), 32));
+
+    return vaddq_s64(vreinterpretq_s64_u64(product), vshrq_n_s64(vmull_s32(fraction, gain), 14));
+}
+#elif defined(AUDIO_CORE_SIMD_SSE2)
+using F32x4 = __m128;
+
+inline F32x4 LoadF32x4(const f32* values) {
+    return _mm_loadu_ps(values);
+}
+
+inline F32x4 LoadS16x4(const s16* samples) {
+    const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(samples));
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+}
+
+inline F32x4 LoadS32x4(const s32* samples) {
+    return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples)));
+}
+
+inline F32x4 SplatF32x4(f32 value) {
+    return _mm_set1_ps(value);
+}
+
+inline F32x4 MulF32x4(F32x4 a, f32 b) {
+    return _mm_mul_ps(a, _mm_set1_ps(b));
+}
+
+inline F32x4 MulAddF32x4(F32x4 acc, F32x4 a, f32 b) {
+    return _mm_add_ps(acc, _mm_mul_ps(a, _mm_set1_ps(b)));
+}
+
+inline F32x4 ClampF32x4(F32x4 a, f32 min, f32 max) {
+    return _mm_min_ps(_mm_max_ps(a, _mm_set1_ps(min)), _mm_set1_ps(max));
+}
+
+inline void StoreSaturatedS16x4(s16* samples, F32x4 values) {
+    const __m128i converted = _mm_cvttps_epi32(values);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(samples), _mm_packs_epi32(converted, converted));
+}
+
+/// Stores two vectors as 4 interleaved pairs
+inline void StoreInterleavedSaturatedS16x4x2(s16* samples, F32x4 first, F32x4 second) {
+    const __m128i first_converted = _mm_cvttps_epi32(first);
+    const __m128i second_converted = _mm_cvttps_epi32(second);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(samples),
+                     _mm_unpacklo_epi16(_mm_packs_epi32(first_converted, first_converted),
+                                        _mm_packs_epi32(second_converted, second_converted)));
+}
+
+using S64x2 = __m128i;
+
+inline S64x2 LoadS64x2(const s64* values) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+}
+
+inline void StoreS64x2(s64* values, S64x2 a) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values), a);
+}
+
+inline S64x2 SplatS64x2(s64 value) {
+    return _mm_set1_epi64x(value);
+}
+
+inline S64x2 AddS64x2(S64x2 a, S64x2 b) {
+    return _mm_add_epi64(a, b);
+}
+
+/// All ones in the lanes which are negative, zero in the others
+inline __m128i SignMaskS64x2(S64x2 a) {
+    return _mm_shuffle_epi32(_mm_srai_epi32(a, 31), _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+/// Arithmetic shift right by 14, which SSE2 only has for 32-bit lanes
+inline S64x2 ShiftRightQ14S64x2(S64x2 a) {
+    return _mm_or_si128(_mm_srli_epi64(a, 14), _mm_slli_epi64(SignMaskS64x2(a), 64 - 14));
+}
+
+/// Multiplies the low 32 bits of each lane by a gain which fits in s32, modulo 2^64. The
+/// unsigned multiply reads a negative gain as gain + 2^32, so take a * 2^32 back off for those.
+inline S64x2 MulLowS64x2(S64x2 a, S64x2 gains) {
+    return _mm_sub_epi64(_mm_mul_epu32(a, gains),
+                         _mm_and_si128(SignMaskS64x2(gains), _mm_slli_epi64(a, 32)));
+}
+
+/// Multiplies Q14 values by Q14 gains which fit in s32, flooring like a 128-bit product would.
+/// Splits each value into its integer and fraction parts, as value * gain >> 14 is then
+/// integer * gain + (fraction * gain >> 14).
+inline S64x2 MulQ14S64x2(S64x2 values, S64x2 gains) {
+    const __m128i integer = ShiftRightQ14S64x2(values);
+    const __m128i fraction = _mm_and_si128(values, _mm_set1_epi64x(0x3FFF));
+
+    // integer * gain modulo 2^64, from its low and high halves.
+    const __m128i high = _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(integer, 32), gains), 32);
+    const __m128i product = _mm_add_epi64(MulLowS64x2(integer, gains), high);
+
+    return _mm_add_epi64(product, ShiftRightQ14S64x2(MulLowS64x2(fraction, gains)));
+}
+#else
+struct F32x4 {
+    std::array<f32, VectorWidth> values;
+};
+
+inline F32x4 LoadF32x4(const f32* values) {
+    F32x4 out;
+    std::copy_n(values, VectorWidth, out.values.begin());
+    return out;
+}
+
+inline F32x4 LoadS16x4(const s16* samples) {
+    F32x4 out;
+    for (std::size_t i = 0; i < VectorWidth; i++) {
+        out.values[i] = static_cast<f32>(samples[i]);
+    }
+    return out;
+}
+
+inline F32x4 LoadS32x4(const s32* samples) {
+    F32x4 out;
+    for (std::size_t i = 0; i < VectorWidth; i++) {
+        out.values[i] = static_cast<f32>(samples[i]);
+    }
+    return out;
+}
+
+inline F32x4 SplatF32x4(f32 value) {
+    F32x4 out;
+    out.values.fill(value);
+    return out;
+}
+
+inline F32x4 MulF32x4(F32x4 a, f32 b) {
+    for (auto& value : a.values) {
+        value *= b;
+    }
+    return a;
+}
+
+inline F32x4 MulAddF32x4(F32x4 acc, F32x4 a, f32 b) {
+    for (std::size_t i = 0; i < VectorWidth; i++) {
+        acc.values[i] += a.values[i] * b;
+    }
+    return acc;
+}
+
+inline F32x4 ClampF32x4(F32x4 a, f32 min, f32 max) {
+    for (auto& value : a.values) {
+        value = std::clamp(value, min, max);
+    }
+    return a;
+}
+
+inline void StoreSaturatedS16x4(s16* samples, F32x4 values) {
+    constexpr f32 min = std::numeric_limits<s16>::min();
+    constexpr f32 max = std::numeric_limits<s16>::max();
+    for (std::size_t i = 0; i < VectorWidth; i++) {
+        samples[i] = static_cast<s16>(std::clamp(values.values[i], min, max));
+    }
+}
+
+/// Stores two vectors as 4 interleaved pairs
+inline void StoreInterleavedSaturatedS16x4x2(s16* samples, F32x4 first, F32x4 second) {
+    std::array<s16, VectorWidth> first_samples;
+    std::array<s16, VectorWidth> second_samples;
+    StoreSaturatedS16x4(first_samples.data(), first);
+    StoreSaturatedS16x4(second_samples.data(), second);
+    for (std::size_t i = 0; i < VectorWidth; i++) {
+        samples[i * 2] = first_samples[i];
+        samples[i * 2 + 1] = second_samples[i];
+    }
+}
+
+struct S64x2 {
+    std::array<s64, 2> values;
+};
+
+inline S64x2 LoadS64x2(const s64* values) {
+    return {{values[0], values[1]}};
+}
+
+inline void StoreS64x2(s64* values, S64x2 a) {
+    values[0] = a.values[0];
+    values[1] = a.values[1];
+}
+
+inline S64x2 SplatS64x2(s64 value) {
+    return {{value, value}};
+}
+
+inline S64x2 AddS64x2(S64x2 a, S64x2 b) {
+    return {{a.values[0] + b.values[0], a.values[1] + b.values[1]}};
+}
+
+/// Multiplies Q14 values by Q14 gains which fit in s32, flooring like a 128-bit product would.
+/// Splits each value into its integer and fraction parts, as value * gain >> 14 is then
+/// integer * gain + (fraction * gain >> 14).
+inline S64x2 MulQ14S64x2(S64x2 values, S64x2 gains) {
+    S64x2 out;
+    for (std::size_t i = 0; i < 2; i++) {
+        const s64 integer = values.values[i] >> 14;
+        const s64 fraction = values.values[i] & 0x3FFF;
+        const s64 gain = gains.values[i];
+        out.values[i] = static_cast<s64>(static_cast<u64>(integer) * static_cast<u64>(gain)) +
+                        ((fraction * gain) >> 14);
+    }
+    return out;
+}
+#endif
+
+// 32-bit ARM has no f64 vectors, so only AArch64 uses NEON for these.
+#if defined(AUDIO_CORE_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+using F64x2 = float64x2_t;
+
+inline F64x2 LoadF64x2(const f64* values) {
+    return vld1q_f64(values);
+}
+
+inline void StoreF64x2(f64* values, F64x2 a) {
+    vst1q_f64(values, a);
+}
+
+inline F64x2 SplatF64x2(f64 value) {
+    return vdupq_n_f64(value);
+}
+
+inline F64x2 AddF64x2(F64x2 a, F64x2 b) {
+    return vaddq_f64(a, b);
+}
+
+inline F64x2 MulF64x2(F64x2 a, F64x2 b) {
+    return vmulq_f64(a, b);
+}
+
+inline F64x2 ClampF64x2(F64x2 a, f64 min, f64 max) {
+    return vminq_f64(vmaxq_f64(a, vdupq_n_f64(min)), vdupq_n_f64(max));
+}
+#elif defined(AUDIO_CORE_SIMD_SSE2)
+using F64x2 = __m128d;
+
+inline F64x2 LoadF64x2(const f64* values) {
+    return _mm_loadu_pd(values);
+}
+
+inline void StoreF64x2(f64* values, F64x2 a) {
+    _mm_storeu_pd(values, a);
+}
+
+inline F64x2 SplatF64x2(f64 value) {
+    return _mm_set1_pd(value);
+}
+
+inline F64x2 AddF64x2(F64x2 a, F64x2 b) {
+    return _mm_add_pd(a, b);
+}
+
+inline F64x2 MulF64x2(F64x2 a, F64x2 b) {
+    return _mm_mul_pd(a, b);
+}
+
+inline F64x2 ClampF64x2(F64x2 a, f64 min, f64 max) {
+    return _mm_min_pd(_mm_max_pd(a, _mm_set1_pd(min)), _mm_set1_pd(max));
+}
+#else
+struct F64x2 {
+    std::array<f64, 2> values;
+};
+
+inline F64x2 LoadF64x2(const f64* values) {
+    return {{values[0], values[1]}};
+}
+
+inline void StoreF64x2(f64* values, F64x2 a) {
+    values[0] = a.values[0];
+    values[1] = a.values[1];
+}
+
+inline F64x2 SplatF64x2(f64 value) {
+    return {{value, value}};
+}
+
+inline F64x2 AddF64x2(F64x2 a, F64x2 b) {
+    return {{a.values[0] + b.values[0], a.values[1] + b.values[1]}};
+}
+
+inline F64x2 MulF64x2(F64x2 a, F64x2 b) {
+    return {{a.values[0] * b.values[0], a.values[1] * b.values[1]}};
+}
+
+inline F64x2 ClampF64x2(F64x2 a, f64 min, f64 max) {
+    return {{std::clamp(a.values[0], min, max), std::clamp(a.values[1], min, max)}};
+}
+#endif
+
+} // namespace Common::Simd
@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#ifdef __linux__
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "log.h"
+#include "settings.h"
+#include "thread.h"
+
+namespace Common {
+
+#ifdef __linux__
+namespace {
+struct LinuxPriority {
+    int policy;      //!< Real-time policy to try, SCHED_OTHER to only set the nice value
+    int rt_priority; //!< Real-time priority, as an offset from the policy's minimum
+    int nice;        //!< Nice value used when real-time scheduling isn't
+};
+
+constexpr LinuxPriority GetLinuxPriority(ThreadPriority priority) {
+    switch (priority) {
+    case ThreadPriority::Low:
+        return {SCHED_OTHER, 0, 10};
+    case ThreadPriority::Normal:
+        return {SCHED_OTHER, 0, 0};
+    case ThreadPriority::High:
+        return {SCHED_RR, 1, -10};
+    case ThreadPriority::VeryHigh:
+        return {SCHED_RR, 10, -15};
+    case ThreadPriority::Critical:
+        return {SCHED_FIFO, 20, -20};
+    }
+    return {SCHED_OTHER, 0, 0};
+}
+} // namespace
+
+void SetCurrentThreadPriority(ThreadPriority new_priority) {
+    const auto priority{GetLinuxPriority(new_priority)};
+
+    if (priority.policy != SCHED_OTHER && AudioCore::Settings::values.audio_realtime_threads) {
+        sched_param param{};
+        param.sched_priority = std::min(sched_get_priority_min(priority.policy) +
+                                            priority.rt_priority,
+                                        sched_get_priority_max(priority.policy));
+        const int result{pthread_setschedparam(pthread_self(), priority.policy, &param)};
+        if (result == 0) {
+            return;
+        }
+        // Needs CAP_SYS_NICE or an RLIMIT_RTPRIO allowance, which most desktops don't grant.
+        LOG_DEBUG(Service_Audio, "Real-time scheduling unavailable, using a nice value: {}",
+                  std::strerror(result));
+    }
+
+    // Leave real-time scheduling if the thread was using it, then set the nice value of only this
+    // thread, which Linux allows through its thread id.
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), priority.nice) != 0) {
+        LOG_DEBUG(Service_Audio, "Could not set the thread's nice value to {}: {}", priority.nice,
+                  std::strerror(errno));
+    }
+}
+
+void SetCurrentThreadName(const char* name) {
+    // Linux thread names are limited to 15 characters.
+    const std::string truncated{name, std::min<std::size_t>(std::strlen(name), 15)};
+    pthread_setname_np(pthread_self(), truncated.c_str());
+}
+
+void SetCurrentThreadAffinity(u64 cpu_mask) {
+    if (cpu_mask == 0) {
+        return;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (std::size_t cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+        if ((cpu_mask >> cpu) & 1) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+
+    const int result{pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set)};
+    if (result != 0) {
+        LOG_WARNING(Service_Audio, "Could not set the thread's CPU affinity to {:#x}: {}",
+                    cpu_mask, std::strerror(result));
+    }
+}
+
+// Never inlined, so the stack touched here is released again when it returns.
+[[gnu::noinline]] void PrefaultCurrentThreadStack(std::size_t size) {
+    if (!AudioCore::Settings::values.audio_lock_memory) {
+        return;
+    }
+
+    // Never touch more than the stack left below this frame, less a margin for the calls made
+    // while touching it, as an oversized alloca would run past the guard page.
+    constexpr std::size_t StackMargin{0x4000};
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) != 0) {
+        return;
+    }
+    void* stack_base{};
+    std::size_t stack_size{};
+    const int result{pthread_attr_getstack(&attr, &stack_base, &stack_size)};
+    pthread_attr_destroy(&attr);
+    if (result != 0) {
+        return;
+    }
+
+    const auto* const frame{static_cast<const u8*>(__builtin_frame_address(0))};
+    const auto left{static_cast<std::size_t>(frame - static_cast<const u8*>(stack_base))};
+    if (left <= StackMargin) {
+        return;
+    }
+    size = std::min(size, left - StackMargin);
+
+    const auto page_size{static_cast<std::size_t>(sysconf(_SC_PAGESIZE))};
+    auto* const stack{static_cast<volatile u8*>(alloca(size))};
+    for (std::size_t offset = 0; offset < size; offset += page_size) {
+        stack[offset] = 0;
+    }
+}
+
+bool LockMemory(void* address, std::size_t size) {
+    if (mlock(address, size) == 0) {
+        return true;
+    }
+    LOG_WARNING(Service_Audio, "Could not lock {:#x} bytes of memory, check the memlock limit: {}",
+                size, std::strerror(errno));
+    return false;
+}
+
+void UnlockMemory(void* address, std::size_t size) {
+    munlock(address, size);
+}
+#else
+void SetCurrentThreadPriority(ThreadPriority new_priority) {}
+
+void SetCurrentThreadName(const char* name) {}
+
+void SetCurrentThreadAffinity(u64 cpu_mask) {}
+
+void PrefaultCurrentThreadStack(std::size_t size) {}
+
+bool LockMemory(void* address, std::size_t size) {
+    return false;
+}
+
+void UnlockMemory(void* address, std::size_t size) {}
+#endif
+
+} // namespace Common
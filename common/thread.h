@@ -3,9 +3,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <mutex>
 
+#include "common_types.h"
+
 namespace Common {
 
 class Event {
@@ -40,8 +44,45 @@ enum class ThreadPriority : u32 {
     Critical = 4,
 };
 
-inline void SetCurrentThreadPriority(ThreadPriority new_priority) {}
+/**
+ * @brief Sets the scheduling priority of the calling thread
+ * @note On Linux, High and above use real-time scheduling when it's permitted and enabled in the
+ *       settings, otherwise priorities map to nice values
+ */
+void SetCurrentThreadPriority(ThreadPriority new_priority);
+
+/**
+ * @brief Sets the name of the calling thread, truncated to the platform's limit
+ */
+void SetCurrentThreadName(const char* name);
+
+/**
+ * @brief Restricts the calling thread to a set of CPUs
+ * @param cpu_mask A mask with a bit set for each allowed CPU, 0 leaves the affinity unchanged
+ */
+void SetCurrentThreadAffinity(u64 cpu_mask);
+
+/**
+ * @brief The amount of stack audio threads pre-fault, comfortably above their deepest use
+ */
+constexpr std::size_t PrefaultStackSize{0x40000};
+
+/**
+ * @brief Touches the calling thread's stack ahead of time, so it doesn't page fault on it later
+ * @param size The number of bytes of stack to touch, clamped to the stack the thread has left
+ * @note This does nothing unless Settings::values.audio_lock_memory is set
+ */
+void PrefaultCurrentThreadStack(std::size_t size);
+
+/**
+ * @brief Locks a range of memory into RAM, so accessing it never page faults
+ * @return If the range was locked, which fails if it would exceed the memory lock limit
+ */
+bool LockMemory(void* address, std::size_t size);
 
-inline void SetCurrentThreadName(const char* name) {}
+/**
+ * @brief Unlocks a range locked by LockMemory
+ */
+void UnlockMemory(void* address, std::size_t size);
 
 } // namespace Common
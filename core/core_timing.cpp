@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MPL-2.0
+// Copyright © 2023 Skyline Team and Contributors (https://github.com/skyline-emu/)
+
+#include <algorithm>
+#include <audio_core/common/settings.h>
+#include <audio_core/common/thread.h>
+#include "core_timing.h"
+
+namespace Core::Timing {
+
+CoreTiming::~CoreTiming() {
+    if (thread.joinable()) {
+        thread.request_stop();
+        {
+            std::scoped_lock lock{mutex};
+            wakeup_cv.notify_one();
+        }
+        thread.join();
+    }
+}
+
+void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
+                                      std::chrono::nanoseconds resched_time,
+                                      const std::shared_ptr<EventType>& event_type,
+                                      std::uintptr_t user_data, bool absolute_time) {
+    std::scoped_lock lock{mutex};
+
+    // Invalidate any occurrence already queued for this event.
+    event_type->generation++;
+    const auto target{Clock::now() + start_time};
+    Push({RoundUpToTick(target), target, resched_time, event_type, event_type->generation});
+
+    if (!thread.joinable()) {
+        thread = std::jthread([this](std::stop_token stop_token) { ThreadFunc(stop_token); });
+    }
+}
+
+void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
+                                 std::uintptr_t user_data, bool wait) {
+    std::unique_lock lock{mutex};
+
+    // The queued occurrence is dropped when the scheduler reaches it.
+    event_type->generation++;
+
+    if (wait && std::this_thread::get_id() != thread.get_id()) {
+        callback_done_cv.wait(lock, [&] { return running_event != event_type.get(); });
+    }
+}
+
+CoreTiming::Clock::time_point CoreTiming::RoundUpToTick(Clock::time_point time) {
+    const auto ticks{(time.time_since_epoch() + Tick - Clock::duration{1}) / Tick};
+    return Clock::time_point{std::chrono::duration_cast<Clock::duration>(ticks * Tick)};
+}
+
+void CoreTiming::Push(Occurrence&& occurrence) {
+    const bool earliest{occurrences.empty() || occurrence.due < occurrences.front().due};
+    occurrences.push_back(std::move(occurrence));
+    std::push_heap(occurrences.begin(), occurrences.end(), std::greater<>{});
+
+    if (earliest) {
+        wakeup_cv.notify_one();
+    }
+}
+
+void CoreTiming::ThreadFunc(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("CoreTiming");
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    Common::SetCurrentThreadAffinity(AudioCore::Settings::values.audio_thread_cpu_mask);
+
+    std::unique_lock lock{mutex};
+    while (!stop_token.stop_requested()) {
+        if (occurrences.empty()) {
+            wakeup_cv.wait(lock,
+                           [&] { return stop_token.stop_requested() || !occurrences.empty(); });
+            continue;
+        }
+
+        const auto now{Clock::now()};
+        if (occurrences.front().due > now) {
+            // Wakes early if an earlier occurrence is queued, or the scheduler is stopped.
+            const auto due{occurrences.front().due};
+            wakeup_cv.wait_until(lock, due, [&] {
+                return stop_token.stop_requested() || occurrences.front().due < due;
+            });
+            continue;
+        }
+
+        std::pop_heap(occurrences.begin(), occurrences.end(), std::greater<>{});
+        auto occurrence{std::move(occurrences.back())};
+        occurrences.pop_back();
+        auto& event_type{*occurrence.event_type};
+        if (occurrence.generation != event_type.generation) {
+            continue;
+        }
+
+        // Run the callback without the lock, so it can schedule or unschedule events itself.
+        running_event = &event_type;
+        lock.unlock();
+        const auto next_time{event_type.callback(0, 0, now - occurrence.target)};
+        lock.lock();
+        running_event = nullptr;
+        callback_done_cv.notify_all();
+
+        if (occurrence.generation != event_type.generation) {
+            continue;
+        }
+
+        // Keep to the exact cadence, but skip runs missed while stalled rather than bursting.
+        const auto resched_time{next_time.value_or(occurrence.resched_time)};
+        const auto target{std::max(occurrence.target + resched_time, now)};
+        Push({RoundUpToTick(target), target, occurrence.resched_time,
+              std::move(occurrence.event_type), occurrence.generation});
+    }
+}
+
+}
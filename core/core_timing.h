@@ -4,12 +4,14 @@
 #pragma once
 
 #include <chrono>
-#include <set>
+#include <condition_variable>
 #include <string>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 #include <audio_core/common/polyfill_thread.h>
 #include <audio_core/common/common_types.h>
 
@@ -24,59 +26,55 @@ using TimedCallback = std::function<std::optional<std::chrono::nanoseconds>(
 
 /// Contains the characteristics of a particular event.
 struct EventType {
-    void ThreadFunc() {
-        auto expected_time{std::chrono::system_clock::now() + start_time};
-        std::this_thread::sleep_until(expected_time);
-        while (!thread->get_stop_token().stop_requested()) {
-            callback(0, 0, {});
-            expected_time += resched_time;
-            std::this_thread::sleep_until(expected_time);
-        }
-    }
-
     explicit EventType(TimedCallback&& callback_, std::string&& name_)
         : callback{std::move(callback_)}, name{std::move(name_)} {}
 
-    void Run(std::chrono::nanoseconds _start_time,
-             std::chrono::nanoseconds _resched_time) {
-        start_time = _start_time;
-        resched_time = _resched_time;
-        thread.emplace(&EventType::ThreadFunc, this);
-    }
-
-    void Stop() {
-        if (thread.value().joinable()) {
-            thread->request_stop();
-            thread->join();
-        }
-    }
-
     /// The event's callback function.
     TimedCallback callback;
-    std::optional<std::jthread> thread;
-    std::chrono::nanoseconds start_time;
-    std::chrono::nanoseconds resched_time;
     /// A pointer to the name of the event.
     const std::string name;
+    /// Bumped whenever the event is scheduled or unscheduled, invalidating queued occurrences.
+    /// Guarded by the CoreTiming mutex.
+    u64 generation{};
 };
 
+/**
+ * Runs looping events from a single scheduler thread, rather than a thread per event.
+ *
+ * Occurrences are kept in a min-heap ordered by due time on the steady clock. Due times are
+ * rounded up to a whole Tick, so events due in the same tick run together after one wakeup.
+ * Unscheduling only invalidates an event's queued occurrence, which the scheduler drops when it
+ * reaches it, so no thread is ever joined.
+ */
 class CoreTiming {
-private:
-    std::set<std::shared_ptr<EventType>> scheduled_events;
 public:
+    /// Granularity events are coalesced at
+    static constexpr std::chrono::milliseconds Tick{1};
+
+    CoreTiming() = default;
+    ~CoreTiming();
+
+    /**
+     * Schedule an event to run repeatedly, replacing any previous schedule for it.
+     *
+     * @param start_time   - Delay before the first run.
+     * @param resched_time - Interval between runs, unless the callback returns a different one.
+     * @param event_type   - Event to run.
+     */
     void ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                               std::chrono::nanoseconds resched_time,
                               const std::shared_ptr<EventType>& event_type,
-                              std::uintptr_t user_data = 0, bool absolute_time = false) {
-        scheduled_events.emplace(event_type);
-        event_type->Run(start_time, resched_time);
-    }
-
+                              std::uintptr_t user_data = 0, bool absolute_time = false);
+
+    /**
+     * Stop an event from running again.
+     *
+     * @param event_type - Event to stop.
+     * @param wait       - Wait for a run of the event in progress on the scheduler thread to
+     *                     finish, so whatever its callback uses can be destroyed afterwards.
+     */
     void UnscheduleEvent(const std::shared_ptr<EventType>& event_type, std::uintptr_t user_data,
-                         bool wait = true) {
-        event_type->Stop();
-        scheduled_events.erase(event_type);
-    }
+                         bool wait = true);
 
     u64 GetClockTicks() {
         return Core::Timing::GetClockTicks();
@@ -85,10 +83,54 @@ public:
     std::chrono::nanoseconds GetGlobalTimeNs() const {
         return GetClockNs();
     }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// A queued run of an event
+    struct Occurrence {
+        Clock::time_point due; //!< When to run, rounded up to a tick
+        Clock::time_point target; //!< Exact time the cadence asks for, which due is rounded from
+        std::chrono::nanoseconds resched_time;
+        std::shared_ptr<EventType> event_type;
+        u64 generation;
+
+        /// Orders the heap so the earliest occurrence is at the front
+        bool operator>(const Occurrence& other) const {
+            return due > other.due;
+        }
+    };
+
+    /**
+     * Round a time up to the next whole tick, so nearby occurrences share a wakeup.
+     */
+    static Clock::time_point RoundUpToTick(Clock::time_point time);
+
+    /**
+     * Push an occurrence onto the heap. Must be called with the mutex held.
+     */
+    void Push(Occurrence&& occurrence);
+
+    /**
+     * Runs due occurrences until stopped.
+     */
+    void ThreadFunc(std::stop_token stop_token);
+
+    /// Guards everything below, and the generation of every event
+    std::mutex mutex;
+    /// Signalled when an earlier occurrence is queued, or the scheduler stops
+    std::condition_variable wakeup_cv;
+    /// Signalled when the scheduler finishes running an event's callback
+    std::condition_variable callback_done_cv;
+    /// Min-heap of queued occurrences, ordered by due time
+    std::vector<Occurrence> occurrences;
+    /// Event whose callback is running on the scheduler thread, if any
+    const EventType* running_event{};
+    /// The scheduler thread, started with the first scheduled event
+    std::jthread thread;
 };
 
 inline std::shared_ptr<EventType> CreateEvent(std::string name, TimedCallback&& callback) {
     return std::make_shared<EventType>(std::move(callback), std::move(name));
 }
 }
-
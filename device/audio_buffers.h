@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
-#include <mutex>
+#include <atomic>
+#include <bit>
 #include <span>
 #include <vector>
 
@@ -16,6 +18,91 @@ namespace AudioCore {
 
 constexpr s32 BufferAppendLimit = 4;
 
+/**
+ * An open-addressed set of buffer tags, counting duplicates, for constant time lookups.
+ * Uses linear probing, with entries shifted back on removal so no tombstones are needed.
+ *
+ * @tparam N - Maximum number of tags held at once.
+ */
+template <size_t N>
+class AudioBufferTagIndex {
+public:
+    /**
+     * Add a tag.
+     *
+     * @param tag - Tag to add.
+     */
+    void Insert(const u64 tag) {
+        auto index{Home(tag)};
+        while (entries[index].count != 0 && entries[index].tag != tag) {
+            index = (index + 1) & Mask;
+        }
+        entries[index].tag = tag;
+        entries[index].count++;
+    }
+
+    /**
+     * Remove one instance of a tag.
+     *
+     * @param tag - Tag to remove.
+     */
+    void Erase(const u64 tag) {
+        auto index{Home(tag)};
+        while (entries[index].tag != tag) {
+            if (entries[index].count == 0) {
+                return;
+            }
+            index = (index + 1) & Mask;
+        }
+        if (entries[index].count == 0 || --entries[index].count != 0) {
+            return;
+        }
+
+        // Shift later entries of the probe run back into the hole, unless that would move them
+        // before their home slot.
+        for (auto next{(index + 1) & Mask}; entries[next].count != 0; next = (next + 1) & Mask) {
+            const auto home{Home(entries[next].tag)};
+            if (((next - home) & Mask) >= ((next - index) & Mask)) {
+                entries[index] = entries[next];
+                index = next;
+            }
+        }
+        entries[index] = {};
+    }
+
+    /**
+     * Check if a tag is held.
+     *
+     * @param tag - Tag to search for.
+     * @return True if the tag is held, otherwise false.
+     */
+    bool Contains(const u64 tag) const {
+        for (auto index{Home(tag)}; entries[index].count != 0; index = (index + 1) & Mask) {
+            if (entries[index].tag == tag) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    /// Twice the tags held, so probe runs stay short
+    static constexpr size_t Size{std::bit_ceil(N * 2)};
+    static constexpr size_t Mask{Size - 1};
+
+    struct Entry {
+        u64 tag;
+        u32 count;
+    };
+
+    /// Tags are usually addresses, so mix the high bits down before masking
+    static size_t Home(const u64 tag) {
+        return static_cast<size_t>((tag * 0x9E3779B97F4A7C15ULL) >> 32) & Mask;
+    }
+
+    std::array<Entry, Size> entries{};
+};
+
 /**
  * A ringbuffer of N audio buffers.
  * The buffer contains 3 sections:
@@ -24,6 +111,12 @@ constexpr s32 BufferAppendLimit = 4;
  *     Released   - Buffers which have been played, and can now be recycled.
  * Any others are free/untracked.
  *
+ * The sections are contiguous, so they're tracked by four ever-increasing positions, each moved
+ * forwards by one kind of transition, and counts are the differences between them. There's no
+ * lock of its own: AudioOut and AudioIn already serialise every call under their manager's mutex,
+ * shared between the service thread and the AudioManager thread. The counts can still be read
+ * from any thread without it.
+ *
  * @tparam N - Maximum number of buffers in the ring.
  */
 template <size_t N>
@@ -37,10 +130,10 @@ public:
      * @param buffer - The new buffer.
      */
     void AppendBuffer(const AudioBuffer& buffer) {
-        std::scoped_lock l{lock};
-        buffers[appended_index] = buffer;
-        appended_count++;
-        appended_index = (appended_index + 1) % append_limit;
+        const auto end{appended_end.load(std::memory_order_relaxed)};
+        buffers[Slot(end)] = buffer;
+        tags.Insert(buffer.tag);
+        appended_end.store(end + 1, std::memory_order_release);
     }
 
     /**
@@ -49,25 +142,19 @@ public:
      * @param out_buffers - The buffers which were registered.
      */
     void RegisterBuffers(std::vector<AudioBuffer>& out_buffers) {
-        std::scoped_lock l{lock};
+        const auto begin{appended_begin.load(std::memory_order_relaxed)};
+        const auto appended_count{static_cast<s32>(GetAppendedCount())};
+        const auto registered_count{static_cast<s32>(GetRegisteredCount())};
         const s32 to_register{std::min(std::min(appended_count, BufferAppendLimit),
                                        BufferAppendLimit - registered_count)};
+        if (to_register <= 0) {
+            return;
+        }
 
         for (s32 i = 0; i < to_register; i++) {
-            s32 index{appended_index - appended_count};
-            if (index < 0) {
-                index += N;
-            }
-
-            out_buffers.push_back(buffers[index]);
-            registered_count++;
-            registered_index = (registered_index + 1) % append_limit;
-
-            appended_count--;
-            if (appended_count == 0) {
-                break;
-            }
+            out_buffers.push_back(buffers[Slot(begin + i)]);
         }
+        appended_begin.store(begin + to_register, std::memory_order_release);
     }
 
     /**
@@ -77,12 +164,9 @@ public:
      * @param timestamp - The released timestamp for this buffer.
      */
     void ReleaseBuffer(s32 index, s64 timestamp) {
-        std::scoped_lock l{lock};
         buffers[index].played_timestamp = timestamp;
-
-        registered_count--;
-        released_count++;
-        released_index = (released_index + 1) % append_limit;
+        registered_begin.store(registered_begin.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_release);
     }
 
     /**
@@ -93,15 +177,11 @@ public:
      *
      * @return If any buffer was released.
      */
-    bool ReleaseBuffers(const Core::Timing::CoreTiming& core_timing, const DeviceSession& session,
+    bool ReleaseBuffers(const Core::Timing::CoreTiming& core_timing, DeviceSession& session,
                         bool force) {
-        std::scoped_lock l{lock};
         bool buffer_released{false};
-        while (registered_count > 0) {
-            auto index{registered_index - registered_count};
-            if (index < 0) {
-                index += N;
-            }
+        while (GetRegisteredCount() > 0) {
+            const auto index{static_cast<s32>(Slot(registered_begin.load()))};
 
             // Check with the backend if this buffer can be released yet.
             // If we're shutting down, we don't care if it's been played or not.
@@ -109,33 +189,32 @@ public:
                 break;
             }
 
+            // AudioIn fills the game's buffer with the recorded samples here.
+            session.ReleaseBuffer(buffers[index]);
             ReleaseBuffer(index, core_timing.GetGlobalTimeNs().count());
             buffer_released = true;
         }
 
-        return buffer_released || registered_count == 0;
+        return buffer_released || GetRegisteredCount() == 0;
     }
 
     /**
      * Get all released buffers.
      *
-     * @param tags - Container to be filled with the released buffers' tags.
+     * @param out_tags - Container to be filled with the released buffers' tags.
      * @return The number of buffers released.
      */
-    u32 GetReleasedBuffers(std::span<u64> tags) {
-        std::scoped_lock l{lock};
+    u32 GetReleasedBuffers(std::span<u64> out_tags) {
+        auto begin{released_begin.load(std::memory_order_relaxed)};
+        const auto end{registered_begin.load(std::memory_order_acquire)};
         u32 released{0};
 
-        while (released_count > 0) {
-            auto index{released_index - released_count};
-            if (index < 0) {
-                index += N;
-            }
-
-            auto& buffer{buffers[index]};
-            released_count--;
+        while (begin != end) {
+            auto& buffer{buffers[Slot(begin)]};
+            begin++;
 
             auto tag{buffer.tag};
+            tags.Erase(tag);
             buffer.played_timestamp = 0;
             buffer.samples = 0;
             buffer.tag = 0;
@@ -145,17 +224,18 @@ public:
                 break;
             }
 
-            if (released < tags.size()) {
-                tags[released] = tag;
+            if (released < out_tags.size()) {
+                out_tags[released] = tag;
             }
 
             released++;
 
-            if (released >= tags.size()) {
+            if (released >= out_tags.size()) {
                 break;
             }
         }
 
+        released_begin.store(begin, std::memory_order_release);
         return released;
     }
 
@@ -167,51 +247,25 @@ public:
      * @return The number of buffers released.
      */
     u32 GetRegisteredAppendedBuffers(std::vector<AudioBuffer>& buffers_flushed, u32 max_buffers) {
-        std::scoped_lock l{lock};
-        if (registered_count + appended_count == 0) {
-            return 0;
-        }
-
-        size_t buffers_to_flush{
-            std::min(static_cast<u32>(registered_count + appended_count), max_buffers)};
+        const auto buffers_to_flush{
+            std::min(GetRegisteredCount() + GetAppendedCount(), static_cast<u64>(max_buffers))};
         if (buffers_to_flush == 0) {
             return 0;
         }
 
-        while (registered_count > 0) {
-            auto index{registered_index - registered_count};
-            if (index < 0) {
-                index += N;
-            }
-
-            buffers_flushed.push_back(buffers[index]);
-
-            registered_count--;
-            released_count++;
-            released_index = (released_index + 1) % append_limit;
-
-            if (buffers_flushed.size() >= buffers_to_flush) {
-                break;
-            }
-        }
-
-        while (appended_count > 0) {
-            auto index{appended_index - appended_count};
-            if (index < 0) {
-                index += N;
-            }
-
-            buffers_flushed.push_back(buffers[index]);
-
-            appended_count--;
-            released_count++;
-            released_index = (released_index + 1) % append_limit;
-
-            if (buffers_flushed.size() >= buffers_to_flush) {
-                break;
-            }
+        // Registered buffers are released first, then appended ones once none are registered,
+        // so the released section stays contiguous.
+        auto begin{registered_begin.load(std::memory_order_relaxed)};
+        const auto registered_end{appended_begin.load(std::memory_order_relaxed)};
+        const auto appended_end_{appended_end.load(std::memory_order_relaxed)};
+        while (buffers_flushed.size() < buffers_to_flush &&
+               (begin != registered_end || registered_end != appended_end_)) {
+            buffers_flushed.push_back(buffers[Slot(begin)]);
+            begin++;
         }
 
+        appended_begin.store(std::max(begin, registered_end), std::memory_order_release);
+        registered_begin.store(begin, std::memory_order_release);
         return static_cast<u32>(buffers_flushed.size());
     }
 
@@ -222,26 +276,7 @@ public:
      * @return True if the buffer is still in the ring, otherwise false.
      */
     bool ContainsBuffer(const u64 tag) const {
-        std::scoped_lock l{lock};
-        const auto registered_buffers{appended_count + registered_count + released_count};
-
-        if (registered_buffers == 0) {
-            return false;
-        }
-
-        auto index{released_index - released_count};
-        if (index < 0) {
-            index += append_limit;
-        }
-
-        for (s32 i = 0; i < registered_buffers; i++) {
-            if (buffers[index].tag == tag) {
-                return true;
-            }
-            index = (index + 1) % append_limit;
-        }
-
-        return false;
+        return tags.Contains(tag);
     }
 
     /**
@@ -251,8 +286,7 @@ public:
      * @return Number of active buffers.
      */
     u32 GetAppendedRegisteredCount() const {
-        std::scoped_lock l{lock};
-        return appended_count + registered_count;
+        return static_cast<u32>(GetAppendedCount() + GetRegisteredCount());
     }
 
     /**
@@ -262,8 +296,8 @@ public:
      * @return Number of active buffers.
      */
     u32 GetTotalBufferCount() const {
-        std::scoped_lock l{lock};
-        return static_cast<u32>(appended_count + registered_count + released_count);
+        return static_cast<u32>(appended_end.load(std::memory_order_acquire) -
+                                released_begin.load(std::memory_order_acquire));
     }
 
     /**
@@ -273,16 +307,15 @@ public:
      * @return True if buffers were successfully flushed, otherwise false.
      */
     bool FlushBuffers(u32& buffers_released) {
-        std::scoped_lock l{lock};
         std::vector<AudioBuffer> buffers_flushed{};
 
         buffers_released = GetRegisteredAppendedBuffers(buffers_flushed, append_limit);
 
-        if (registered_count > 0) {
+        if (GetRegisteredCount() > 0) {
             return false;
         }
 
-        if (static_cast<u32>(released_count + appended_count) > append_limit) {
+        if (GetReleasedCount() + GetAppendedCount() > append_limit) {
             return false;
         }
 
@@ -290,32 +323,49 @@ public:
     }
 
     u64 GetNextTimestamp() const {
-        // Iterate backwards through the buffer queue, and take the most recent buffer's end
-        std::scoped_lock l{lock};
-        auto index{appended_index - 1};
-        if (index < 0) {
-            index += append_limit;
-        }
-        return buffers[index].end_timestamp;
+        // Take the most recent buffer's end
+        const auto end{appended_end.load(std::memory_order_acquire)};
+        return buffers[Slot(end + append_limit - 1)].end_timestamp;
     }
 
 private:
-    /// Buffer lock
-    mutable std::recursive_mutex lock{};
+    /**
+     * Get the ring slot of a position.
+     *
+     * @param position - One of the ever-increasing positions.
+     * @return Index into the buffers.
+     */
+    size_t Slot(const u64 position) const {
+        return static_cast<size_t>(position % append_limit);
+    }
+
+    u64 GetReleasedCount() const {
+        return registered_begin.load(std::memory_order_acquire) -
+               released_begin.load(std::memory_order_acquire);
+    }
+
+    u64 GetRegisteredCount() const {
+        return appended_begin.load(std::memory_order_acquire) -
+               registered_begin.load(std::memory_order_acquire);
+    }
+
+    u64 GetAppendedCount() const {
+        return appended_end.load(std::memory_order_acquire) -
+               appended_begin.load(std::memory_order_acquire);
+    }
+
     /// The audio buffers
     std::array<AudioBuffer, N> buffers{};
-    /// Current released index
-    s32 released_index{};
-    /// Number of released buffers
-    s32 released_count{};
-    /// Current registered index
-    s32 registered_index{};
-    /// Number of registered buffers
-    s32 registered_count{};
-    /// Current appended index
-    s32 appended_index{};
-    /// Number of appended buffers
-    s32 appended_count{};
+    /// Tags of all buffers in the ring
+    AudioBufferTagIndex<N> tags{};
+    /// Position of the oldest released buffer
+    std::atomic<u64> released_begin{};
+    /// Position of the oldest registered buffer, and the end of the released buffers
+    std::atomic<u64> registered_begin{};
+    /// Position of the oldest appended buffer, and the end of the registered buffers
+    std::atomic<u64> appended_begin{};
+    /// Position the next buffer is appended at
+    std::atomic<u64> appended_end{};
     /// Maximum number of buffers (default 32)
     u32 append_limit{};
 };
@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
+
 #include <audio_core/audio_core.h>
 #include <audio_core/audio_manager.h>
+#include <audio_core/common/settings.h>
 #include <audio_core/device/audio_buffer.h>
 #include <audio_core/device/device_session.h>
 #include <audio_core/sink/sink_stream.h>
@@ -46,6 +49,15 @@ Result DeviceSession::Initialize(std::string_view name_, SampleFormat sample_for
         sink = &system.AudioCore().GetOutputSink();
     }
     stream = sink->AcquireSinkStream(system, channel_count, name, type);
+    in_place = type == Sink::StreamType::Out && Settings::values.audio_out_in_place_buffers;
+    // The new stream's consumed frame count starts from 0.
+    in_place_appended_frames = 0;
+    in_place_buffers.clear();
+    event_driven = Settings::values.audio_event_driven_buffer_release;
+    if (event_driven) {
+        // The backend signals when buffers complete, so there's nothing to poll for.
+        stream->SetBufferConsumedCallback([this] { SignalManager(); });
+    }
     initialized = true;
     return ResultSuccess;
 }
@@ -61,36 +73,49 @@ void DeviceSession::Finalize() {
 void DeviceSession::Start() {
     if (stream) {
         stream->Start();
-        system.CoreTiming().ScheduleLoopingEvent(std::chrono::nanoseconds::zero(), INCREMENT_TIME,
-                                                 thread_event);
+        if (!event_driven) {
+            system.CoreTiming().ScheduleLoopingEvent(std::chrono::nanoseconds::zero(),
+                                                     INCREMENT_TIME, thread_event);
+        }
     }
 }
 
 void DeviceSession::Stop() {
     if (stream) {
         stream->Stop();
-        system.CoreTiming().UnscheduleEvent(thread_event, {});
+        if (!event_driven) {
+            system.CoreTiming().UnscheduleEvent(thread_event, {});
+        }
     }
 }
 
 void DeviceSession::ClearBuffers() {
     if (stream) {
         stream->ClearQueue();
+        // Dropped buffers count as consumed, so the count is back in step with what was appended.
+        in_place_appended_frames = stream->GetConsumedFrameCount();
+        in_place_buffers.clear();
     }
 }
 
-void DeviceSession::AppendBuffers(std::span<const AudioBuffer> buffers) const {
+void DeviceSession::AppendBuffers(std::span<const AudioBuffer> buffers) {
     for (const auto& buffer : buffers) {
         Sink::SinkBuffer new_buffer{
             .frames = buffer.size / (channel_count * sizeof(s16)),
             .frames_played = 0,
             .tag = buffer.tag,
             .consumed = false,
+            .samples = nullptr,
         };
 
         if (type == Sink::StreamType::In) {
             std::vector<s16> samples{};
             stream->AppendBuffer(new_buffer, samples);
+        } else if (in_place) {
+            new_buffer.samples = system.Memory().GetPointer<const s16>(buffer.samples);
+            in_place_appended_frames += new_buffer.frames;
+            in_place_buffers.push_back({buffer.tag, in_place_appended_frames});
+            stream->AppendBufferInPlace(new_buffer);
         } else {
             std::vector<s16> samples(buffer.size / sizeof(s16));
             system.Memory().ReadBlockUnsafe(buffer.samples, samples.data(), buffer.size);
@@ -101,15 +126,43 @@ void DeviceSession::AppendBuffers(std::span<const AudioBuffer> buffers) const {
 
 void DeviceSession::ReleaseBuffer(const AudioBuffer& buffer) const {
     if (type == Sink::StreamType::In) {
-        auto samples{stream->ReleaseBuffer(buffer.size / sizeof(s16))};
-        system.Memory().WriteBlockUnsafe(buffer.samples, samples.data(), buffer.size);
+        // Recorded samples are written straight into the game's buffer.
+        stream->ReleaseBuffer(
+            {system.Memory().GetPointer<s16>(buffer.samples), buffer.size / sizeof(s16)});
     }
 }
 
-bool DeviceSession::IsBufferConsumed(const AudioBuffer& buffer) const {
+bool DeviceSession::IsBufferConsumed(const AudioBuffer& buffer) {
+    if (event_driven) {
+        return stream->TakeConsumedBuffer(buffer.tag);
+    }
+    if (in_place) {
+        // The game may write to the buffer as soon as it's released, so wait until the backend
+        // has read all of it, rather than going by the estimated played sample count.
+        const auto it{std::ranges::find(in_place_buffers, buffer.tag, &InPlaceBuffer::tag)};
+        if (it == in_place_buffers.end()) {
+            // Appended to a previous stream, or cleared from this one, so no longer read.
+            return true;
+        }
+        // Buffers ahead of this one were released without being checked.
+        in_place_buffers.erase(in_place_buffers.begin(), it);
+        if (stream->GetConsumedFrameCount() < in_place_buffers.front().end_frame) {
+            return false;
+        }
+        in_place_buffers.pop_front();
+        return true;
+    }
     return played_sample_count >= buffer.end_timestamp;
 }
 
+bool DeviceSession::IsReadingInPlace() const {
+    return in_place;
+}
+
+bool DeviceSession::IsReleaseEventDriven() const {
+    return event_driven;
+}
+
 void DeviceSession::SetVolume(f32 volume) const {
     if (stream) {
         stream->SetSystemVolume(volume);
@@ -117,17 +170,25 @@ void DeviceSession::SetVolume(f32 volume) const {
 }
 
 u64 DeviceSession::GetPlayedSampleCount() const {
+    if (event_driven) {
+        // Not kept up to date by ThreadFunc, so ask the backend.
+        return stream ? stream->GetExpectedPlayedSampleCount() : 0;
+    }
     return played_sample_count;
 }
 
 std::optional<std::chrono::nanoseconds> DeviceSession::ThreadFunc() {
     played_sample_count = stream->GetExpectedPlayedSampleCount();
+    SignalManager();
+    return std::nullopt;
+}
+
+void DeviceSession::SignalManager() const {
     if (type == Sink::StreamType::Out) {
         system.AudioCore().GetAudioManager().SetEvent(Event::Type::AudioOutManager, true);
     } else {
         system.AudioCore().GetAudioManager().SetEvent(Event::Type::AudioInManager, true);
     }
-    return std::nullopt;
 }
 
 void DeviceSession::SetRingSize(u32 ring_size) {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
 #include <memory>
 #include <optional>
 #include <span>
@@ -62,7 +63,7 @@ public:
      *
      * @param buffers - The buffers to play.
      */
-    void AppendBuffers(std::span<const AudioBuffer> buffers) const;
+    void AppendBuffers(std::span<const AudioBuffer> buffers);
 
     /**
      * (Audio In only) Pop samples from the backend, and write them back to this buffer's address.
@@ -78,7 +79,24 @@ public:
      *
      * @return true if the buffer has been consumed, otherwise false.
      */
-    bool IsBufferConsumed(const AudioBuffer& buffer) const;
+    bool IsBufferConsumed(const AudioBuffer& buffer);
+
+    /**
+     * Check if the backend stream reads buffers straight from game memory, in which case buffers
+     * handed back to the game early must be cleared from it first.
+     *
+     * @return True if buffers are read in place, otherwise false.
+     */
+    bool IsReadingInPlace() const;
+
+    /**
+     * Check if buffers are released as the backend consumes them, rather than polled for. Tags
+     * are only published for buffers still in the backend, so buffers handed back to the game
+     * early must be cleared from it first.
+     *
+     * @return True if buffers are released on events, otherwise false.
+     */
+    bool IsReleaseEventDriven() const;
 
     /**
      * Start this device session, starting the backend stream.
@@ -120,6 +138,17 @@ public:
     void SetRingSize(u32 ring_size);
 
 private:
+    /// A buffer read in place, and the stream's consumed frame count once it has all been read
+    struct InPlaceBuffer {
+        u64 tag;
+        u64 end_frame;
+    };
+
+    /**
+     * Signal the audio manager to release this session's buffers.
+     */
+    void SignalManager() const;
+
     /// System
     Core::System& system;
     /// Output sink this device will use
@@ -146,8 +175,19 @@ private:
     std::shared_ptr<Core::Timing::EventType> thread_event;
     /// Is this session initialised?
     bool initialized{};
+    /// Are output buffers read in place? See Settings::values.audio_out_in_place_buffers
+    bool in_place{};
+    /// Are buffers released as they're consumed? See
+    /// Settings::values.audio_event_driven_buffer_release
+    bool event_driven{};
     /// Buffer queue
     std::vector<AudioBuffer> buffer_queue{};
+    /// Frames appended to the stream in place, since it was acquired or last cleared
+    u64 in_place_appended_frames{};
+    /// Buffers appended in place, in order, until they're checked by IsBufferConsumed. Positions
+    /// are in the stream's frames rather than the game's timestamps, which keep counting across
+    /// streams and include buffers flushed before reaching the stream
+    std::deque<InPlaceBuffer> in_place_buffers{};
 };
 
 } // namespace AudioCore
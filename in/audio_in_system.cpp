@@ -158,6 +158,12 @@ bool System::FlushAudioInBuffers() {
         return false;
     }
 
+    // Flushed buffers go back to the game, so the backend must drop them and stop publishing
+    // their tags. The clear runs on the backend's callback thread, so no late tag can follow it.
+    if (session->IsReleaseEventDriven()) {
+        session->ClearBuffers();
+    }
+
     u32 buffers_released{};
     buffers.FlushBuffers(buffers_released);
 
@@ -157,6 +157,13 @@ bool System::FlushAudioOutBuffers() {
         return false;
     }
 
+    // Flushed buffers go back to the game, so the backend must stop reading them in place, or
+    // publishing their tags once played. The clear runs on the backend's callback thread, so no
+    // late read or tag can follow it.
+    if (session->IsReadingInPlace() || session->IsReleaseEventDriven()) {
+        session->ClearBuffers();
+    }
+
     u32 buffers_released{};
     buffers.FlushBuffers(buffers_released);
 
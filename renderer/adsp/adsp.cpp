@@ -54,6 +54,14 @@ void ADSP::SendCommandBuffer(const u32 session_id, const CommandBuffer& command_
     render_mailbox.SetCommandBuffer(session_id, command_buffer);
 }
 
+CommandTimingReport ADSP::GetCommandTimingReport(const u32 session_id) {
+    return render_mailbox.GetCommandTimingStatistics(session_id).GetReport();
+}
+
+void ADSP::ResetCommandTimingStatistics(const u32 session_id) {
+    render_mailbox.GetCommandTimingStatistics(session_id).RequestReset();
+}
+
 u64 ADSP::GetRenderingStartTick(const u32 session_id) {
     return render_mailbox.GetSignalledTick() +
            render_mailbox.GetCommandBuffer(session_id).render_time_taken;
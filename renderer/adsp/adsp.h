@@ -138,6 +138,23 @@ public:
      */
     void ClearCommandBuffers();
 
+    /**
+     * Get a report of the time taken by each type of command for a session.
+     * Only populated while Settings::values.audio_command_timing_statistics is enabled.
+     *
+     * @param session_id - The session id to report (0 or 1).
+     * @return The timing report.
+     */
+    CommandTimingReport GetCommandTimingReport(u32 session_id);
+
+    /**
+     * Clear the recorded command timings for a session.
+     * The clear is deferred to the start of the AudioRenderer's next frame.
+     *
+     * @param session_id - The session id to clear (0 or 1).
+     */
+    void ResetCommandTimingStatistics(u32 session_id);
+
     /**
      * Signal the AudioRenderer to begin processing.
      */
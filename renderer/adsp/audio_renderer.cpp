@@ -10,6 +10,7 @@
 #include <audio_core/sink/sink.h>
 #include <audio_core/common/logging/log.h>
 #include <audio_core/common/microprofile.h>
+#include <audio_core/common/settings.h>
 #include <audio_core/common/thread.h>
 #include <core/core.h>
 #include <core/core_timing.h>
@@ -20,31 +21,19 @@ MICROPROFILE_DEFINE(Audio_Renderer, "Audio", "DSP", MP_RGB(60, 19, 97));
 namespace AudioCore::AudioRenderer::ADSP {
 
 void AudioRenderer_Mailbox::HostSendMessage(RenderMessage message_) {
-    adsp_messages.enqueue(message_);
-    adsp_event.Set();
+    adsp_mailbox.Send(static_cast<u32>(message_));
 }
 
 RenderMessage AudioRenderer_Mailbox::HostWaitMessage() {
-    host_event.Wait();
-    RenderMessage msg{RenderMessage::Invalid};
-    if (!host_messages.try_dequeue(msg)) {
-        LOG_ERROR(Service_Audio, "Failed to dequeue host message!");
-    }
-    return msg;
+    return static_cast<RenderMessage>(host_mailbox.Receive());
 }
 
 void AudioRenderer_Mailbox::ADSPSendMessage(const RenderMessage message_) {
-    host_messages.enqueue(message_);
-    host_event.Set();
+    host_mailbox.Send(static_cast<u32>(message_));
 }
 
 RenderMessage AudioRenderer_Mailbox::ADSPWaitMessage() {
-    adsp_event.Wait();
-    RenderMessage msg{RenderMessage::Invalid};
-    if (!adsp_messages.try_dequeue(msg)) {
-        LOG_ERROR(Service_Audio, "Failed to dequeue ADSP message!");
-    }
-    return msg;
+    return static_cast<RenderMessage>(adsp_mailbox.Receive());
 }
 
 CommandBuffer& AudioRenderer_Mailbox::GetCommandBuffer(const u32 session_id) {
@@ -84,6 +73,10 @@ void AudioRenderer_Mailbox::ClearCommandBuffers() {
     command_buffers[1].reset_buffers = false;
 }
 
+CommandTimingStatistics& AudioRenderer_Mailbox::GetCommandTimingStatistics(const u32 session_id) {
+    return command_timing_statistics[session_id];
+}
+
 AudioRenderer::AudioRenderer(Core::System& system_)
     : system{system_}, sink{system.AudioCore().GetOutputSink()} {
     CreateSinkStreams();
@@ -127,7 +120,13 @@ void AudioRenderer::CreateSinkStreams() {
         std::string name{fmt::format("ADSP_RenderStream-{}", i)};
         streams[i] =
             sink.AcquireSinkStream(system, channels, name, ::AudioCore::Sink::StreamType::Render);
-        streams[i]->SetRingSize(4);
+        if (Settings::values.adaptive_render_queue) {
+            streams[i]->SetAdaptiveRingSize(Settings::values.render_queue_min_buffers,
+                                            Settings::values.render_queue_max_buffers,
+                                            Settings::values.render_queue_shrink_seconds, 4);
+        } else {
+            streams[i]->SetRingSize(4);
+        }
     }
 }
 
@@ -135,7 +134,10 @@ void AudioRenderer::ThreadFunc() {
     static constexpr char name[]{"AudioRenderer"};
     MicroProfileOnThreadCreate(name);
     Common::SetCurrentThreadName(name);
-    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    // Scheduling latency here is heard as glitches, so this runs above the other audio threads.
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::VeryHigh);
+    Common::SetCurrentThreadAffinity(Settings::values.audio_renderer_cpu_mask);
+    Common::PrefaultCurrentThreadStack(Common::PrefaultStackSize);
     if (mailbox->ADSPWaitMessage() != RenderMessage::AudioRenderer_InitializeOK) {
         LOG_ERROR(Service_Audio,
                   "ADSP Audio Renderer -- Failed to receive initialize message from host!");
@@ -167,13 +169,21 @@ void AudioRenderer::ThreadFunc() {
                 auto& command_buffer{mailbox->GetCommandBuffer(index)};
                 auto& command_list_processor{command_list_processors[index]};
 
+                // Clear the timings here, as only this thread records them.
+                mailbox->GetCommandTimingStatistics(index).ApplyPendingReset();
+
                 // Check this buffer is valid, as it may not be used.
                 if (command_buffer.buffer != 0) {
                     // If there are no remaining commands (from the previous list),
                     // this is a new command list, initalize it.
                     if (command_buffer.remaining_command_count == 0) {
-                        command_list_processor.Initialize(system, command_buffer.buffer,
-                                                          command_buffer.size, streams[index]);
+                        CommandTimingStatistics* statistics{nullptr};
+                        if (Settings::values.audio_command_timing_statistics) {
+                            statistics = &mailbox->GetCommandTimingStatistics(index);
+                        }
+                        command_list_processor.Initialize(
+                            system, command_buffer.buffer, command_buffer.size, streams[index],
+                            command_buffer.time_estimator, statistics);
                     }
 
                     if (command_buffer.reset_buffers && !buffers_reset[index]) {
@@ -9,9 +9,10 @@
 
 #include <audio_core/renderer/adsp/command_buffer.h>
 #include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/adsp/command_timing_statistics.h>
+#include <audio_core/common/atomic_mailbox.h>
 #include <audio_core/common/common_types.h>
 #include <audio_core/common/polyfill_thread.h>
-#include <audio_core/common/reader_writer_queue.h>
 #include <audio_core/common/thread.h>
 
 namespace Core {
@@ -135,22 +136,27 @@ public:
      */
     void ClearCommandBuffers();
 
-private:
-    /// Host signalling event
-    Common::Event host_event{};
-    /// AudioRenderer signalling event
-    Common::Event adsp_event{};
-    /// Host message queue
-
-    Common::ReaderWriterQueue<RenderMessage> host_messages{};
-    /// AudioRenderer message queue
+    /**
+     * Get the command timing statistics for a given session.
+     *
+     * @param session_id - The session id to get (0 or 1).
+     * @return The command timing statistics.
+     */
+    CommandTimingStatistics& GetCommandTimingStatistics(u32 session_id);
 
-    Common::ReaderWriterQueue<RenderMessage> adsp_messages{};
+private:
+    /// Messages from the AudioRenderer to the host. Messages are exchanged strictly as request and
+    /// response, so a single slot each way is enough.
+    Common::AtomicMailbox host_mailbox{};
+    /// Messages from the host to the AudioRenderer
+    Common::AtomicMailbox adsp_mailbox{};
     /// Command buffers
 
     std::array<CommandBuffer, MaxRendererSessions> command_buffers{};
     /// Tick the AudioRnederer was signalled
     u64 signalled_tick{};
+    /// Command timing statistics per session, only recorded into when enabled in the settings
+    std::array<CommandTimingStatistics, MaxRendererSessions> command_timing_statistics{};
 };
 
 /**
@@ -6,6 +6,10 @@
 #include <audio_core/common/common.h>
 #include <audio_core/common/common_types.h>
 
+namespace AudioCore::AudioRenderer {
+class ICommandProcessingTimeEstimator;
+}
+
 namespace AudioCore::AudioRenderer::ADSP {
 
 struct CommandBuffer {
@@ -16,6 +20,7 @@ struct CommandBuffer {
     bool reset_buffers;
     u64 applet_resource_user_id;
     u64 render_time_taken;
+    ICommandProcessingTimeEstimator* time_estimator;
 };
 
 } // namespace AudioCore::AudioRenderer::ADSP
@@ -1,10 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
 #include <string>
 
 #include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/adsp/command_timing_statistics.h>
 #include <audio_core/renderer/command/command_list_header.h>
+#include <audio_core/renderer/command/command_processing_time_estimator.h>
 #include <audio_core/renderer/command/commands.h>
 #include <audio_core/common/settings.h>
 #include <core/core.h>
@@ -15,10 +18,16 @@
 namespace AudioCore::AudioRenderer::ADSP {
 
 void CommandListProcessor::Initialize(Core::System& system_, CpuAddr buffer, u64 size,
-                                      Sink::SinkStream* stream_) {
+                                      Sink::SinkStream* stream_,
+                                      ICommandProcessingTimeEstimator* time_estimator_,
+                                      CommandTimingStatistics* statistics_) {
     system = &system_;
     memory = &system->Memory();
     stream = stream_;
+    time_estimator = time_estimator_ != nullptr && time_estimator_->WantsProcessTimes()
+                         ? time_estimator_
+                         : nullptr;
+    timing_statistics = statistics_;
     header = reinterpret_cast<CommandListHeader*>(buffer);
     commands = reinterpret_cast<u8*>(buffer + sizeof(CommandListHeader));
     commands_buffer_size = size;
@@ -28,6 +37,9 @@ void CommandListProcessor::Initialize(Core::System& system_, CpuAddr buffer, u64
     mix_buffers = header->samples_buffer;
     buffer_count = header->buffer_count;
     processed_command_count = 0;
+
+    // Mix buffers keep whatever the last list left in them, nothing is known until they're cleared.
+    silent_mix_buffers.assign(buffer_count, false);
 }
 
 void CommandListProcessor::SetProcessTimeMax(const u64 time) {
@@ -47,6 +59,74 @@ Sink::SinkStream* CommandListProcessor::GetOutputSinkStream() const {
     return stream;
 }
 
+bool CommandListProcessor::IsMixBufferSilent(const s32 index) const {
+    if (!silence_tracking || index < 0 || index >= static_cast<s32>(silent_mix_buffers.size())) {
+        return false;
+    }
+    return silent_mix_buffers[index];
+}
+
+void CommandListProcessor::SetMixBufferSilent(const s32 index, const bool silent) const {
+    if (index < 0 || index >= static_cast<s32>(silent_mix_buffers.size())) {
+        return;
+    }
+    silent_mix_buffers[index] = silent;
+}
+
+void CommandListProcessor::SetAllMixBuffersSilent(const bool silent) const {
+    std::fill(silent_mix_buffers.begin(), silent_mix_buffers.end(), silent);
+}
+
+bool CommandListProcessor::UpdateMixBufferSilence(const s32 index) const {
+    if (index < 0 || index >= static_cast<s32>(silent_mix_buffers.size())) {
+        return false;
+    }
+
+    const auto buffer{mix_buffers.subspan(index * sample_count, sample_count)};
+    const bool silent{silence_tracking &&
+                      std::all_of(buffer.begin(), buffer.end(), [](s32 x) { return x == 0; })};
+    silent_mix_buffers[index] = silent;
+    return silent;
+}
+
+void CommandListProcessor::SilenceMixBuffer(const s32 index) const {
+    if (index < 0 || index >= static_cast<s32>(silent_mix_buffers.size()) ||
+        IsMixBufferSilent(index)) {
+        return;
+    }
+
+    const auto buffer{mix_buffers.subspan(index * sample_count, sample_count)};
+    std::fill(buffer.begin(), buffer.end(), 0);
+    SetMixBufferSilent(index, true);
+}
+
+bool CommandListProcessor::AreMixBuffersSilent(std::span<const s16> indexes) const {
+    return std::all_of(indexes.begin(), indexes.end(),
+                       [this](s16 index) { return IsMixBufferSilent(index); });
+}
+
+void CommandListProcessor::UpdateEffectOutputSilence(std::span<const s16> inputs,
+                                                     std::span<const s16> outputs,
+                                                     const bool enabled) const {
+    for (size_t i = 0; i < outputs.size(); i++) {
+        SetMixBufferSilent(outputs[i], !enabled && IsMixBufferSilent(inputs[i]));
+    }
+}
+
+void CommandListProcessor::MarkSilentShortCircuit() const {
+    silent_short_circuit = true;
+}
+
+void CommandListProcessor::RecordCommandTime(const ICommand& command,
+                                             const std::chrono::nanoseconds time) const {
+    if (time_estimator != nullptr && !silent_short_circuit) {
+        time_estimator->RecordProcessTime(command, time);
+    }
+    if (timing_statistics != nullptr) {
+        timing_statistics->Record(command, time);
+    }
+}
+
 u64 CommandListProcessor::Process(u32 session_id) {
     const auto start_time_{system->CoreTiming().GetClockTicks()};
     const auto command_base{CpuAddr(commands)};
@@ -59,6 +139,7 @@ u64 CommandListProcessor::Process(u32 session_id) {
     }
 
     std::string dump{fmt::format("\nSession {}\n", session_id)};
+    const bool measure_commands{time_estimator != nullptr || timing_statistics != nullptr};
 
     for (u32 index = 0; index < command_count; index++) {
         auto& command{*reinterpret_cast<ICommand*>(commands)};
@@ -88,7 +169,14 @@ u64 CommandListProcessor::Process(u32 session_id) {
         }
 
         if (command.enabled) {
-            command.Process(*this);
+            if (measure_commands) {
+                silent_short_circuit = false;
+                const auto command_start{Core::Timing::GetClockNs()};
+                command.Process(*this);
+                RecordCommandTime(command, Core::Timing::GetClockNs() - command_start);
+            } else {
+                command.Process(*this);
+            }
         } else {
             dump += fmt::format("\tDisabled!\n");
         }
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <chrono>
 #include <span>
+#include <vector>
 
 #include <audio_core/common/common.h>
 #include <audio_core/common/common_types.h>
@@ -22,8 +24,11 @@ class SinkStream;
 
 namespace AudioRenderer {
 struct CommandListHeader;
+class ICommandProcessingTimeEstimator;
+struct ICommand;
 
 namespace ADSP {
+class CommandTimingStatistics;
 
 /**
  * A processor for command lists given to the AudioRenderer.
@@ -33,12 +38,17 @@ public:
     /**
      * Initialize the processor.
      *
-     * @param system - The core system.
-     * @param buffer - The command buffer to process.
-     * @param size   - The size of the buffer.
-     * @param stream - The stream to be used for sending the samples.
+     * @param system         - The core system.
+     * @param buffer         - The command buffer to process.
+     * @param size           - The size of the buffer.
+     * @param stream         - The stream to be used for sending the samples.
+     * @param time_estimator - Estimator to report measured command times to, if it wants them.
+     *                         May be nullptr.
+     * @param statistics     - Statistics to record command times into. May be nullptr.
      */
-    void Initialize(Core::System& system, CpuAddr buffer, u64 size, Sink::SinkStream* stream);
+    void Initialize(Core::System& system, CpuAddr buffer, u64 size, Sink::SinkStream* stream,
+                    ICommandProcessingTimeEstimator* time_estimator,
+                    CommandTimingStatistics* statistics);
 
     /**
      * Set the maximum processing time for this command list.
@@ -69,6 +79,84 @@ public:
      */
     Sink::SinkStream* GetOutputSinkStream() const;
 
+    /**
+     * Check if a mix buffer is known to hold only zeroes.
+     *
+     * @param index - Mix buffer index to check.
+     * @return True if the buffer is silent, false if it is not or it is unknown.
+     */
+    bool IsMixBufferSilent(s32 index) const;
+
+    /**
+     * Record whether a mix buffer is known to hold only zeroes.
+     * Every command writing to a mix buffer must update this for that buffer, passing false if
+     * it does not know the result is silent.
+     *
+     * @param index  - Mix buffer index to update.
+     * @param silent - True if the buffer now holds only zeroes.
+     */
+    void SetMixBufferSilent(s32 index, bool silent) const;
+
+    /**
+     * Mark every mix buffer as silent or unknown.
+     *
+     * @param silent - True if all buffers now hold only zeroes.
+     */
+    void SetAllMixBuffersSilent(bool silent) const;
+
+    /**
+     * Scan a mix buffer and record whether it holds only zeroes.
+     *
+     * @param index - Mix buffer index to scan.
+     * @return True if the buffer is silent.
+     */
+    bool UpdateMixBufferSilence(s32 index) const;
+
+    /**
+     * Zero a mix buffer, unless it is already known to be silent, and mark it silent.
+     *
+     * @param index - Mix buffer index to silence.
+     */
+    void SilenceMixBuffer(s32 index) const;
+
+    /**
+     * Check if all of the given mix buffers are known to hold only zeroes.
+     *
+     * @param indexes - Mix buffer indexes to check.
+     * @return True if every buffer is silent.
+     */
+    bool AreMixBuffersSilent(std::span<const s16> indexes) const;
+
+    /**
+     * Update the silence of an effect's output buffers after it has run. A disabled effect copies
+     * its inputs through, so they keep their input's silence, an enabled one is assumed audible.
+     *
+     * @param inputs  - Input mix buffer indexes of the effect.
+     * @param outputs - Output mix buffer indexes of the effect, one per input.
+     * @param enabled - If the effect was enabled.
+     */
+    void UpdateEffectOutputSilence(std::span<const s16> inputs, std::span<const s16> outputs,
+                                   bool enabled) const;
+
+    /// Silent frames an effect waits between scans of its state for a played out tail, as each
+    /// scan reads every one of its delay lines
+    static constexpr u32 EffectTailCheckInterval{4};
+
+    /**
+     * Note that the command being processed skipped its work because its input was silent.
+     * Its time is then not given to the estimator, as it says nothing about the command's cost.
+     */
+    void MarkSilentShortCircuit() const;
+
+    /**
+     * Report the time taken by a command to the estimator and statistics, where present.
+     * Silent short-circuited runs only go to the statistics.
+     *
+     * @param command - The command which was processed.
+     * @param time    - Time taken to process it.
+     */
+    void RecordCommandTime(const ICommand& command, std::chrono::nanoseconds time) const;
+
     /**
      * Process the command list.
      *
@@ -84,6 +172,10 @@ public:
     Core::Memory::Memory* memory{};
     /// Stream for the processed samples
     Sink::SinkStream* stream{};
+    /// Estimator receiving the measured time of each command, may be nullptr
+    ICommandProcessingTimeEstimator* time_estimator{};
+    /// Per-command timing statistics, may be nullptr
+    CommandTimingStatistics* timing_statistics{};
     /// Header info for this command list
     CommandListHeader* header{};
     /// The command buffer
@@ -110,6 +202,13 @@ public:
     u64 current_processing_time{};
     /// The end processing time for this list
     u64 end_time{};
+    /// Per mix buffer, true if the buffer is known to hold only zeroes. Updated by the commands,
+    /// which only get a const processor.
+    mutable std::vector<bool> silent_mix_buffers{};
+    /// If false, no buffer is ever known to be silent, so every command does its full work
+    bool silence_tracking{true};
+    /// Did the command being processed skip its work on silent input? See MarkSilentShortCircuit
+    mutable bool silent_short_circuit{};
     /// Last command list string generated, used for dumping audio commands to console
     std::string last_dump{};
 };
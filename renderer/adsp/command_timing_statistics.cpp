@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+
+#include <audio_core/renderer/adsp/command_timing_statistics.h>
+
+namespace AudioCore::AudioRenderer::ADSP {
+
+void CommandTimingStatistics::Record(const ICommand& command, std::chrono::nanoseconds time) {
+    const auto ns{static_cast<u64>(std::max<s64>(time.count(), 0))};
+    constexpr auto order{std::memory_order_relaxed};
+
+    histograms[static_cast<u32>(command.type)].Record(ns);
+
+    // Only the AudioRenderer thread writes, so plain loads and stores are enough.
+    NodeEntry* smallest{&nodes[0]};
+    for (auto& node : nodes) {
+        const auto node_count{node.count.load(order)};
+        if (node_count != 0 && node.node_id.load(order) == command.node_id) {
+            node.count.store(node_count + 1, order);
+            node.total.store(node.total.load(order) + ns, order);
+            return;
+        }
+        if (node.total.load(order) < smallest->total.load(order) || node_count == 0) {
+            smallest = &node;
+        }
+    }
+
+    // Untracked node, take over the cheapest entry. Its total is kept so a new node can't
+    // immediately push out an expensive one, it overestimates the newcomer at worst.
+    smallest->node_id.store(command.node_id, order);
+    smallest->count.store(1, order);
+    smallest->total.store(smallest->total.load(order) + ns, order);
+}
+
+CommandTimingReport CommandTimingStatistics::GetReport() const {
+    constexpr auto order{std::memory_order_relaxed};
+    CommandTimingReport report{};
+
+    for (u32 type = 0; type < CommandTypeCount; type++) {
+        const auto histogram{histograms[type].GetSnapshot()};
+        if (histogram.count == 0) {
+            continue;
+        }
+
+        report.commands.push_back({
+            .type{static_cast<CommandId>(type)},
+            .count{histogram.count},
+            .p50{std::chrono::nanoseconds(histogram.Percentile(50))},
+            .p99{std::chrono::nanoseconds(histogram.Percentile(99))},
+            .max{std::chrono::nanoseconds(histogram.max)},
+        });
+    }
+
+    for (const auto& node : nodes) {
+        const auto count{node.count.load(order)};
+        if (count == 0) {
+            continue;
+        }
+        report.nodes.push_back({
+            .node_id{node.node_id.load(order)},
+            .count{count},
+            .total{std::chrono::nanoseconds(node.total.load(order))},
+        });
+    }
+    std::ranges::sort(report.nodes, [](const auto& a, const auto& b) { return a.total > b.total; });
+
+    return report;
+}
+
+void CommandTimingStatistics::RequestReset() {
+    reset_requested.store(true, std::memory_order_release);
+}
+
+void CommandTimingStatistics::ApplyPendingReset() {
+    if (!reset_requested.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+
+    constexpr auto order{std::memory_order_relaxed};
+    for (auto& histogram : histograms) {
+        histogram.Reset();
+    }
+    for (auto& node : nodes) {
+        node.node_id.store(0, order);
+        node.count.store(0, order);
+        node.total.store(0, order);
+    }
+}
+
+} // namespace AudioCore::AudioRenderer::ADSP
@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include <audio_core/renderer/command/icommand.h>
+#include <audio_core/common/common_types.h>
+#include <audio_core/common/log_histogram.h>
+
+namespace AudioCore::AudioRenderer::ADSP {
+
+/**
+ * Timing summary of one command type.
+ */
+struct CommandTimingSummary {
+    /// Type of command summarised
+    CommandId type;
+    /// Number of times the command was processed
+    u64 count;
+    /// Median processing time
+    std::chrono::nanoseconds p50;
+    /// 99th percentile processing time
+    std::chrono::nanoseconds p99;
+    /// Longest processing time
+    std::chrono::nanoseconds max;
+};
+
+/**
+ * Timing summary of one node (voice, mix, sink etc), across all of its commands.
+ */
+struct NodeTimingSummary {
+    /// Node id commands were generated for
+    u32 node_id;
+    /// Number of commands processed for this node
+    u64 count;
+    /// Total processing time of those commands
+    std::chrono::nanoseconds total;
+};
+
+/**
+ * Timing report for one AudioRenderer session.
+ */
+struct CommandTimingReport {
+    /// Per command type summaries, only types which were processed are included
+    std::vector<CommandTimingSummary> commands;
+    /// Nodes taking the most processing time, most expensive first
+    std::vector<NodeTimingSummary> nodes;
+};
+
+/**
+ * Histograms of the time taken to process each type of command, and the nodes taking the most
+ * time overall. Written only by the AudioRenderer thread, and may be read from any thread.
+ */
+class CommandTimingStatistics {
+public:
+    /**
+     * Record the time taken to process a command.
+     * Must only be called from the AudioRenderer thread.
+     *
+     * @param command - The command which was processed.
+     * @param time    - Time taken to process it.
+     */
+    void Record(const ICommand& command, std::chrono::nanoseconds time);
+
+    /**
+     * Summarise the recorded times.
+     *
+     * @return The timing report.
+     */
+    CommandTimingReport GetReport() const;
+
+    /**
+     * Request the recorded times be cleared. May be called from any thread, the clear happens
+     * on the AudioRenderer thread at the start of its next frame, in ApplyPendingReset.
+     */
+    void RequestReset();
+
+    /**
+     * Clear all recorded times if a reset was requested.
+     * Must only be called from the AudioRenderer thread, outside of Record.
+     */
+    void ApplyPendingReset();
+
+private:
+    /// ~25% resolution, covering times up to 2^32ns, longer times land in the last bucket
+    using Histogram = Common::LogHistogram<2, 32>;
+    /// Number of possible command types
+    static constexpr size_t CommandTypeCount{std::numeric_limits<u8>::max() + 1};
+    /// Number of most expensive nodes tracked
+    static constexpr size_t TrackedNodeCount{16};
+
+    struct NodeEntry {
+        std::atomic<u32> node_id{};
+        std::atomic<u64> count{};
+        std::atomic<u64> total{};
+    };
+
+    /// Histogram per command type
+    std::array<Histogram, CommandTypeCount> histograms{};
+    /// Most expensive nodes, replaced with a space-saving scheme when full
+    std::array<NodeEntry, TrackedNodeCount> nodes{};
+    /// Set by RequestReset, cleared by the AudioRenderer thread once the times are cleared
+    std::atomic<bool> reset_requested{};
+};
+
+} // namespace AudioCore::AudioRenderer::ADSP
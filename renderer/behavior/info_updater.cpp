@@ -174,6 +174,11 @@ Result InfoUpdater::UpdateEffectsVersion1(EffectContext& effect_context, const b
             behaviour.AppendError(error_info);
         }
 
+        if (effect_info->GetHostBufferSize() > effect_info->GetHostBuffer().size()) {
+            effect_info->SetHostBuffer(
+                effect_context.GetHostBuffer(i, effect_info->GetHostBufferSize()));
+        }
+
         effect_info->StoreStatus(out_params[i], renderer_active);
     }
 
@@ -222,6 +227,11 @@ Result InfoUpdater::UpdateEffectsVersion2(EffectContext& effect_context, const b
             behaviour.AppendError(error_info);
         }
 
+        if (effect_info->GetHostBufferSize() > effect_info->GetHostBuffer().size()) {
+            effect_info->SetHostBuffer(
+                effect_context.GetHostBuffer(i, effect_info->GetHostBufferSize()));
+        }
+
         effect_info->StoreStatus(out_params[i], renderer_active);
 
         if (in_params[i].is_new) {
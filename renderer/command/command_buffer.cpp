@@ -196,6 +196,40 @@ void CommandBuffer::GenerateAdpcmVersion2Command(const s32 node_id, VoiceInfo& v
     GenerateEnd<AdpcmDataSourceVersion2Command>(cmd);
 }
 
+void CommandBuffer::GenerateAdvanceVoicePositionCommand(const s32 node_id, VoiceInfo& voice_info,
+                                                        const VoiceState& voice_state,
+                                                        const s8 channel,
+                                                        const bool wave_buffer_version1,
+                                                        const s16 previous_sample_count) {
+    auto& cmd{GenerateStart<AdvanceVoicePositionCommand, CommandId::AdvanceVoicePosition>(node_id)};
+
+    cmd.sample_format = voice_info.sample_format;
+    cmd.src_quality = voice_info.src_quality;
+    cmd.flags = voice_info.flags & 3;
+    cmd.sample_rate = voice_info.sample_rate;
+    cmd.pitch = voice_info.pitch;
+    cmd.channel_index = channel;
+    cmd.channel_count = voice_info.channel_count;
+    cmd.wave_buffer_version1 = wave_buffer_version1;
+
+    for (u32 i = 0; i < MaxWaveBuffers; i++) {
+        voice_info.wavebuffers[i].Copy(cmd.wave_buffers[i]);
+    }
+
+    cmd.voice_state = memory_pool->Translate(CpuAddr(&voice_state), sizeof(VoiceState));
+    cmd.previous_sample_count = previous_sample_count;
+
+    if (voice_info.sample_format == SampleFormat::Adpcm) {
+        cmd.data_address = voice_info.data_address.GetReference(true);
+        cmd.data_size = voice_info.data_address.GetSize();
+    } else {
+        cmd.data_address = 0;
+        cmd.data_size = 0;
+    }
+
+    GenerateEnd<AdvanceVoicePositionCommand>(cmd);
+}
+
 void CommandBuffer::GenerateVolumeCommand(const s32 node_id, const s16 buffer_offset,
                                           const s16 input_index, const f32 volume,
                                           const u8 precision) {
@@ -237,7 +271,8 @@ void CommandBuffer::GenerateBiquadFilterCommand(const s32 node_id, VoiceInfo& vo
     cmd.state = memory_pool->Translate(CpuAddr(voice_state.biquad_states[biquad_index].data()),
                                        MaxBiquadFilters * sizeof(VoiceState::BiquadFilterState));
 
-    cmd.needs_init = !voice_info.biquad_initialized[biquad_index];
+    cmd.needs_init =
+        !voice_info.biquad_initialized[biquad_index] || voice_info.biquad_stale[channel];
     cmd.use_float_processing = use_float_processing;
 
     GenerateEnd<BiquadFilterCommand>(cmd);
@@ -269,6 +304,36 @@ void CommandBuffer::GenerateBiquadFilterCommand(const s32 node_id, EffectInfoBas
     GenerateEnd<BiquadFilterCommand>(cmd);
 }
 
+void CommandBuffer::GenerateMultiChannelBiquadFilterCommand(const s32 node_id,
+                                                            EffectInfoBase& effect_info,
+                                                            const s16 buffer_offset,
+                                                            const bool needs_init,
+                                                            const bool use_float_processing) {
+    auto& cmd{GenerateStart<MultiChannelBiquadFilterCommand, CommandId::MultiChannelBiquadFilter>(
+        node_id)};
+
+    const auto& parameter{
+        *reinterpret_cast<BiquadFilterInfo::ParameterVersion1*>(effect_info.GetParameter())};
+
+    cmd.channel_count = static_cast<u8>(parameter.channel_count);
+    for (u32 channel = 0; channel < cmd.channel_count; channel++) {
+        const auto state{reinterpret_cast<VoiceState::BiquadFilterState*>(
+            effect_info.GetStateBuffer() + channel * sizeof(VoiceState::BiquadFilterState))};
+
+        cmd.inputs[channel] = buffer_offset + parameter.inputs[channel];
+        cmd.outputs[channel] = buffer_offset + parameter.outputs[channel];
+        cmd.states[channel] = memory_pool->Translate(
+            CpuAddr(state), MaxBiquadFilters * sizeof(VoiceState::BiquadFilterState));
+    }
+
+    cmd.b = parameter.b;
+    cmd.a = parameter.a;
+    cmd.needs_init = needs_init;
+    cmd.use_float_processing = use_float_processing;
+
+    GenerateEnd<MultiChannelBiquadFilterCommand>(cmd);
+}
+
 void CommandBuffer::GenerateMixCommand(const s32 node_id, const s16 input_index,
                                        const s16 output_index, const s16 buffer_offset,
                                        const f32 volume, const u8 precision) {
@@ -381,6 +446,9 @@ void CommandBuffer::GenerateDelayCommand(const s32 node_id, EffectInfoBase& effe
             cmd.effect_enabled = effect_info.IsEnabled();
             cmd.state = state_buffer;
             cmd.workbuffer = effect_info.GetWorkbuffer(-1);
+            cmd.workbuffer_size = effect_info.GetSingleBufferSize();
+            cmd.host_buffer = CpuAddr(effect_info.GetHostBuffer().data());
+            cmd.host_buffer_size = effect_info.GetHostBuffer().size();
         }
     }
 
@@ -662,8 +730,8 @@ void CommandBuffer::GenerateMultitapBiquadFilterCommand(const s32 node_id, Voice
         memory_pool->Translate(CpuAddr(voice_state.biquad_states[1].data()),
                                MaxBiquadFilters * sizeof(VoiceState::BiquadFilterState));
 
-    cmd.needs_init[0] = !voice_info.biquad_initialized[0];
-    cmd.needs_init[1] = !voice_info.biquad_initialized[1];
+    cmd.needs_init[0] = !voice_info.biquad_initialized[0] || voice_info.biquad_stale[channel];
+    cmd.needs_init[1] = !voice_info.biquad_initialized[1] || voice_info.biquad_stale[channel];
     cmd.filter_tap_count = MaxBiquadFilters;
 
     GenerateEnd<MultiTapBiquadFilterCommand>(cmd);
@@ -111,6 +111,22 @@ public:
     void GenerateAdpcmVersion2Command(s32 node_id, VoiceInfo& voice_info,
                                       const VoiceState& voice_state, s16 buffer_count, s8 channel);
 
+    /**
+     * Generate an advance voice position command, adding it to the command list.
+     * Used in place of a data source command for voices which cannot be heard.
+     *
+     * @param node_id               - Node id of the voice this command is generated for.
+     * @param voice_info            - The voice info this command is generated from.
+     * @param voice_state           - The voice state the DSP will use for this command.
+     * @param channel               - Channel index for this command.
+     * @param wave_buffer_version1  - Are the voice's wavebuffers version 1?
+     * @param previous_sample_count - Number of depop previous samples to reset.
+     */
+    void GenerateAdvanceVoicePositionCommand(s32 node_id, VoiceInfo& voice_info,
+                                             const VoiceState& voice_state, s8 channel,
+                                             bool wave_buffer_version1,
+                                             s16 previous_sample_count);
+
     /**
      * Generate a volume command, adding it to the command list.
      *
@@ -164,6 +180,21 @@ public:
     void GenerateBiquadFilterCommand(s32 node_id, EffectInfoBase& effect_info, s16 buffer_offset,
                                      s8 channel, bool needs_init, bool use_float_processing);
 
+    /**
+     * Generate a multi-channel biquad filter effect command, adding it to the command list.
+     * Filters every channel of the effect in one command.
+     *
+     * @param node_id              - Node id of the voice this command is generated for.
+     * @param effect_info          - The effect info this command takes biquad parameters from.
+     * @param buffer_offset        - Mix buffer offset this command will use,
+     *                               channels will generate at this index + their input/output.
+     * @param needs_init           - True if the biquad states need initialisation.
+     * @param use_float_processing - Should int or float processing be used?
+     */
+    void GenerateMultiChannelBiquadFilterCommand(s32 node_id, EffectInfoBase& effect_info,
+                                                 s16 buffer_offset, bool needs_init,
+                                                 bool use_float_processing);
+
     /**
      * Generate a mix command, adding it to the command list.
      *
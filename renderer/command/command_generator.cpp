@@ -6,6 +6,7 @@
 #include <audio_core/renderer/command/command_buffer.h>
 #include <audio_core/renderer/command/command_generator.h>
 #include <audio_core/renderer/command/command_list_header.h>
+#include <audio_core/renderer/command/effect/multi_channel_biquad_filter.h>
 #include <audio_core/renderer/effect/aux_.h>
 #include <audio_core/renderer/effect/biquad_filter.h>
 #include <audio_core/renderer/effect/buffer_mixer.h>
@@ -38,7 +39,9 @@ CommandGenerator::CommandGenerator(CommandBuffer& command_buffer_,
 }
 
 void CommandGenerator::GenerateDataSourceCommand(VoiceInfo& voice_info,
-                                                 const VoiceState& voice_state, const s8 channel) {
+                                                 const VoiceState& voice_state, const s8 channel,
+                                                 const bool audible,
+                                                 const s16 previous_sample_count) {
     if (voice_info.mix_id == UnusedMixId) {
         if (voice_info.splitter_id != UnusedSplitterId) {
             auto destination{splitter_context.GetDesintationData(voice_info.splitter_id, 0)};
@@ -69,6 +72,13 @@ void CommandGenerator::GenerateDataSourceCommand(VoiceInfo& voice_info,
         return;
     }
 
+    if (!audible) {
+        command_buffer.GenerateAdvanceVoicePositionCommand(
+            voice_info.node_id, voice_info, voice_state, channel,
+            !render_context.behavior->IsWaveBufferVer2Supported(), previous_sample_count);
+        return;
+    }
+
     if (render_context.behavior->IsWaveBufferVer2Supported()) {
         switch (voice_info.sample_format) {
         case SampleFormat::PcmInt16:
@@ -115,6 +125,118 @@ void CommandGenerator::GenerateDataSourceCommand(VoiceInfo& voice_info,
     }
 }
 
+bool CommandGenerator::IsMixSilent(MixInfo& mix_info, const u32 depth) {
+    // The final mix is always heard, and effects may keep a tail or hand their input to the game.
+    if (mix_info.mix_id == FinalMixId || depth >= static_cast<u32>(mix_context.GetCount())) {
+        return false;
+    }
+    const auto effect_count{effect_context.GetCount()};
+    for (u32 i = 0; i < effect_count; i++) {
+        const auto effect_index{mix_info.effect_order_buffer[i]};
+        if (effect_index == -1) {
+            break;
+        }
+        if (!effect_context.GetInfo(effect_index).ShouldSkip()) {
+            return false;
+        }
+    }
+
+    // Unused mixes aren't generated, and mix commands are only generated for non-zero volumes.
+    if (!mix_info.in_use || !mix_info.HasAnyConnection() || mix_info.volume == 0.0f) {
+        return true;
+    }
+
+    if (mix_info.dst_mix_id != UnusedMixId) {
+        auto dest_mix_info{mix_context.GetInfo(mix_info.dst_mix_id)};
+        if (IsMixSilent(*dest_mix_info, depth + 1)) {
+            return true;
+        }
+        for (s16 i = 0; i < mix_info.buffer_count; i++) {
+            for (s16 j = 0; j < dest_mix_info->buffer_count; j++) {
+                if (mix_info.mix_volumes[i][j] != 0.0f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    s16 dest_id{0};
+    auto destination{splitter_context.GetDesintationData(mix_info.dst_splitter_id, dest_id)};
+    while (destination != nullptr) {
+        if (destination->IsConfigured()) {
+            const auto mix_id{destination->GetMixId()};
+            if (mix_id < mix_context.GetCount()) {
+                auto dest_mix_info{mix_context.GetInfo(mix_id)};
+                if (!IsMixSilent(*dest_mix_info, depth + 1)) {
+                    for (s16 i = 0; i < dest_mix_info->buffer_count; i++) {
+                        if (destination->GetMixVolume(i) != 0.0f) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        dest_id++;
+        destination = splitter_context.GetDesintationData(mix_info.dst_splitter_id, dest_id);
+    }
+    return true;
+}
+
+bool CommandGenerator::IsVoiceChannelAudible(VoiceInfo& voice_info,
+                                             const VoiceChannelResource& channel_resource,
+                                             const s8 channel, s16& previous_sample_count) {
+    previous_sample_count = 0;
+
+    if (!voice_info.HasAnyConnection()) {
+        return false;
+    }
+
+    const bool voice_silent{voice_info.volume == 0.0f && voice_info.prev_volume == 0.0f};
+    const auto mix_silent = [this, voice_silent](MixInfo& mix_info, std::span<const f32> volumes,
+                                                 std::span<const f32> prev_volumes,
+                                                 const s16 count) {
+        if (voice_silent || IsMixSilent(mix_info)) {
+            return true;
+        }
+        for (s16 i = 0; i < count; i++) {
+            if (volumes[i] != 0.0f || prev_volumes[i] != 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (voice_info.mix_id != UnusedMixId) {
+        auto mix_info{mix_context.GetInfo(voice_info.mix_id)};
+        if (!mix_silent(*mix_info, channel_resource.mix_volumes,
+                        channel_resource.prev_mix_volumes, mix_info->buffer_count)) {
+            return true;
+        }
+        previous_sample_count = mix_info->buffer_count;
+        return false;
+    }
+
+    auto i{channel};
+    auto destination{splitter_context.GetDesintationData(voice_info.splitter_id, i)};
+    while (destination != nullptr) {
+        if (destination->IsConfigured()) {
+            const auto mix_id{destination->GetMixId()};
+            if (mix_id < mix_context.GetCount() && static_cast<s32>(mix_id) != UnusedSplitterId) {
+                auto mix_info{mix_context.GetInfo(mix_id)};
+                if (!mix_silent(*mix_info, destination->GetMixVolume(),
+                                destination->GetMixVolumePrev(), mix_info->buffer_count)) {
+                    return true;
+                }
+                previous_sample_count = std::max(previous_sample_count, mix_info->buffer_count);
+            }
+        }
+        i += voice_info.channel_count;
+        destination = splitter_context.GetDesintationData(voice_info.splitter_id, i);
+    }
+    return false;
+}
+
 void CommandGenerator::GenerateVoiceMixCommand(std::span<const f32> mix_volumes,
                                                std::span<const f32> prev_mix_volumes,
                                                const VoiceState& voice_state, s16 output_index,
@@ -189,9 +311,14 @@ void CommandGenerator::GenerateVoiceCommand(VoiceInfo& voice_info) {
             break;
         }
 
+        s16 previous_sample_count{0};
+        const bool audible{
+            IsVoiceChannelAudible(voice_info, channel_resource, channel, previous_sample_count)};
+
         DetailAspect data_source_detail(*this, PerformanceEntryType::Voice, voice_info.node_id,
                                         detail_type);
-        GenerateDataSourceCommand(voice_info, voice_state, channel);
+        GenerateDataSourceCommand(voice_info, voice_state, channel, audible,
+                                  previous_sample_count);
 
         if (data_source_detail.initialized) {
             command_buffer.GeneratePerformanceCommand(data_source_detail.node_id,
@@ -208,10 +335,37 @@ void CommandGenerator::GenerateVoiceCommand(VoiceInfo& voice_info) {
             continue;
         }
 
+        if (!audible) {
+            // Only the position was advanced, skip the filter, volume and mix commands but keep
+            // the volumes moving as if they had run. The filters have no history of the skipped
+            // samples, so they restart from silence once the channel is audible again.
+            voice_info.biquad_stale[channel] = true;
+            voice_info.prev_volume = voice_info.volume;
+            if (voice_info.mix_id == UnusedMixId) {
+                auto i{channel};
+                auto destination{splitter_context.GetDesintationData(voice_info.splitter_id, i)};
+                while (destination != nullptr) {
+                    if (destination->IsConfigured()) {
+                        const auto mix_id{destination->GetMixId()};
+                        if (mix_id < mix_context.GetCount() &&
+                            static_cast<s32>(mix_id) != UnusedSplitterId) {
+                            destination->MarkAsNeedToUpdateInternalState();
+                        }
+                    }
+                    i += voice_info.channel_count;
+                    destination = splitter_context.GetDesintationData(voice_info.splitter_id, i);
+                }
+            } else {
+                channel_resource.prev_mix_volumes = channel_resource.mix_volumes;
+            }
+            continue;
+        }
+
         DetailAspect biquad_detail_aspect(*this, PerformanceEntryType::Voice, voice_info.node_id,
                                           PerformanceDetailType::Unk4);
         GenerateBiquadFilterCommandForVoice(
             voice_info, voice_state, render_context.mix_buffer_count, channel, voice_info.node_id);
+        voice_info.biquad_stale[channel] = false;
 
         if (biquad_detail_aspect.initialized) {
             command_buffer.GeneratePerformanceCommand(
@@ -384,10 +538,16 @@ void CommandGenerator::GenerateBiquadFilterEffectCommand(const s16 buffer_offset
             break;
         }
 
-        for (s8 channel = 0; channel < parameter.channel_count; channel++) {
-            command_buffer.GenerateBiquadFilterCommand(
-                node_id, effect_info, buffer_offset, channel, needs_init,
-                render_context.behavior->UseBiquadFilterFloatProcessing());
+        const auto use_float_processing{render_context.behavior->UseBiquadFilterFloatProcessing()};
+        if (CanFilterBiquadChannelsTogether(parameter)) {
+            command_buffer.GenerateMultiChannelBiquadFilterCommand(
+                node_id, effect_info, buffer_offset, needs_init, use_float_processing);
+        } else {
+            for (s8 channel = 0; channel < parameter.channel_count; channel++) {
+                command_buffer.GenerateBiquadFilterCommand(node_id, effect_info, buffer_offset,
+                                                           channel, needs_init,
+                                                           use_float_processing);
+            }
         }
     } else {
         for (s8 channel = 0; channel < parameter.channel_count; channel++) {
@@ -22,6 +22,7 @@ class SplitterContext;
 class SinkContext;
 class BehaviorInfo;
 class VoiceInfo;
+class VoiceChannelResource;
 struct VoiceState;
 class MixInfo;
 class SinkInfoBase;
@@ -112,13 +113,46 @@ public:
     /**
      * Generate a data source command.
      * These are the basis for all audio output.
+     * Inaudible voices only have their position advanced, without decoding any output.
      *
-     * @param voice_info  - Generate the command from this voice.
-     * @param voice_state - State used by the AudioRenderer across calls.
-     * @param channel     - Channel index to generate the command into.
+     * @param voice_info            - Generate the command from this voice.
+     * @param voice_state           - State used by the AudioRenderer across calls.
+     * @param channel               - Channel index to generate the command into.
+     * @param audible               - Can this channel be heard?
+     * @param previous_sample_count - For inaudible channels, the number of depop previous
+     *                                samples the skipped mix commands would have reset.
      */
     void GenerateDataSourceCommand(VoiceInfo& voice_info, const VoiceState& voice_state,
-                                   s8 channel);
+                                   s8 channel, bool audible, s16 previous_sample_count);
+
+    /**
+     * Check if a voice channel can be heard this frame.
+     * A channel is inaudible when it has no connection, or when both its current and previous
+     * voice volumes, or all of its current and previous mix volumes, are zero, or when the mixes
+     * it reaches are silent.
+     *
+     * @param voice_info            - Voice info to check.
+     * @param channel_resource      - Channel resource holding this channel's mix volumes.
+     * @param channel               - Channel index to check.
+     * @param previous_sample_count - Output, the number of depop previous samples the channel's
+     *                                mix commands would reset if it is inaudible.
+     * @return True if the channel can be heard, otherwise false.
+     */
+    bool IsVoiceChannelAudible(VoiceInfo& voice_info, const VoiceChannelResource& channel_resource,
+                               s8 channel, s16& previous_sample_count);
+
+    /**
+     * Check if nothing mixed into a submix this frame can be heard.
+     * A submix is silent when it has no effects to process, and it's unused, unconnected, has a
+     * volume of zero, or all of its destinations either have zero volumes or are silent too.
+     * Submix volumes aren't ramped, so a voice mixed only into silent submixes can be advanced
+     * without changing the output, other than the depop of a voice stopped meanwhile.
+     *
+     * @param mix_info - Mix to check.
+     * @param depth    - Number of mixes already followed to reach this one.
+     * @return True if the mix is silent, otherwise false.
+     */
+    bool IsMixSilent(MixInfo& mix_info, u32 depth = 0);
 
     /**
      * Generate voice mixing commands.
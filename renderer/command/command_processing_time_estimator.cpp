@@ -1,10 +1,44 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
+
 #include <audio_core/renderer/command/command_processing_time_estimator.h>
 
 namespace AudioCore::AudioRenderer {
 
+/**
+ * Estimate an AdvanceVoicePositionCommand. PCM voices are skipped over, costing about as much as a
+ * DepopPrepareCommand, while ADPCM voices still decode to keep their context in sync.
+ *
+ * @param estimator - Estimator for the renderer version in use.
+ * @param command   - Command to estimate.
+ * @return Estimated processing time.
+ */
+static u32 EstimateAdvanceVoicePosition(const ICommandProcessingTimeEstimator& estimator,
+                                        const AdvanceVoicePositionCommand& command) {
+    if (command.sample_format == SampleFormat::Adpcm) {
+        AdpcmDataSourceVersion2Command adpcm{};
+        adpcm.sample_rate = command.sample_rate;
+        adpcm.pitch = command.pitch;
+        return estimator.Estimate(adpcm);
+    }
+    return estimator.Estimate(DepopPrepareCommand{});
+}
+
+/**
+ * Estimate a MultiChannelBiquadFilterCommand, budgeted as the per-channel BiquadFilterCommands it
+ * replaces so voice dropping is unchanged.
+ *
+ * @param estimator - Estimator for the renderer version in use.
+ * @param command   - Command to estimate.
+ * @return Estimated processing time.
+ */
+static u32 EstimateMultiChannelBiquadFilter(const ICommandProcessingTimeEstimator& estimator,
+                                            const MultiChannelBiquadFilterCommand& command) {
+    return estimator.Estimate(BiquadFilterCommand{}) * command.channel_count;
+}
+
 u32 CommandProcessingTimeEstimatorVersion1::Estimate(
     const PcmInt16DataSourceVersion1Command& command) const {
     return static_cast<u32>(command.pitch * 0.25f * 1.2f);
@@ -172,6 +206,16 @@ u32 CommandProcessingTimeEstimatorVersion1::Estimate(
     return 0;
 }
 
+u32 CommandProcessingTimeEstimatorVersion1::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateMultiChannelBiquadFilter(*this, command);
+}
+
+u32 CommandProcessingTimeEstimatorVersion1::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdvanceVoicePosition(*this, command);
+}
+
 u32 CommandProcessingTimeEstimatorVersion2::Estimate(
     const PcmInt16DataSourceVersion1Command& command) const {
     switch (sample_count) {
@@ -758,6 +802,16 @@ u32 CommandProcessingTimeEstimatorVersion2::Estimate(
     return 0;
 }
 
+u32 CommandProcessingTimeEstimatorVersion2::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateMultiChannelBiquadFilter(*this, command);
+}
+
+u32 CommandProcessingTimeEstimatorVersion2::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdvanceVoicePosition(*this, command);
+}
+
 u32 CommandProcessingTimeEstimatorVersion3::Estimate(
     const PcmInt16DataSourceVersion1Command& command) const {
     switch (sample_count) {
@@ -1639,6 +1693,16 @@ u32 CommandProcessingTimeEstimatorVersion3::Estimate(
     return 0;
 }
 
+u32 CommandProcessingTimeEstimatorVersion3::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateMultiChannelBiquadFilter(*this, command);
+}
+
+u32 CommandProcessingTimeEstimatorVersion3::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdvanceVoicePosition(*this, command);
+}
+
 u32 CommandProcessingTimeEstimatorVersion4::Estimate(
     const PcmInt16DataSourceVersion1Command& command) const {
     switch (sample_count) {
@@ -2541,6 +2605,16 @@ u32 CommandProcessingTimeEstimatorVersion4::Estimate(
     return 0;
 }
 
+u32 CommandProcessingTimeEstimatorVersion4::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateMultiChannelBiquadFilter(*this, command);
+}
+
+u32 CommandProcessingTimeEstimatorVersion4::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdvanceVoicePosition(*this, command);
+}
+
 u32 CommandProcessingTimeEstimatorVersion5::Estimate(
     const PcmInt16DataSourceVersion1Command& command) const {
     switch (sample_count) {
@@ -3617,4 +3691,268 @@ u32 CommandProcessingTimeEstimatorVersion5::Estimate(const CompressorCommand& co
     }
 }
 
+u32 CommandProcessingTimeEstimatorVersion5::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateMultiChannelBiquadFilter(*this, command);
+}
+
+u32 CommandProcessingTimeEstimatorVersion5::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdvanceVoicePosition(*this, command);
+}
+
+/**
+ * Get the number of channels a command processes, which its cost scales with.
+ *
+ * @param command - Command to check.
+ * @return Number of channels, 1 for commands working on a single buffer.
+ */
+static u32 GetCommandChannelCount(const ICommand& command) {
+    const auto channel_count = [](const auto count) {
+        return static_cast<u32>(std::max<s64>(count, 1));
+    };
+
+    switch (command.type) {
+    case CommandId::DataSourcePcmInt16Version1:
+        return channel_count(
+            static_cast<const PcmInt16DataSourceVersion1Command&>(command).channel_count);
+    case CommandId::DataSourcePcmInt16Version2:
+        return channel_count(
+            static_cast<const PcmInt16DataSourceVersion2Command&>(command).channel_count);
+    case CommandId::DataSourcePcmFloatVersion1:
+        return channel_count(
+            static_cast<const PcmFloatDataSourceVersion1Command&>(command).channel_count);
+    case CommandId::DataSourcePcmFloatVersion2:
+        return channel_count(
+            static_cast<const PcmFloatDataSourceVersion2Command&>(command).channel_count);
+    case CommandId::DataSourceAdpcmVersion2:
+        return channel_count(
+            static_cast<const AdpcmDataSourceVersion2Command&>(command).channel_count);
+    case CommandId::AdvanceVoicePosition:
+        return channel_count(
+            static_cast<const AdvanceVoicePositionCommand&>(command).channel_count);
+    case CommandId::MixRampGrouped:
+        return channel_count(static_cast<const MixRampGroupedCommand&>(command).buffer_count);
+    case CommandId::DepopForMixBuffers:
+        return channel_count(static_cast<const DepopForMixBuffersCommand&>(command).count);
+    case CommandId::Upsample:
+        return channel_count(static_cast<const UpsampleCommand&>(command).buffer_count);
+    case CommandId::DeviceSink:
+        return channel_count(static_cast<const DeviceSinkCommand&>(command).input_count);
+    case CommandId::CircularBufferSink:
+        return channel_count(static_cast<const CircularBufferSinkCommand&>(command).input_count);
+    case CommandId::Delay:
+        return channel_count(
+            static_cast<const DelayCommand&>(command).parameter.channel_count);
+    case CommandId::Reverb:
+        return channel_count(
+            static_cast<const ReverbCommand&>(command).parameter.channel_count);
+    case CommandId::I3dl2Reverb:
+        return channel_count(
+            static_cast<const I3dl2ReverbCommand&>(command).parameter.channel_count);
+    case CommandId::LightLimiterVersion1:
+        return channel_count(
+            static_cast<const LightLimiterVersion1Command&>(command).parameter.channel_count);
+    case CommandId::LightLimiterVersion2:
+        return channel_count(
+            static_cast<const LightLimiterVersion2Command&>(command).parameter.channel_count);
+    case CommandId::Compressor:
+        return channel_count(
+            static_cast<const CompressorCommand&>(command).parameter.channel_count);
+    case CommandId::MultiChannelBiquadFilter:
+        return channel_count(
+            static_cast<const MultiChannelBiquadFilterCommand&>(command).channel_count);
+    default:
+        return 1;
+    }
+}
+
+size_t CommandProcessingTimeEstimatorAdaptive::GetKey(const ICommand& command) const {
+    const auto type{static_cast<size_t>(command.type)};
+    if (type >= CommandTypeCount) {
+        return KeyCount;
+    }
+    const size_t sample_count_bucket{sample_count <= 160 ? 0U : 1U};
+    const size_t channel_count_bucket{
+        std::min<size_t>(GetCommandChannelCount(command), ChannelCountBucketCount - 1)};
+    return (type * SampleCountBucketCount + sample_count_bucket) * ChannelCountBucketCount +
+           channel_count_bucket;
+}
+
+template <typename T>
+u32 CommandProcessingTimeEstimatorAdaptive::EstimateAdaptive(const T& command) const {
+    const auto key{GetKey(command)};
+    if (key >= KeyCount || measured_counts[key].load(std::memory_order_relaxed) < WarmupCount) {
+        return base_estimator->Estimate(command);
+    }
+    return static_cast<u32>(measured_averages[key].load(std::memory_order_relaxed));
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const PcmInt16DataSourceVersion1Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const PcmInt16DataSourceVersion2Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const PcmFloatDataSourceVersion1Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const PcmFloatDataSourceVersion2Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const AdpcmDataSourceVersion1Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const AdpcmDataSourceVersion2Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const VolumeCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const VolumeRampCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const BiquadFilterCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const MixCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const MixRampCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const MixRampGroupedCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const DepopPrepareCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const DepopForMixBuffersCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const DelayCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const UpsampleCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const DownMix6chTo2chCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const AuxCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const DeviceSinkCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const CircularBufferSinkCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const ReverbCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const I3dl2ReverbCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const PerformanceCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const ClearMixBufferCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const CopyMixBufferCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const LightLimiterVersion1Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const LightLimiterVersion2Command& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const MultiTapBiquadFilterCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const CaptureCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(const CompressorCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const MultiChannelBiquadFilterCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+u32 CommandProcessingTimeEstimatorAdaptive::Estimate(
+    const AdvanceVoicePositionCommand& command) const {
+    return EstimateAdaptive(command);
+}
+
+void CommandProcessingTimeEstimatorAdaptive::RecordProcessTime(const ICommand& command,
+                                                               std::chrono::nanoseconds time) {
+    // Estimates are in ADSP ticks, where a 5ms frame is 2,880,000 ticks.
+    constexpr f32 TicksPerNs{2'880'000.0f / 5'000'000.0f};
+
+    const auto key{GetKey(command)};
+    if (key >= KeyCount) {
+        return;
+    }
+    const auto ticks{static_cast<f32>(time.count()) * TicksPerNs};
+    const auto count{measured_counts[key].load(std::memory_order_relaxed)};
+
+    // Only the ADSP thread writes these, so a plain load and store is enough.
+    auto average{measured_averages[key].load(std::memory_order_relaxed)};
+    if (count == 0) {
+        average = ticks;
+    } else {
+        average += (ticks - average) * AverageWeight;
+    }
+    measured_averages[key].store(average, std::memory_order_relaxed);
+
+    if (count < WarmupCount) {
+        measured_counts[key].store(count + 1, std::memory_order_relaxed);
+    }
+}
+
 } // namespace AudioCore::AudioRenderer
@@ -3,6 +3,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
 #include <audio_core/renderer/command/commands.h>
 #include <audio_core/common/common_types.h>
 
@@ -44,6 +49,29 @@ public:
     virtual u32 Estimate(const MultiTapBiquadFilterCommand& command) const = 0;
     virtual u32 Estimate(const CaptureCommand& command) const = 0;
     virtual u32 Estimate(const CompressorCommand& command) const = 0;
+    virtual u32 Estimate(const MultiChannelBiquadFilterCommand& command) const = 0;
+    virtual u32 Estimate(const AdvanceVoicePositionCommand& command) const = 0;
+
+    /**
+     * Report how long a command actually took to process.
+     * Called from the ADSP thread after every processed command, except those which skipped their
+     * work on silent input, ignored by default.
+     *
+     * @param command - The command which was processed.
+     * @param time    - Host time taken to process it.
+     */
+    virtual void RecordProcessTime([[maybe_unused]] const ICommand& command,
+                                   [[maybe_unused]] std::chrono::nanoseconds time) {}
+
+    /**
+     * Check if this estimator uses the process times reported to it. If not, the ADSP does not
+     * measure commands for it.
+     *
+     * @return True if RecordProcessTime should be called, otherwise false.
+     */
+    virtual bool WantsProcessTimes() const {
+        return false;
+    }
 };
 
 class CommandProcessingTimeEstimatorVersion1 final : public ICommandProcessingTimeEstimator {
@@ -81,6 +109,8 @@ public:
     u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
     u32 Estimate(const CaptureCommand& command) const override;
     u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
 
 private:
     u32 sample_count{};
@@ -122,6 +152,8 @@ public:
     u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
     u32 Estimate(const CaptureCommand& command) const override;
     u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
 
 private:
     u32 sample_count{};
@@ -163,6 +195,8 @@ public:
     u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
     u32 Estimate(const CaptureCommand& command) const override;
     u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
 
 private:
     u32 sample_count{};
@@ -204,6 +238,8 @@ public:
     u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
     u32 Estimate(const CaptureCommand& command) const override;
     u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
 
 private:
     u32 sample_count{};
@@ -245,10 +281,108 @@ public:
     u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
     u32 Estimate(const CaptureCommand& command) const override;
     u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
 
 private:
     u32 sample_count{};
     u32 buffer_count{};
 };
 
+/**
+ * Estimator which learns the cost of commands from the time the host actually takes to process
+ * them. Measurements are kept per command type, sample count and channel count. Until enough
+ * samples of a combination have been measured, the hardware-tuned estimate of the wrapped version
+ * is used, afterwards the measured average is used directly.
+ */
+class CommandProcessingTimeEstimatorAdaptive final : public ICommandProcessingTimeEstimator {
+public:
+    CommandProcessingTimeEstimatorAdaptive(
+        std::unique_ptr<ICommandProcessingTimeEstimator> base_estimator_, u32 sample_count_)
+        : base_estimator{std::move(base_estimator_)}, sample_count{sample_count_} {}
+
+    u32 Estimate(const PcmInt16DataSourceVersion1Command& command) const override;
+    u32 Estimate(const PcmInt16DataSourceVersion2Command& command) const override;
+    u32 Estimate(const PcmFloatDataSourceVersion1Command& command) const override;
+    u32 Estimate(const PcmFloatDataSourceVersion2Command& command) const override;
+    u32 Estimate(const AdpcmDataSourceVersion1Command& command) const override;
+    u32 Estimate(const AdpcmDataSourceVersion2Command& command) const override;
+    u32 Estimate(const VolumeCommand& command) const override;
+    u32 Estimate(const VolumeRampCommand& command) const override;
+    u32 Estimate(const BiquadFilterCommand& command) const override;
+    u32 Estimate(const MixCommand& command) const override;
+    u32 Estimate(const MixRampCommand& command) const override;
+    u32 Estimate(const MixRampGroupedCommand& command) const override;
+    u32 Estimate(const DepopPrepareCommand& command) const override;
+    u32 Estimate(const DepopForMixBuffersCommand& command) const override;
+    u32 Estimate(const DelayCommand& command) const override;
+    u32 Estimate(const UpsampleCommand& command) const override;
+    u32 Estimate(const DownMix6chTo2chCommand& command) const override;
+    u32 Estimate(const AuxCommand& command) const override;
+    u32 Estimate(const DeviceSinkCommand& command) const override;
+    u32 Estimate(const CircularBufferSinkCommand& command) const override;
+    u32 Estimate(const ReverbCommand& command) const override;
+    u32 Estimate(const I3dl2ReverbCommand& command) const override;
+    u32 Estimate(const PerformanceCommand& command) const override;
+    u32 Estimate(const ClearMixBufferCommand& command) const override;
+    u32 Estimate(const CopyMixBufferCommand& command) const override;
+    u32 Estimate(const LightLimiterVersion1Command& command) const override;
+    u32 Estimate(const LightLimiterVersion2Command& command) const override;
+    u32 Estimate(const MultiTapBiquadFilterCommand& command) const override;
+    u32 Estimate(const CaptureCommand& command) const override;
+    u32 Estimate(const CompressorCommand& command) const override;
+    u32 Estimate(const MultiChannelBiquadFilterCommand& command) const override;
+    u32 Estimate(const AdvanceVoicePositionCommand& command) const override;
+
+    void RecordProcessTime(const ICommand& command, std::chrono::nanoseconds time) override;
+
+    bool WantsProcessTimes() const override {
+        return true;
+    }
+
+private:
+    /// Number of measurements of a command type needed before they are trusted
+    static constexpr u32 WarmupCount{32};
+    /// Weight given to each new sample in the moving averages
+    static constexpr f32 AverageWeight{1.0f / 16.0f};
+    /// Number of command types
+    static constexpr size_t CommandTypeCount{
+        static_cast<size_t>(CommandId::AdvanceVoicePosition) + 1};
+    /// Number of sample count buckets, up to 160 samples and above
+    static constexpr size_t SampleCountBucketCount{2};
+    /// Number of channel counts tracked, larger counts share the last
+    static constexpr size_t ChannelCountBucketCount{MaxMixBuffers + 1};
+    /// Number of measured combinations
+    static constexpr size_t KeyCount{CommandTypeCount * SampleCountBucketCount *
+                                     ChannelCountBucketCount};
+
+    /**
+     * Get the index of the measurements for a command, from its type, the sample count and its
+     * channel count.
+     *
+     * @param command - Command to get the index for.
+     * @return Index into the measurements, or KeyCount if the command type is unknown.
+     */
+    size_t GetKey(const ICommand& command) const;
+
+    /**
+     * Estimate a command from its measured cost, or the wrapped estimator until enough of its
+     * combination have been measured.
+     *
+     * @param command - Command to estimate.
+     * @return Estimated processing time, in the same units as the wrapped estimator.
+     */
+    template <typename T>
+    u32 EstimateAdaptive(const T& command) const;
+
+    /// Hardware-tuned estimator which provides the warmup estimate
+    std::unique_ptr<ICommandProcessingTimeEstimator> base_estimator;
+    /// Number of samples processed per command
+    u32 sample_count;
+    /// Moving average of the measured process times per combination, written by the ADSP
+    std::array<std::atomic<f32>, KeyCount> measured_averages{};
+    /// Number of process times measured per combination, saturating at WarmupCount
+    std::array<std::atomic<u32>, KeyCount> measured_counts{};
+};
+
 } // namespace AudioCore::AudioRenderer
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <audio_core/renderer/command/data_source/adpcm.h>
+#include <audio_core/renderer/command/data_source/advance_voice_position.h>
 #include <audio_core/renderer/command/data_source/pcm_float.h>
 #include <audio_core/renderer/command/data_source/pcm_int16.h>
 #include <audio_core/renderer/command/effect/aux_.h>
@@ -13,6 +14,7 @@
 #include <audio_core/renderer/command/effect/delay.h>
 #include <audio_core/renderer/command/effect/i3dl2_reverb.h>
 #include <audio_core/renderer/command/effect/light_limiter.h>
+#include <audio_core/renderer/command/effect/multi_channel_biquad_filter.h>
 #include <audio_core/renderer/command/effect/multi_tap_biquad_filter.h>
 #include <audio_core/renderer/command/effect/reverb.h>
 #include <audio_core/renderer/command/icommand.h>
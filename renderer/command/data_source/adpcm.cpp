@@ -42,9 +42,11 @@ void AdpcmDataSourceVersion1Command::Process(const ADSP::CommandListProcessor& p
         .data_size{data_size},
         .IsVoicePlayedSampleCountResetAtLoopPointSupported{(flags & 1) != 0},
         .IsVoicePitchAndSrcSkippedSupported{(flags & 2) != 0},
+        .advance_only{false},
     };
 
     DecodeFromWaveBuffers(*processor.memory, args);
+    processor.UpdateMixBufferSilence(output_index);
 }
 
 bool AdpcmDataSourceVersion1Command::Verify(const ADSP::CommandListProcessor& processor) {
@@ -78,9 +80,11 @@ void AdpcmDataSourceVersion2Command::Process(const ADSP::CommandListProcessor& p
         .data_size{data_size},
         .IsVoicePlayedSampleCountResetAtLoopPointSupported{(flags & 1) != 0},
         .IsVoicePitchAndSrcSkippedSupported{(flags & 2) != 0},
+        .advance_only{false},
     };
 
     DecodeFromWaveBuffers(*processor.memory, args);
+    processor.UpdateMixBufferSilence(output_index);
 }
 
 bool AdpcmDataSourceVersion2Command::Verify(const ADSP::CommandListProcessor& processor) {
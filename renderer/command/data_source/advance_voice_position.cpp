@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/data_source/advance_voice_position.h>
+#include <audio_core/renderer/command/data_source/decode.h>
+
+namespace AudioCore::AudioRenderer {
+
+void AdvanceVoicePositionCommand::Dump(const ADSP::CommandListProcessor& processor,
+                                       std::string& string) {
+    string += fmt::format("AdvanceVoicePositionCommand\n\tformat {} channel {} channel count {} "
+                          "source sample rate {} target sample rate {} src quality {}\n",
+                          static_cast<u32>(sample_format), channel_index, channel_count,
+                          sample_rate, processor.target_sample_rate,
+                          static_cast<u32>(src_quality));
+}
+
+void AdvanceVoicePositionCommand::Process(const ADSP::CommandListProcessor& processor) {
+    if (wave_buffer_version1) {
+        for (auto& wave_buffer : wave_buffers) {
+            wave_buffer.loop_start_offset = wave_buffer.start_offset;
+            wave_buffer.loop_end_offset = wave_buffer.end_offset;
+            wave_buffer.loop_count = wave_buffer.loop ? -1 : 0;
+        }
+    }
+
+    const bool is_adpcm{sample_format == SampleFormat::Adpcm};
+    auto state{reinterpret_cast<VoiceState*>(voice_state)};
+
+    DecodeFromWaveBuffersArgs args{
+        .sample_format{sample_format},
+        .output{},
+        .voice_state{state},
+        .wave_buffers{wave_buffers},
+        .channel{is_adpcm ? static_cast<s8>(0) : channel_index},
+        .channel_count{is_adpcm ? static_cast<s8>(1) : channel_count},
+        .src_quality{src_quality},
+        .pitch{pitch},
+        .source_sample_rate{sample_rate},
+        .target_sample_rate{processor.target_sample_rate},
+        .sample_count{processor.sample_count},
+        .data_address{data_address},
+        .data_size{data_size},
+        .IsVoicePlayedSampleCountResetAtLoopPointSupported{(flags & 1) != 0},
+        .IsVoicePitchAndSrcSkippedSupported{(flags & 2) != 0},
+        .advance_only{true},
+    };
+
+    DecodeFromWaveBuffers(*processor.memory, args);
+
+    // The skipped mix ramps would have faded to and stored a last sample of 0, keep depop in sync.
+    const auto count{std::clamp<s16>(previous_sample_count, 0, static_cast<s16>(MaxMixBuffers))};
+    std::fill_n(state->previous_samples.begin(), count, 0);
+}
+
+bool AdvanceVoicePositionCommand::Verify(const ADSP::CommandListProcessor& processor) {
+    return true;
+}
+
+} // namespace AudioCore::AudioRenderer
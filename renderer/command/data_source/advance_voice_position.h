@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <string>
+
+#include <audio_core/common/wave_buffer.h>
+#include <audio_core/renderer/command/icommand.h>
+#include <audio_core/common/common_types.h>
+
+namespace AudioCore::AudioRenderer {
+namespace ADSP {
+class CommandListProcessor;
+}
+
+/**
+ * AudioRenderer command to advance an inaudible voice's playback state without producing any
+ * output. Wavebuffer position, loops, played sample count, resampler history and ADPCM context
+ * are updated exactly as the matching data source command would.
+ */
+struct AdvanceVoicePositionCommand : ICommand {
+    /**
+     * Print this command's information to a string.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     * @param string    - The string to print into.
+     */
+    void Dump(const ADSP::CommandListProcessor& processor, std::string& string) override;
+
+    /**
+     * Process this command.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     */
+    void Process(const ADSP::CommandListProcessor& processor) override;
+
+    /**
+     * Verify this command's data is valid.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     * @return True if the command is valid, otherwise false.
+     */
+    bool Verify(const ADSP::CommandListProcessor& processor) override;
+
+    /// Sample format of the wavebuffers
+    SampleFormat sample_format;
+    /// Quality used for sample rate conversion
+    SrcQuality src_quality;
+    /// Flags to control decoding (see AudioCore::AudioRenderer::VoiceInfo::Flags)
+    u16 flags;
+    /// Wavebuffer sample rate
+    u32 sample_rate;
+    /// Pitch used for sample rate conversion
+    f32 pitch;
+    /// Target channel to read within the wavebuffer
+    s8 channel_index;
+    /// Number of channels within the wavebuffer
+    s8 channel_count;
+    /// Are the wavebuffers version 1, with loop points taken from the start and end offsets?
+    bool wave_buffer_version1;
+    /// Wavebuffers containing the wavebuffer address, context address, looping information etc
+    std::array<WaveBufferVersion2, MaxWaveBuffers> wave_buffers;
+    /// Voice state, updated each call and written back to game
+    CpuAddr voice_state;
+    /// Number of depop previous samples the skipped mix commands would have reset
+    s16 previous_sample_count;
+    /// Coefficients data address (ADPCM only)
+    CpuAddr data_address;
+    /// Coefficients data size (ADPCM only)
+    u64 data_size;
+};
+
+} // namespace AudioCore::AudioRenderer
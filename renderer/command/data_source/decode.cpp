@@ -91,6 +91,47 @@ static u32 DecodePcm(Core::Memory::Memory& memory, std::span<s16> out_buffer,
     return samples_to_decode;
 }
 
+/**
+ * Skip over PCM data, decoding only the trailing samples which are kept as resampler history.
+ * Consumes exactly as many samples as DecodePcm would for the same request.
+ *
+ * @tparam T              - Type to decode. Only s16 and f32 are supported.
+ * @param memory          - Core memory for reading samples.
+ * @param out_buffer      - Output buffer, only the last samples_to_keep samples are written.
+ * @param req             - Information for how to decode.
+ * @param samples_to_keep - Number of trailing samples to actually decode.
+ * @return Number of samples consumed.
+ */
+template <typename T>
+static u32 SkipPcm(Core::Memory::Memory& memory, std::span<s16> out_buffer, const DecodeArg& req,
+                   const u32 samples_to_keep) {
+    if (req.buffer == 0 || req.buffer_size == 0) {
+        return 0;
+    }
+
+    if (req.start_offset >= req.end_offset) {
+        return 0;
+    }
+
+    if (req.channel_count == 1 && req.target_channel != 0) {
+        LOG_ERROR(Service_Audio, "Invalid target channel, expected 0, got {}", req.target_channel);
+        return 0;
+    }
+
+    const auto samples_to_decode{
+        std::min(req.samples_to_read, req.end_offset - req.start_offset - req.offset)};
+    const auto samples_skipped{samples_to_decode - std::min(samples_to_decode, samples_to_keep)};
+
+    if (samples_skipped < samples_to_decode) {
+        auto tail_req{req};
+        tail_req.offset += samples_skipped;
+        tail_req.samples_to_read = samples_to_decode - samples_skipped;
+        DecodePcm<T>(memory, out_buffer.subspan(samples_skipped), tail_req);
+    }
+
+    return samples_to_decode;
+}
+
 /**
  * Decode ADPCM data.
  *
@@ -273,6 +314,10 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
     auto output_buffer{args.output};
     std::vector<s16> temp_buffer(TempBufferSize, 0);
 
+    // When only advancing, PCM samples are skipped rather than decoded, except for the last few
+    // which become the resampler's history. ADPCM is always decoded to keep its context in sync.
+    const u32 history_count{args.IsVoicePitchAndSrcSkippedSupported ? 0U : pitch};
+
     while (remaining_sample_count > 0) {
         const auto samples_to_write{std::min(remaining_sample_count, max_remaining_sample_count)};
         const auto samples_to_read{
@@ -335,15 +380,27 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
 
             switch (args.sample_format) {
             case SampleFormat::PcmInt16:
-                samples_decoded = DecodePcm<s16>(
-                    memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
-                    decode_arg);
+                if (args.advance_only) {
+                    samples_decoded = SkipPcm<s16>(
+                        memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
+                        decode_arg, history_count);
+                } else {
+                    samples_decoded = DecodePcm<s16>(
+                        memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
+                        decode_arg);
+                }
                 break;
 
             case SampleFormat::PcmFloat:
-                samples_decoded = DecodePcm<f32>(
-                    memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
-                    decode_arg);
+                if (args.advance_only) {
+                    samples_decoded = SkipPcm<f32>(
+                        memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
+                        decode_arg, history_count);
+                } else {
+                    samples_decoded = DecodePcm<f32>(
+                        memory, {&temp_buffer[temp_buffer_pos], TempBufferSize - temp_buffer_pos},
+                        decode_arg);
+                }
                 break;
 
             case SampleFormat::Adpcm: {
@@ -393,7 +450,19 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
             }
         }
 
-        if (args.IsVoicePitchAndSrcSkippedSupported) {
+        if (args.advance_only) {
+            if (!args.IsVoicePitchAndSrcSkippedSupported) {
+                // Resampling advances the fraction by the ratio per output sample, discarding the
+                // integer part each time.
+                fraction += samples_to_write * sample_rate_ratio;
+                fraction.clear_int();
+
+                std::memset(&temp_buffer[temp_buffer_pos], 0,
+                            (samples_to_read - samples_read) * sizeof(s16));
+                std::memcpy(voice_state.sample_history.data(), &temp_buffer[samples_to_read],
+                            pitch * sizeof(s16));
+            }
+        } else if (args.IsVoicePitchAndSrcSkippedSupported) {
             if (samples_read > output_buffer.size()) {
                 LOG_ERROR(Service_Audio, "Attempting to write past the end of output buffer!");
             }
@@ -417,7 +486,9 @@ void DecodeFromWaveBuffers(Core::Memory::Memory& memory, const DecodeFromWaveBuf
             break;
         }
 
-        output_buffer = output_buffer.subspan(samples_to_write);
+        if (!args.advance_only) {
+            output_buffer = output_buffer.subspan(samples_to_write);
+        }
     }
 
     voice_state.wave_buffers_consumed = wavebuffers_consumed;
@@ -33,6 +33,8 @@ struct DecodeFromWaveBuffersArgs {
     u64 data_size;
     bool IsVoicePlayedSampleCountResetAtLoopPointSupported;
     bool IsVoicePitchAndSrcSkippedSupported;
+    /// Only advance the voice state, output is left untouched and may be empty
+    bool advance_only;
 };
 
 struct DecodeArg {
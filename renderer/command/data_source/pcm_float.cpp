@@ -42,9 +42,11 @@ void PcmFloatDataSourceVersion1Command::Process(const ADSP::CommandListProcessor
         .data_size{0},
         .IsVoicePlayedSampleCountResetAtLoopPointSupported{(flags & 1) != 0},
         .IsVoicePitchAndSrcSkippedSupported{(flags & 2) != 0},
+        .advance_only{false},
     };
 
     DecodeFromWaveBuffers(*processor.memory, args);
+    processor.UpdateMixBufferSilence(output_index);
 }
 
 bool PcmFloatDataSourceVersion1Command::Verify(const ADSP::CommandListProcessor& processor) {
@@ -80,9 +82,11 @@ void PcmFloatDataSourceVersion2Command::Process(const ADSP::CommandListProcessor
         .data_size{0},
         .IsVoicePlayedSampleCountResetAtLoopPointSupported{(flags & 1) != 0},
         .IsVoicePitchAndSrcSkippedSupported{(flags & 2) != 0},
+        .advance_only{false},
     };
 
     DecodeFromWaveBuffers(*processor.memory, args);
+    processor.UpdateMixBufferSilence(output_index);
 }
 
 bool PcmFloatDataSourceVersion2Command::Verify(const ADSP::CommandListProcessor& processor) {
@@ -243,11 +243,13 @@ void AuxCommand::Process(const ADSP::CommandListProcessor& processor) {
         if (read != processor.sample_count) {
             std::memset(&output_buffer[read], 0, (processor.sample_count - read) * sizeof(s32));
         }
+        processor.SetMixBufferSilent(output, false);
     } else {
         ResetAuxBufferDsp(*processor.memory, send_buffer_info);
         ResetAuxBufferDsp(*processor.memory, return_buffer_info);
         if (input != output) {
             std::memcpy(output_buffer.data(), input_buffer.data(), output_buffer.size_bytes());
+            processor.SetMixBufferSilent(output, processor.IsMixBufferSilent(input));
         }
     }
 }
@@ -1,51 +1,261 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <bit>
+
 #include <audio_core/renderer/adsp/command_list_processor.h>
 #include <audio_core/renderer/command/effect/biquad_filter.h>
 #include <audio_core/renderer/voice/voice_state.h>
-#include <audio_core/common/bit_cast.h>
+#include <audio_core/common/simd.h>
 
 namespace AudioCore::AudioRenderer {
+namespace {
+/// Int coefficients, widened once so each step is plain s64 arithmetic.
+struct BiquadCoefficientsInt {
+    BiquadCoefficientsInt() = default;
+    explicit BiquadCoefficientsInt(const std::array<s16, 3>& b_, const std::array<s16, 2>& a_)
+        : b{b_[0], b_[1], b_[2]}, a{a_[0], a_[1]} {}
+
+    std::array<s64, 3> b{};
+    std::array<s64, 2> a{};
+};
+
+/// Float coefficients, converted from Q14 once rather than per sample.
+struct BiquadCoefficientsFloat {
+    BiquadCoefficientsFloat() = default;
+    explicit BiquadCoefficientsFloat(const std::array<s16, 3>& b_, const std::array<s16, 2>& a_)
+        : b{Common::FixedPoint<50, 14>::from_base(b_[0]).to_double(),
+            Common::FixedPoint<50, 14>::from_base(b_[1]).to_double(),
+            Common::FixedPoint<50, 14>::from_base(b_[2]).to_double()},
+          a{Common::FixedPoint<50, 14>::from_base(a_[0]).to_double(),
+            Common::FixedPoint<50, 14>::from_base(a_[1]).to_double()} {}
+
+    std::array<f64, 3> b{};
+    std::array<f64, 2> a{};
+};
+
 /**
- * Biquad filter float implementation.
+ * Run one sample through an int biquad, in transposed direct form II.
  *
- * @param output       - Output container for filtered samples.
- * @param input        - Input container for samples to be filtered.
- * @param b            - Feedforward coefficients.
- * @param a            - Feedback coefficients.
- * @param state        - State to track previous samples between calls.
+ * @param c         - Coefficients.
+ * @param in_sample - Input sample.
+ * @param s0        - First delay element, updated.
+ * @param s1        - Second delay element, updated.
+ * @return The filtered sample, clamped to s32.
+ */
+inline s64 StepBiquadInt(const BiquadCoefficientsInt& c, const s64 in_sample, s64& s0, s64& s1) {
+    constexpr s64 min{std::numeric_limits<s32>::min()};
+    constexpr s64 max{std::numeric_limits<s32>::max()};
+
+    const s64 sample{in_sample * c.b[0] + s0};
+    const s64 out_sample{std::clamp<s64>((sample + (1 << 13)) >> 14, min, max)};
+
+    s0 = s1 + c.b[1] * in_sample + c.a[0] * out_sample;
+    s1 = c.b[2] * in_sample + c.a[1] * out_sample;
+    return out_sample;
+}
+
+/**
+ * Run one sample through a float biquad. The state keeps the previous two inputs and outputs, as
+ * it is stored in the game-visible BiquadFilterState.
+ *
+ * @param c         - Coefficients.
+ * @param in_sample - Input sample.
+ * @param s         - Previous inputs (0-1) and outputs (2-3), updated.
+ * @return The filtered sample, clamped to s32.
+ */
+inline s32 StepBiquadFloat(const BiquadCoefficientsFloat& c, const f64 in_sample,
+                           std::array<f64, 4>& s) {
+    constexpr f64 min{std::numeric_limits<s32>::min()};
+    constexpr f64 max{std::numeric_limits<s32>::max()};
+
+    const f64 sample{in_sample * c.b[0] + s[0] * c.b[1] + s[1] * c.b[2] + s[2] * c.a[0] +
+                     s[3] * c.a[1]};
+
+    s[1] = s[0];
+    s[0] = in_sample;
+    s[3] = s[2];
+    s[2] = sample;
+    return static_cast<s32>(std::clamp(sample, min, max));
+}
+
+std::array<f64, 4> LoadFloatState(const VoiceState::BiquadFilterState& state) {
+    return {std::bit_cast<f64>(state.s0), std::bit_cast<f64>(state.s1),
+            std::bit_cast<f64>(state.s2), std::bit_cast<f64>(state.s3)};
+}
+
+void StoreFloatState(VoiceState::BiquadFilterState& state, const std::array<f64, 4>& s) {
+    state.s0 = std::bit_cast<s64>(s[0]);
+    state.s1 = std::bit_cast<s64>(s[1]);
+    state.s2 = std::bit_cast<s64>(s[2]);
+    state.s3 = std::bit_cast<s64>(s[3]);
+}
+
+/**
+ * Int biquad over NumChannels channels sharing one set of coefficients. Every channel is stepped
+ * for a sample before moving to the next, with the states held in fixed-size local arrays. The
+ * steps stay scalar, as the 64-bit multiplies and the clamp have no cheap SSE2 equivalent.
+ *
+ * @tparam NumChannels - Number of channels to process.
+ * @param outputs      - Output containers for filtered samples, one per channel.
+ * @param inputs       - Input containers for samples to be filtered, one per channel.
+ * @param c            - Coefficients.
+ * @param states       - States to track previous samples between calls, one per channel.
  * @param sample_count - Number of samples to process.
  */
-void ApplyBiquadFilterFloat(std::span<s32> output, std::span<const s32> input,
-                            std::array<s16, 3>& b_, std::array<s16, 2>& a_,
-                            VoiceState::BiquadFilterState& state, const u32 sample_count) {
+template <size_t NumChannels>
+void ApplyBiquadFilterIntLanes(std::span<const std::span<s32>> outputs,
+                               std::span<const std::span<const s32>> inputs,
+                               const BiquadCoefficientsInt& c,
+                               std::span<VoiceState::BiquadFilterState* const> states,
+                               const u32 sample_count) {
+    std::array<s64, NumChannels> s0;
+    std::array<s64, NumChannels> s1;
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+        s0[channel] = states[channel]->s0;
+        s1[channel] = states[channel]->s1;
+    }
+
+    for (u32 i = 0; i < sample_count; i++) {
+        std::array<s64, NumChannels> samples;
+        for (size_t channel = 0; channel < NumChannels; channel++) {
+            samples[channel] = inputs[channel][i];
+        }
+
+        for (size_t channel = 0; channel < NumChannels; channel++) {
+            samples[channel] = StepBiquadInt(c, samples[channel], s0[channel], s1[channel]);
+        }
+
+        for (size_t channel = 0; channel < NumChannels; channel++) {
+            outputs[channel][i] = static_cast<s32>(samples[channel]);
+        }
+    }
+
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+        states[channel]->s0 = s0[channel];
+        states[channel]->s1 = s1[channel];
+    }
+}
+
+/**
+ * Float biquad over NumChannels channels sharing one set of coefficients, two channels to a
+ * vector. Each lane does the same operations in the same order as StepBiquadFloat, so the
+ * results match it exactly.
+ *
+ * @tparam NumChannels - Number of channels to process.
+ * @param outputs      - Output containers for filtered samples, one per channel.
+ * @param inputs       - Input containers for samples to be filtered, one per channel.
+ * @param c            - Coefficients.
+ * @param states       - States to track previous samples between calls, one per channel.
+ * @param sample_count - Number of samples to process.
+ */
+template <size_t NumChannels>
+void ApplyBiquadFilterFloatLanes(std::span<const std::span<s32>> outputs,
+                                 std::span<const std::span<const s32>> inputs,
+                                 const BiquadCoefficientsFloat& c,
+                                 std::span<VoiceState::BiquadFilterState* const> states,
+                                 const u32 sample_count) {
+    using namespace Common::Simd;
+    constexpr size_t NumPairs{(NumChannels + 1) / 2};
     constexpr f64 min{std::numeric_limits<s32>::min()};
     constexpr f64 max{std::numeric_limits<s32>::max()};
-    std::array<f64, 3> b{Common::FixedPoint<50, 14>::from_base(b_[0]).to_double(),
-                         Common::FixedPoint<50, 14>::from_base(b_[1]).to_double(),
-                         Common::FixedPoint<50, 14>::from_base(b_[2]).to_double()};
-    std::array<f64, 2> a{Common::FixedPoint<50, 14>::from_base(a_[0]).to_double(),
-                         Common::FixedPoint<50, 14>::from_base(a_[1]).to_double()};
-    std::array<f64, 4> s{Common::BitCast<f64>(state.s0), Common::BitCast<f64>(state.s1),
-                         Common::BitCast<f64>(state.s2), Common::BitCast<f64>(state.s3)};
+
+    // Previous inputs (0-1) and outputs (2-3), by channel. An odd channel count leaves the last
+    // lane unused.
+    std::array<std::array<f64, NumPairs * 2>, 4> state_samples{};
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+        const auto channel_state{LoadFloatState(*states[channel])};
+        for (size_t j = 0; j < 4; j++) {
+            state_samples[j][channel] = channel_state[j];
+        }
+    }
+
+    std::array<std::array<F64x2, NumPairs>, 4> s;
+    for (size_t j = 0; j < 4; j++) {
+        for (size_t pair = 0; pair < NumPairs; pair++) {
+            s[j][pair] = LoadF64x2(&state_samples[j][pair * 2]);
+        }
+    }
+
+    const auto b0{SplatF64x2(c.b[0])};
+    const auto b1{SplatF64x2(c.b[1])};
+    const auto b2{SplatF64x2(c.b[2])};
+    const auto a0{SplatF64x2(c.a[0])};
+    const auto a1{SplatF64x2(c.a[1])};
 
     for (u32 i = 0; i < sample_count; i++) {
-        f64 in_sample{static_cast<f64>(input[i])};
-        auto sample{in_sample * b[0] + s[0] * b[1] + s[1] * b[2] + s[2] * a[0] + s[3] * a[1]};
+        std::array<f64, NumPairs * 2> in_samples{};
+        for (size_t channel = 0; channel < NumChannels; channel++) {
+            in_samples[channel] = static_cast<f64>(inputs[channel][i]);
+        }
+
+        std::array<f64, NumPairs * 2> out_samples;
+        for (size_t pair = 0; pair < NumPairs; pair++) {
+            const auto in_sample{LoadF64x2(&in_samples[pair * 2])};
+            auto sample{MulF64x2(in_sample, b0)};
+            sample = AddF64x2(sample, MulF64x2(s[0][pair], b1));
+            sample = AddF64x2(sample, MulF64x2(s[1][pair], b2));
+            sample = AddF64x2(sample, MulF64x2(s[2][pair], a0));
+            sample = AddF64x2(sample, MulF64x2(s[3][pair], a1));
 
-        output[i] = static_cast<s32>(std::clamp(sample, min, max));
+            s[1][pair] = s[0][pair];
+            s[0][pair] = in_sample;
+            s[3][pair] = s[2][pair];
+            s[2][pair] = sample;
+            StoreF64x2(&out_samples[pair * 2], ClampF64x2(sample, min, max));
+        }
 
-        s[1] = s[0];
-        s[0] = in_sample;
-        s[3] = s[2];
-        s[2] = sample;
+        for (size_t channel = 0; channel < NumChannels; channel++) {
+            outputs[channel][i] = static_cast<s32>(out_samples[channel]);
+        }
     }
 
-    state.s0 = Common::BitCast<s64>(s[0]);
-    state.s1 = Common::BitCast<s64>(s[1]);
-    state.s2 = Common::BitCast<s64>(s[2]);
-    state.s3 = Common::BitCast<s64>(s[3]);
+    for (size_t j = 0; j < 4; j++) {
+        for (size_t pair = 0; pair < NumPairs; pair++) {
+            StoreF64x2(&state_samples[j][pair * 2], s[j][pair]);
+        }
+    }
+    for (size_t channel = 0; channel < NumChannels; channel++) {
+        StoreFloatState(*states[channel],
+                        {state_samples[0][channel], state_samples[1][channel],
+                         state_samples[2][channel], state_samples[3][channel]});
+    }
+}
+
+template <size_t NumChannels>
+void ApplyBiquadFilterLanes(std::span<const std::span<s32>> outputs,
+                            std::span<const std::span<const s32>> inputs,
+                            const std::array<s16, 3>& b, const std::array<s16, 2>& a,
+                            std::span<VoiceState::BiquadFilterState* const> states,
+                            const u32 sample_count, const bool use_float_processing) {
+    if (use_float_processing) {
+        ApplyBiquadFilterFloatLanes<NumChannels>(outputs, inputs, BiquadCoefficientsFloat{b, a},
+                                                 states, sample_count);
+    } else {
+        ApplyBiquadFilterIntLanes<NumChannels>(outputs, inputs, BiquadCoefficientsInt{b, a},
+                                               states, sample_count);
+    }
+}
+} // namespace
+
+/**
+ * Biquad filter float implementation.
+ *
+ * @param output       - Output container for filtered samples.
+ * @param input        - Input container for samples to be filtered.
+ * @param b            - Feedforward coefficients.
+ * @param a            - Feedback coefficients.
+ * @param state        - State to track previous samples between calls.
+ * @param sample_count - Number of samples to process.
+ */
+void ApplyBiquadFilterFloat(std::span<s32> output, std::span<const s32> input,
+                            std::array<s16, 3>& b, std::array<s16, 2>& a,
+                            VoiceState::BiquadFilterState& state, const u32 sample_count) {
+    const std::array<std::span<s32>, 1> outputs{output};
+    const std::array<std::span<const s32>, 1> inputs{input};
+    const std::array<VoiceState::BiquadFilterState*, 1> states{&state};
+    ApplyBiquadFilterFloatLanes<1>(outputs, inputs, BiquadCoefficientsFloat{b, a}, states,
+                                   sample_count);
 }
 
 /**
@@ -61,18 +271,96 @@ void ApplyBiquadFilterFloat(std::span<s32> output, std::span<const s32> input,
 static void ApplyBiquadFilterInt(std::span<s32> output, std::span<const s32> input,
                                  std::array<s16, 3>& b, std::array<s16, 2>& a,
                                  VoiceState::BiquadFilterState& state, const u32 sample_count) {
-    constexpr s64 min{std::numeric_limits<s32>::min()};
-    constexpr s64 max{std::numeric_limits<s32>::max()};
+    const std::array<std::span<s32>, 1> outputs{output};
+    const std::array<std::span<const s32>, 1> inputs{input};
+    const std::array<VoiceState::BiquadFilterState*, 1> states{&state};
+    ApplyBiquadFilterIntLanes<1>(outputs, inputs, BiquadCoefficientsInt{b, a}, states,
+                                 sample_count);
+}
 
-    for (u32 i = 0; i < sample_count; i++) {
-        const s64 in_sample{input[i]};
-        const s64 sample{in_sample * b[0] + state.s0};
-        const s64 out_sample{std::clamp<s64>((sample + (1 << 13)) >> 14, min, max)};
+void ApplyBiquadFilterMultiChannel(std::span<const std::span<s32>> outputs,
+                                   std::span<const std::span<const s32>> inputs,
+                                   const std::array<s16, 3>& b, const std::array<s16, 2>& a,
+                                   std::span<VoiceState::BiquadFilterState* const> states,
+                                   const u32 sample_count, const bool use_float_processing) {
+    switch (outputs.size()) {
+    case 1:
+        ApplyBiquadFilterLanes<1>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    case 2:
+        ApplyBiquadFilterLanes<2>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    case 3:
+        ApplyBiquadFilterLanes<3>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    case 4:
+        ApplyBiquadFilterLanes<4>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    case 5:
+        ApplyBiquadFilterLanes<5>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    case 6:
+        ApplyBiquadFilterLanes<6>(outputs, inputs, b, a, states, sample_count,
+                                  use_float_processing);
+        break;
+    default:
+        LOG_ERROR(Service_Audio, "Invalid biquad channel count {}", outputs.size());
+        break;
+    }
+}
+
+void ApplyBiquadFilterCascade(std::span<s32> output, std::span<const s32> input,
+                              std::span<const VoiceInfo::BiquadFilterParameter> biquads,
+                              std::span<VoiceState::BiquadFilterState* const> states,
+                              const u32 sample_count, const bool use_float_processing) {
+    const auto tap_count{std::min<size_t>(biquads.size(), MaxBiquadFilters)};
+
+    if (use_float_processing) {
+        std::array<BiquadCoefficientsFloat, MaxBiquadFilters> c{};
+        std::array<std::array<f64, 4>, MaxBiquadFilters> s{};
+        for (size_t tap = 0; tap < tap_count; tap++) {
+            c[tap] = BiquadCoefficientsFloat{biquads[tap].b, biquads[tap].a};
+            s[tap] = LoadFloatState(*states[tap]);
+        }
+
+        for (u32 i = 0; i < sample_count; i++) {
+            s32 sample{input[i]};
+            for (size_t tap = 0; tap < tap_count; tap++) {
+                sample = StepBiquadFloat(c[tap], static_cast<f64>(sample), s[tap]);
+            }
+            output[i] = sample;
+        }
+
+        for (size_t tap = 0; tap < tap_count; tap++) {
+            StoreFloatState(*states[tap], s[tap]);
+        }
+    } else {
+        std::array<BiquadCoefficientsInt, MaxBiquadFilters> c{};
+        std::array<s64, MaxBiquadFilters> s0{};
+        std::array<s64, MaxBiquadFilters> s1{};
+        for (size_t tap = 0; tap < tap_count; tap++) {
+            c[tap] = BiquadCoefficientsInt{biquads[tap].b, biquads[tap].a};
+            s0[tap] = states[tap]->s0;
+            s1[tap] = states[tap]->s1;
+        }
 
-        output[i] = static_cast<s32>(out_sample);
+        for (u32 i = 0; i < sample_count; i++) {
+            s64 sample{input[i]};
+            for (size_t tap = 0; tap < tap_count; tap++) {
+                sample = StepBiquadInt(c[tap], sample, s0[tap], s1[tap]);
+            }
+            output[i] = static_cast<s32>(sample);
+        }
 
-        state.s0 = state.s1 + b[1] * in_sample + a[0] * out_sample;
-        state.s1 = b[2] * in_sample + a[1] * out_sample;
+        for (size_t tap = 0; tap < tap_count; tap++) {
+            states[tap]->s0 = s0[tap];
+            states[tap]->s1 = s1[tap];
+        }
     }
 }
 
@@ -101,6 +389,7 @@ void BiquadFilterCommand::Process(const ADSP::CommandListProcessor& processor) {
         ApplyBiquadFilterInt(output_buffer, input_buffer, biquad.b, biquad.a, *state_,
                              processor.sample_count);
     }
+    processor.SetMixBufferSilent(output, false);
 }
 
 bool BiquadFilterCommand::Verify(const ADSP::CommandListProcessor& processor) {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+#include <span>
 #include <string>
 
 #include <audio_core/renderer/command/icommand.h>
@@ -71,4 +73,39 @@ void ApplyBiquadFilterFloat(std::span<s32> output, std::span<const s32> input,
                             std::array<s16, 3>& b, std::array<s16, 2>& a,
                             VoiceState::BiquadFilterState& state, const u32 sample_count);
 
+/**
+ * Biquad filter implementation for 1-6 channels sharing the same coefficients.
+ * The channels are filtered side by side, one sample at a time, rather than one full buffer after
+ * another. Channel n must not write to a buffer read by a later channel.
+ *
+ * @param outputs              - Output containers for filtered samples, one per channel.
+ * @param inputs               - Input containers for samples to be filtered, one per channel.
+ * @param b                    - Feedforward coefficients.
+ * @param a                    - Feedback coefficients.
+ * @param states               - States to track previous samples, one per channel.
+ * @param sample_count         - Number of samples to process.
+ * @param use_float_processing - If true, use float processing rather than int.
+ */
+void ApplyBiquadFilterMultiChannel(std::span<const std::span<s32>> outputs,
+                                   std::span<const std::span<const s32>> inputs,
+                                   const std::array<s16, 3>& b, const std::array<s16, 2>& a,
+                                   std::span<VoiceState::BiquadFilterState* const> states,
+                                   u32 sample_count, bool use_float_processing);
+
+/**
+ * Biquad filter cascade, feeding each filter's output into the next within a single pass over
+ * the samples. Results match applying each filter in turn over the whole buffer.
+ *
+ * @param output               - Output container for filtered samples.
+ * @param input                - Input container for samples to be filtered.
+ * @param biquads              - Filter parameters, in processing order.
+ * @param states               - States to track previous samples, one per filter.
+ * @param sample_count         - Number of samples to process.
+ * @param use_float_processing - If true, use float processing rather than int.
+ */
+void ApplyBiquadFilterCascade(std::span<s32> output, std::span<const s32> input,
+                              std::span<const VoiceInfo::BiquadFilterParameter> biquads,
+                              std::span<VoiceState::BiquadFilterState* const> states,
+                              u32 sample_count, bool use_float_processing);
+
 } // namespace AudioCore::AudioRenderer
@@ -146,6 +146,10 @@ void CompressorCommand::Process(const ADSP::CommandListProcessor& processor) {
 
     ApplyCompressorEffect(parameter, *state_, effect_enabled, input_buffers, output_buffers,
                           processor.sample_count);
+
+    const auto channel_count{std::min<size_t>(parameter.channel_count, MaxChannels)};
+    processor.UpdateEffectOutputSilence(std::span(inputs).first(channel_count),
+                                        std::span(outputs).first(channel_count), effect_enabled);
 }
 
 bool CompressorCommand::Verify(const ADSP::CommandListProcessor& processor) {
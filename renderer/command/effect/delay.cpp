@@ -1,8 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
+
 #include <audio_core/renderer/adsp/command_list_processor.h>
 #include <audio_core/renderer/command/effect/delay.h>
+#include <audio_core/common/alignment.h>
+#include <audio_core/common/simd.h>
 
 namespace AudioCore::AudioRenderer {
 /**
@@ -24,48 +28,138 @@ static void SetDelayEffectParameter(const DelayInfo::ParameterVersion1& params,
     state.lowpass_gain = 1.0f - state.lowpass_feedback_gain;
 }
 
+/**
+ * Get the memory for delay lines within a buffer.
+ *
+ * @param buffer - Address of the buffer, may be 0.
+ * @param size   - Size of the buffer.
+ * @return The samples the buffer holds once aligned, empty if there's no buffer.
+ */
+static std::span<Common::FixedPoint<50, 14>> GetDelayLineMemory(const CpuAddr buffer,
+                                                                const u64 size) {
+    const auto aligned_buffer{Common::AlignUp(buffer, 0x40)};
+    if (buffer == 0 || aligned_buffer >= buffer + size) {
+        return {};
+    }
+    return {reinterpret_cast<Common::FixedPoint<50, 14>*>(aligned_buffer),
+            (buffer + size - aligned_buffer) / sizeof(Common::FixedPoint<50, 14>)};
+}
+
 /**
  * Initialize a new DelayInfo state according to the given parameters.
+ * Each delay line is a power of two sized ring, indexed with a mask, so (re)initializing the
+ * effect does not allocate. The lines are carved out of the game-supplied workbuffer, or the host
+ * memory the effect was given when the workbuffer is too small.
  *
- * @param params     - Input parameters to update the state.
- * @param state      - State to be updated.
- * @param workbuffer - Game-supplied memory for the state. (Unused)
+ * @param params           - Input parameters to update the state.
+ * @param state            - State to be updated.
+ * @param workbuffer       - Game-supplied memory for the delay lines.
+ * @param workbuffer_size  - Size of the game-supplied memory.
+ * @param host_buffer      - Host memory for the delay lines, see EffectContext::GetHostBuffer.
+ * @param host_buffer_size - Size of the host memory.
  */
 static void InitializeDelayEffect(const DelayInfo::ParameterVersion1& params,
-                                  DelayInfo::State& state,
-                                  [[maybe_unused]] const CpuAddr workbuffer) {
+                                  DelayInfo::State& state, const CpuAddr workbuffer,
+                                  const u64 workbuffer_size, const CpuAddr host_buffer,
+                                  const u64 host_buffer_size) {
     state = {};
 
-    for (u32 channel = 0; channel < params.channel_count; channel++) {
-        Common::FixedPoint<32, 32> sample_count_max{0.064f};
-        sample_count_max *= params.sample_rate.to_int_floor() * params.delay_time_max;
+    const auto channel_count{std::min<u32>(params.channel_count, MaxChannels)};
+    auto delay{DelayInfo::GetDelaySampleCount(params)};
+    auto line_size{DelayInfo::GetDelayLineSize(params)};
 
-        Common::FixedPoint<18, 14> delay_time{params.delay_time};
-        delay_time *= params.sample_rate / 1000;
-        Common::FixedPoint<32, 32> sample_count{delay_time};
+    auto memory{GetDelayLineMemory(workbuffer, workbuffer_size)};
+    const auto host_memory{GetDelayLineMemory(host_buffer, host_buffer_size)};
+    if (memory.size() < u64{line_size} * channel_count && host_memory.size() > memory.size()) {
+        memory = host_memory;
+    }
 
-        if (sample_count > sample_count_max) {
-            sample_count = sample_count_max;
-        }
+    // The memory is sized when the effect is created, so this only shrinks the lines if the
+    // parameters later ask for more channels or a longer delay than they did then.
+    while (line_size != 0 && u64{line_size} * channel_count > memory.size()) {
+        line_size >>= 1;
+    }
+    if (line_size < delay) {
+        LOG_ERROR(Service_Audio, "Delay lines need {} samples but only {} are available", delay,
+                  line_size);
+        delay = line_size;
+    }
+    if (line_size == 0) {
+        // No room for any line, ApplyDelayEffect passes the input through.
+        return;
+    }
 
-        state.delay_lines[channel].sample_count_max = sample_count_max.to_int_floor();
-        state.delay_lines[channel].sample_count = sample_count.to_int_floor();
-        state.delay_lines[channel].buffer.resize(state.delay_lines[channel].sample_count, 0);
-        if (state.delay_lines[channel].buffer.size() == 0) {
-            state.delay_lines[channel].buffer.push_back(0);
-        }
-        state.delay_lines[channel].buffer_pos = 0;
-        state.delay_lines[channel].decay_rate = 1.0f;
+    std::fill_n(memory.begin(), u64{line_size} * channel_count, 0);
+
+    for (u32 channel = 0; channel < channel_count; channel++) {
+        auto& delay_line{state.delay_lines[channel]};
+        delay_line.sample_count_max = static_cast<s32>(line_size);
+        delay_line.sample_count = static_cast<s32>(delay);
+        delay_line.buffer = memory.data() + u64{line_size} * channel;
+        delay_line.buffer_mask = line_size - 1;
+        delay_line.buffer_pos = 0;
+        delay_line.delay = delay;
+        delay_line.decay_rate = 1.0f;
     }
 
     SetDelayEffectParameter(params, state);
 }
 
+/**
+ * Build the cross-channel feedback matrix for the current state, as raw Q14 gains.
+ * Rows are padded with zero gains to a whole number of channel pairs.
+ *
+ * @tparam NumChannels - Number of channels. 1, 2, 4 or 6.
+ * @param params       - Input parameters to use.
+ * @param state        - State holding the current feedback gains.
+ * @return The feedback matrix, indexed [source][destination].
+ */
+template <size_t NumChannels>
+static std::array<std::array<s64, (NumChannels + 1) / 2 * 2>, NumChannels> GetFeedbackMatrix(
+    const DelayInfo::ParameterVersion1& params, const DelayInfo::State& state) {
+    const s64 fb{state.feedback_gain.to_raw()};
+    const s64 g{state.delay_feedback_gain.to_raw()};
+    const s64 x{state.delay_feedback_cross_gain.to_raw()};
+
+    // clang-format off
+    if constexpr (NumChannels == 1) {
+        return {{
+            {fb},
+        }};
+    } else if constexpr (NumChannels == 2) {
+        return {{
+            {g, x},
+            {x, g},
+        }};
+    } else if constexpr (NumChannels == 4) {
+        return {{
+            {g, x, x, 0},
+            {x, g, 0, x},
+            {x, 0, g, x},
+            {0, x, x, g},
+        }};
+    } else {
+        static_assert(NumChannels == 6);
+        const s64 lfe{params.feedback_gain.to_raw()};
+        return {{
+            {g, 0, x, 0, x, 0},
+            {0, g, x, 0, 0, x},
+            {x, x, g, 0, 0, 0},
+            {0, 0, 0, lfe, 0, 0},
+            {x, 0, 0, 0, g, x},
+            {0, x, 0, 0, x, g},
+        }};
+    }
+    // clang-format on
+}
+
 /**
  * Delay effect impl, according to the parameters and current state, on the input mix buffers,
  * saving the results to the output mix buffers.
+ * Works on raw Q14 values, two channels to a vector, with the feedback matrix hoisted out of the
+ * sample loop. The products floor exactly as Common::FixedPoint<50, 14> multiplication does.
  *
- * @tparam NumChannels - Number of channels to process. 1-6.
+ * @tparam NumChannels - Number of channels to process. 1, 2, 4 or 6.
  * @param params       - Input parameters to use.
  * @param state        - State to use, must be initialized (see InitializeDelayEffect).
  * @param inputs       - Input mix buffers to performan the delay on.
@@ -74,71 +168,72 @@ static void InitializeDelayEffect(const DelayInfo::ParameterVersion1& params,
  */
 template <size_t NumChannels>
 static void ApplyDelay(const DelayInfo::ParameterVersion1& params, DelayInfo::State& state,
-                       std::vector<std::span<const s32>>& inputs,
-                       std::vector<std::span<s32>>& outputs, const u32 sample_count) {
-    for (u32 sample_index = 0; sample_index < sample_count; sample_index++) {
-        std::array<Common::FixedPoint<50, 14>, NumChannels> input_samples{};
-        for (u32 channel = 0; channel < NumChannels; channel++) {
-            input_samples[channel] = inputs[channel][sample_index] * 64;
-        }
+                       std::span<const std::span<const s32>> inputs,
+                       std::span<const std::span<s32>> outputs, const u32 sample_count) {
+    using namespace Common::Simd;
+    constexpr size_t NumPairs{(NumChannels + 1) / 2};
+
+    const auto matrix{GetFeedbackMatrix<NumChannels>(params, state)};
+    const auto in_gain{SplatS64x2(params.in_gain.to_raw())};
+    const auto dry_gain{SplatS64x2(params.dry_gain.to_raw())};
+    const auto wet_gain{SplatS64x2(params.wet_gain.to_raw())};
+    const auto lowpass_gain{SplatS64x2(state.lowpass_gain.to_raw())};
+    const auto lowpass_feedback_gain{SplatS64x2(state.lowpass_feedback_gain.to_raw())};
 
-        std::array<Common::FixedPoint<50, 14>, NumChannels> delay_samples{};
+    std::array<s64, NumPairs * 2> lowpass_samples{};
+    for (u32 channel = 0; channel < NumChannels; channel++) {
+        lowpass_samples[channel] = state.lowpass_z[channel].to_raw();
+    }
+    std::array<S64x2, NumPairs> lowpass_z;
+    for (u32 pair = 0; pair < NumPairs; pair++) {
+        lowpass_z[pair] = LoadS64x2(&lowpass_samples[pair * 2]);
+    }
+
+    for (u32 sample_index = 0; sample_index < sample_count; sample_index++) {
+        std::array<s64, NumPairs * 2> input_samples{};
+        std::array<s64, NumPairs * 2> delay_samples{};
         for (u32 channel = 0; channel < NumChannels; channel++) {
-            delay_samples[channel] = state.delay_lines[channel].Read();
+            input_samples[channel] = static_cast<s64>(inputs[channel][sample_index] * 64) << 14;
+            delay_samples[channel] = state.delay_lines[channel].Read().to_raw();
         }
 
-        // clang-format off
-        std::array<std::array<Common::FixedPoint<18, 14>, NumChannels>, NumChannels> matrix{};
-        if constexpr (NumChannels == 1) {
-            matrix = {{
-                {state.feedback_gain},
-            }};
-        } else if constexpr (NumChannels == 2) {
-            matrix = {{
-                {state.delay_feedback_gain, state.delay_feedback_cross_gain},
-                {state.delay_feedback_cross_gain, state.delay_feedback_gain},
-            }};
-        } else if constexpr (NumChannels == 4) {
-            matrix = {{
-                {state.delay_feedback_gain, state.delay_feedback_cross_gain, state.delay_feedback_cross_gain, 0.0f},
-                {state.delay_feedback_cross_gain, state.delay_feedback_gain, 0.0f, state.delay_feedback_cross_gain},
-                {state.delay_feedback_cross_gain, 0.0f, state.delay_feedback_gain, state.delay_feedback_cross_gain},
-                {0.0f, state.delay_feedback_cross_gain, state.delay_feedback_cross_gain, state.delay_feedback_gain},
-            }};
-        } else if constexpr (NumChannels == 6) {
-            matrix = {{
-                {state.delay_feedback_gain, 0.0f, state.delay_feedback_cross_gain, 0.0f, state.delay_feedback_cross_gain, 0.0f},
-                {0.0f, state.delay_feedback_gain, state.delay_feedback_cross_gain, 0.0f, 0.0f, state.delay_feedback_cross_gain},
-                {state.delay_feedback_cross_gain, state.delay_feedback_cross_gain, state.delay_feedback_gain, 0.0f, 0.0f, 0.0f},
-                {0.0f, 0.0f, 0.0f, params.feedback_gain, 0.0f, 0.0f},
-                {state.delay_feedback_cross_gain, 0.0f, 0.0f, 0.0f, state.delay_feedback_gain, state.delay_feedback_cross_gain},
-                {0.0f, state.delay_feedback_cross_gain, 0.0f, 0.0f, state.delay_feedback_cross_gain, state.delay_feedback_gain},
-            }};
+        std::array<S64x2, NumPairs> input;
+        std::array<S64x2, NumPairs> delayed;
+        std::array<S64x2, NumPairs> gained;
+        for (u32 pair = 0; pair < NumPairs; pair++) {
+            input[pair] = LoadS64x2(&input_samples[pair * 2]);
+            delayed[pair] = LoadS64x2(&delay_samples[pair * 2]);
+            gained[pair] = MulQ14S64x2(input[pair], in_gain);
         }
-        // clang-format on
 
-        std::array<Common::FixedPoint<50, 14>, NumChannels> gained_samples{};
-        for (u32 channel = 0; channel < NumChannels; channel++) {
-            Common::FixedPoint<50, 14> delay{};
-            for (u32 j = 0; j < NumChannels; j++) {
-                delay += delay_samples[j] * matrix[j][channel];
+        // Each source channel's delayed sample, fed back into a pair of destinations at a time.
+        for (u32 source = 0; source < NumChannels; source++) {
+            const auto delay_sample{SplatS64x2(delay_samples[source])};
+            for (u32 pair = 0; pair < NumPairs; pair++) {
+                gained[pair] = AddS64x2(
+                    gained[pair], MulQ14S64x2(delay_sample, LoadS64x2(&matrix[source][pair * 2])));
             }
-            gained_samples[channel] = input_samples[channel] * params.in_gain + delay;
         }
 
-        for (u32 channel = 0; channel < NumChannels; channel++) {
-            state.lowpass_z[channel] = gained_samples[channel] * state.lowpass_gain +
-                                       state.lowpass_z[channel] * state.lowpass_feedback_gain;
-            state.delay_lines[channel].Write(state.lowpass_z[channel]);
+        std::array<s64, NumPairs * 2> output_samples;
+        for (u32 pair = 0; pair < NumPairs; pair++) {
+            lowpass_z[pair] = AddS64x2(MulQ14S64x2(gained[pair], lowpass_gain),
+                                       MulQ14S64x2(lowpass_z[pair], lowpass_feedback_gain));
+            StoreS64x2(&lowpass_samples[pair * 2], lowpass_z[pair]);
+            StoreS64x2(&output_samples[pair * 2], AddS64x2(MulQ14S64x2(input[pair], dry_gain),
+                                                           MulQ14S64x2(delayed[pair], wet_gain)));
         }
 
         for (u32 channel = 0; channel < NumChannels; channel++) {
-            outputs[channel][sample_index] = (input_samples[channel] * params.dry_gain +
-                                              delay_samples[channel] * params.wet_gain)
-                                                 .to_int_floor() /
-                                             64;
+            state.delay_lines[channel].Write(
+                Common::FixedPoint<50, 14>::from_base(lowpass_samples[channel]));
+            outputs[channel][sample_index] = static_cast<s32>(output_samples[channel] >> 14) / 64;
         }
     }
+
+    for (u32 channel = 0; channel < NumChannels; channel++) {
+        state.lowpass_z[channel] = Common::FixedPoint<50, 14>::from_base(lowpass_samples[channel]);
+    }
 }
 
 /**
@@ -153,15 +248,16 @@ static void ApplyDelay(const DelayInfo::ParameterVersion1& params, DelayInfo::St
  * @param sample_count - Number of samples to process.
  */
 static void ApplyDelayEffect(const DelayInfo::ParameterVersion1& params, DelayInfo::State& state,
-                             const bool enabled, std::vector<std::span<const s32>>& inputs,
-                             std::vector<std::span<s32>>& outputs, const u32 sample_count) {
+                             const bool enabled, std::span<const std::span<const s32>> inputs,
+                             std::span<const std::span<s32>> outputs, const u32 sample_count) {
 
     if (!IsChannelCountValid(params.channel_count)) {
         LOG_ERROR(Service_Audio, "Invalid delay channels {}", params.channel_count);
         return;
     }
 
-    if (enabled) {
+    // Lines are left unset when InitializeDelayEffect had no memory for them.
+    if (enabled && state.delay_lines[0].buffer != nullptr) {
         switch (params.channel_count) {
         case 1:
             ApplyDelay<1>(params, state, inputs, outputs, sample_count);
@@ -194,6 +290,35 @@ static void ApplyDelayEffect(const DelayInfo::ParameterVersion1& params, DelayIn
     }
 }
 
+/**
+ * Check if a delay has nothing left to play out. Silent input will then produce silent output,
+ * and leave the state as it is.
+ *
+ * @param params - Input parameters, for the channel count.
+ * @param state  - State to check.
+ * @return True if all delay lines and lowpass states are zero.
+ */
+static bool IsDelayTailSilent(const DelayInfo::ParameterVersion1& params,
+                              const DelayInfo::State& state) {
+    const auto channel_count{std::min<u32>(params.channel_count, MaxChannels)};
+    for (u32 channel = 0; channel < channel_count; channel++) {
+        const auto& line{state.delay_lines[channel]};
+        if (state.lowpass_z[channel].to_raw() != 0) {
+            return false;
+        }
+        if (line.buffer == nullptr) {
+            continue;
+        }
+        // Only the last delay samples written are read again, the rest of the ring is stale.
+        for (u32 i = 0; i < line.delay; i++) {
+            if (line.buffer[(line.buffer_pos - line.delay + i) & line.buffer_mask].to_raw() != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 void DelayCommand::Dump([[maybe_unused]] const ADSP::CommandListProcessor& processor,
                         std::string& string) {
     string += fmt::format("DelayCommand\n\tenabled {} \n\tinputs: ", effect_enabled);
@@ -208,8 +333,8 @@ void DelayCommand::Dump([[maybe_unused]] const ADSP::CommandListProcessor& proce
 }
 
 void DelayCommand::Process(const ADSP::CommandListProcessor& processor) {
-    std::vector<std::span<const s32>> input_buffers(parameter.channel_count);
-    std::vector<std::span<s32>> output_buffers(parameter.channel_count);
+    std::array<std::span<const s32>, MaxChannels> input_buffers{};
+    std::array<std::span<s32>, MaxChannels> output_buffers{};
 
     for (s16 i = 0; i < parameter.channel_count; i++) {
         input_buffers[i] = processor.mix_buffers.subspan(inputs[i] * processor.sample_count,
@@ -224,11 +349,42 @@ void DelayCommand::Process(const ADSP::CommandListProcessor& processor) {
         if (parameter.state == DelayInfo::ParameterState::Updating) {
             SetDelayEffectParameter(parameter, *state_);
         } else if (parameter.state == DelayInfo::ParameterState::Initialized) {
-            InitializeDelayEffect(parameter, *state_, workbuffer);
+            InitializeDelayEffect(parameter, *state_, workbuffer, workbuffer_size, host_buffer,
+                                  host_buffer_size);
+        }
+    }
+
+    const auto channel_count{std::min<size_t>(parameter.channel_count, MaxChannels)};
+    const auto input_indexes{std::span(inputs).first(channel_count)};
+    const auto output_indexes{std::span(outputs).first(channel_count)};
+    const bool inputs_silent{processor.AreMixBuffersSilent(input_indexes)};
+
+    // Once the tail has played out, silent input only produces silence, skip the processing.
+    if (effect_enabled && state_->tail_silent && inputs_silent) {
+        for (const auto output : output_indexes) {
+            processor.SilenceMixBuffer(output);
         }
+        processor.MarkSilentShortCircuit();
+        return;
     }
+    state_->tail_silent = false;
+
     ApplyDelayEffect(parameter, *state_, effect_enabled, input_buffers, output_buffers,
                      processor.sample_count);
+
+    processor.UpdateEffectOutputSilence(input_indexes, output_indexes, effect_enabled);
+    if (effect_enabled && inputs_silent) {
+        const bool outputs_silent{std::all_of(
+            output_indexes.begin(), output_indexes.end(),
+            [&processor](s16 output) { return processor.UpdateMixBufferSilence(output); })};
+        // Checking the tail reads the whole state, so while it plays out only check every few
+        // frames. Processing the silent frames in between gives the same output.
+        if (outputs_silent &&
+            ++state_->tail_check_frames >= ADSP::CommandListProcessor::EffectTailCheckInterval) {
+            state_->tail_check_frames = 0;
+            state_->tail_silent = IsDelayTailSilent(parameter, *state_);
+        }
+    }
 }
 
 bool DelayCommand::Verify(const ADSP::CommandListProcessor& processor) {
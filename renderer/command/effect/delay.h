@@ -51,8 +51,14 @@ struct DelayCommand : ICommand {
     DelayInfo::ParameterVersion1 parameter;
     /// State, updated each call
     CpuAddr state;
-    /// Game-supplied workbuffer (Unused)
+    /// Game-supplied workbuffer, holds the delay lines
     CpuAddr workbuffer;
+    /// Size of the game-supplied workbuffer
+    u64 workbuffer_size;
+    /// Host memory holding the delay lines when the workbuffer is too small
+    CpuAddr host_buffer;
+    /// Size of the host memory
+    u64 host_buffer_size;
     /// Is this effect enabled?
     bool effect_enabled;
 };
@@ -170,6 +170,10 @@ void LightLimiterVersion1Command::Process(const ADSP::CommandListProcessor& proc
     LightLimiterInfo::StatisticsInternal* statistics{nullptr};
     ApplyLightLimiterEffect(parameter, *state_, effect_enabled, input_buffers, output_buffers,
                             processor.sample_count, statistics);
+
+    const auto channel_count{std::min<size_t>(parameter.channel_count, MaxChannels)};
+    processor.UpdateEffectOutputSilence(std::span(inputs).first(channel_count),
+                                        std::span(outputs).first(channel_count), effect_enabled);
 }
 
 bool LightLimiterVersion1Command::Verify(const ADSP::CommandListProcessor& processor) {
@@ -213,6 +217,10 @@ void LightLimiterVersion2Command::Process(const ADSP::CommandListProcessor& proc
     auto statistics{reinterpret_cast<LightLimiterInfo::StatisticsInternal*>(result_state)};
     ApplyLightLimiterEffect(parameter, *state_, effect_enabled, input_buffers, output_buffers,
                             processor.sample_count, statistics);
+
+    const auto channel_count{std::min<size_t>(parameter.channel_count, MaxChannels)};
+    processor.UpdateEffectOutputSilence(std::span(inputs).first(channel_count),
+                                        std::span(outputs).first(channel_count), effect_enabled);
 }
 
 bool LightLimiterVersion2Command::Verify(const ADSP::CommandListProcessor& processor) {
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/effect/biquad_filter.h>
+#include <audio_core/renderer/command/effect/multi_channel_biquad_filter.h>
+
+namespace AudioCore::AudioRenderer {
+
+void MultiChannelBiquadFilterCommand::Dump(
+    [[maybe_unused]] const ADSP::CommandListProcessor& processor, std::string& string) {
+    string += fmt::format("MultiChannelBiquadFilterCommand\n\tchannel_count {}\n\tinputs: ",
+                          channel_count);
+    for (u32 i = 0; i < channel_count; i++) {
+        string += fmt::format("{:02X}, ", inputs[i]);
+    }
+    string += "\n\toutputs: ";
+    for (u32 i = 0; i < channel_count; i++) {
+        string += fmt::format("{:02X}, ", outputs[i]);
+    }
+    string += fmt::format("\n\tneeds_init {} use_float_processing {}\n", needs_init,
+                          use_float_processing);
+}
+
+void MultiChannelBiquadFilterCommand::Process(const ADSP::CommandListProcessor& processor) {
+    if (channel_count > MaxChannels) {
+        LOG_ERROR(Service_Audio, "Too many biquad channels! {}", channel_count);
+        channel_count = MaxChannels;
+    }
+
+    std::array<std::span<const s32>, MaxChannels> input_buffers{};
+    std::array<std::span<s32>, MaxChannels> output_buffers{};
+    std::array<VoiceState::BiquadFilterState*, MaxChannels> states_{};
+
+    for (u32 i = 0; i < channel_count; i++) {
+        input_buffers[i] = processor.mix_buffers.subspan(inputs[i] * processor.sample_count,
+                                                         processor.sample_count);
+        output_buffers[i] = processor.mix_buffers.subspan(outputs[i] * processor.sample_count,
+                                                          processor.sample_count);
+        states_[i] = reinterpret_cast<VoiceState::BiquadFilterState*>(states[i]);
+        if (needs_init) {
+            *states_[i] = {};
+        }
+    }
+
+    ApplyBiquadFilterMultiChannel(std::span(output_buffers).first(channel_count),
+                                  std::span(input_buffers).first(channel_count), b, a,
+                                  std::span(states_).first(channel_count), processor.sample_count,
+                                  use_float_processing);
+
+    for (u32 i = 0; i < channel_count; i++) {
+        processor.SetMixBufferSilent(outputs[i], false);
+    }
+}
+
+bool MultiChannelBiquadFilterCommand::Verify(const ADSP::CommandListProcessor& processor) {
+    return true;
+}
+
+bool CanFilterBiquadChannelsTogether(const BiquadFilterInfo::ParameterVersion1& parameter) {
+    if (parameter.channel_count < 2 || parameter.channel_count > static_cast<s8>(MaxChannels)) {
+        return false;
+    }
+
+    for (s8 channel = 0; channel < parameter.channel_count; channel++) {
+        for (s8 later = static_cast<s8>(channel + 1); later < parameter.channel_count; later++) {
+            if (parameter.outputs[channel] == parameter.inputs[later]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace AudioCore::AudioRenderer
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <array>
+#include <string>
+
+#include <audio_core/renderer/command/icommand.h>
+#include <audio_core/renderer/effect/biquad_filter.h>
+#include <audio_core/common/common_types.h>
+
+namespace AudioCore::AudioRenderer {
+namespace ADSP {
+class CommandListProcessor;
+}
+
+/**
+ * AudioRenderer command for applying one biquad filter to several channels at once, replacing a
+ * BiquadFilterCommand per channel for the biquad filter effect.
+ */
+struct MultiChannelBiquadFilterCommand : ICommand {
+    /**
+     * Print this command's information to a string.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     * @param string    - The string to print into.
+     */
+    void Dump(const ADSP::CommandListProcessor& processor, std::string& string) override;
+
+    /**
+     * Process this command.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     */
+    void Process(const ADSP::CommandListProcessor& processor) override;
+
+    /**
+     * Verify this command's data is valid.
+     *
+     * @param processor - The CommandListProcessor processing this command.
+     * @return True if the command is valid, otherwise false.
+     */
+    bool Verify(const ADSP::CommandListProcessor& processor) override;
+
+    /// Input mix buffer indexes for each channel
+    std::array<s16, MaxChannels> inputs;
+    /// Output mix buffer indexes for each channel
+    std::array<s16, MaxChannels> outputs;
+    /// Feedforward coefficients, shared by all channels
+    std::array<s16, 3> b;
+    /// Feedback coefficients, shared by all channels
+    std::array<s16, 2> a;
+    /// Biquad states for each channel, updated each call
+    std::array<CpuAddr, MaxChannels> states;
+    /// Number of channels to filter
+    u8 channel_count;
+    /// If true, reset the states
+    bool needs_init;
+    /// If true, use float processing rather than int
+    bool use_float_processing;
+};
+
+/**
+ * Check if a biquad filter effect's channels can be filtered side by side in one command.
+ * Per-channel commands run one after another, so a channel writing into a buffer that a later
+ * channel reads would see that later channel filter the already-filtered samples.
+ *
+ * @param parameter - The biquad filter effect parameters.
+ * @return True if a MultiChannelBiquadFilterCommand gives the same result.
+ */
+bool CanFilterBiquadChannelsTogether(const BiquadFilterInfo::ParameterVersion1& parameter);
+
+} // namespace AudioCore::AudioRenderer
@@ -25,17 +25,20 @@ void MultiTapBiquadFilterCommand::Process(const ADSP::CommandListProcessor& proc
     auto output_buffer{
         processor.mix_buffers.subspan(output * processor.sample_count, processor.sample_count)};
 
-    // TODO: Fix this, currently just applies the filter to the input twice,
-    // and doesn't chain the biquads together at all.
+    std::array<VoiceState::BiquadFilterState*, MaxBiquadFilters> states_{};
     for (u32 i = 0; i < filter_tap_count; i++) {
-        auto state{reinterpret_cast<VoiceState::BiquadFilterState*>(states[i])};
+        states_[i] = reinterpret_cast<VoiceState::BiquadFilterState*>(states[i]);
         if (needs_init[i]) {
-            *state = {};
+            *states_[i] = {};
         }
-
-        ApplyBiquadFilterFloat(output_buffer, input_buffer, biquads[i].b, biquads[i].a, *state,
-                               processor.sample_count);
     }
+
+    // The taps are applied in series, each tap filtering the previous tap's output.
+    ApplyBiquadFilterCascade(output_buffer, input_buffer,
+                             std::span(biquads).first(filter_tap_count),
+                             std::span(states_).first(filter_tap_count), processor.sample_count,
+                             true);
+    processor.SetMixBufferSilent(output, false);
 }
 
 bool MultiTapBiquadFilterCommand::Verify(const ADSP::CommandListProcessor& processor) {
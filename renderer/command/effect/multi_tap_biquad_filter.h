@@ -16,7 +16,8 @@ class CommandListProcessor;
 }
 
 /**
- * AudioRenderer command for applying multiple biquads at once.
+ * AudioRenderer command for applying multiple biquads at once. The biquads are cascaded, each one
+ * filtering the previous one's output, the same as a BiquadFilterCommand per biquad.
  */
 struct MultiTapBiquadFilterCommand : ICommand {
     /**
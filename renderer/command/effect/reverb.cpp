@@ -397,6 +397,32 @@ static void ApplyReverbEffect(const ReverbInfo::ParameterVersion2& params, Rever
     }
 }
 
+/**
+ * Check if a delay line holds only zeroes.
+ *
+ * @param line - Delay line to check.
+ * @return True if the line is silent.
+ */
+static bool IsDelayLineSilent(const ReverbInfo::ReverbDelayLine& line) {
+    return std::ranges::all_of(line.buffer,
+                               [](const auto& sample) { return sample.to_raw() == 0; });
+}
+
+/**
+ * Check if a reverb has nothing left to play out. Silent input will then produce silent output,
+ * and leave the state as it is.
+ *
+ * @param state - State to check.
+ * @return True if all delay lines and feedback states are zero.
+ */
+static bool IsReverbTailSilent(const ReverbInfo::State& state) {
+    return IsDelayLineSilent(state.pre_delay_line) && IsDelayLineSilent(state.center_delay_line) &&
+           std::ranges::all_of(state.decay_delay_lines, IsDelayLineSilent) &&
+           std::ranges::all_of(state.fdn_delay_lines, IsDelayLineSilent) &&
+           std::ranges::all_of(state.prev_feedback_output,
+                               [](const auto& sample) { return sample.to_raw() == 0; });
+}
+
 void ReverbCommand::Dump([[maybe_unused]] const ADSP::CommandListProcessor& processor,
                          std::string& string) {
     string += fmt::format(
@@ -432,8 +458,38 @@ void ReverbCommand::Process(const ADSP::CommandListProcessor& processor) {
             InitializeReverbEffect(parameter, *state_, workbuffer, long_size_pre_delay_supported);
         }
     }
+
+    const auto channel_count{std::min<size_t>(parameter.channel_count, MaxChannels)};
+    const auto input_indexes{std::span(inputs).first(channel_count)};
+    const auto output_indexes{std::span(outputs).first(channel_count)};
+    const bool inputs_silent{processor.AreMixBuffersSilent(input_indexes)};
+
+    // Once the tail has played out, silent input only produces silence, skip the processing.
+    if (effect_enabled && state_->tail_silent && inputs_silent) {
+        for (const auto output : output_indexes) {
+            processor.SilenceMixBuffer(output);
+        }
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+    state_->tail_silent = false;
+
     ApplyReverbEffect(parameter, *state_, effect_enabled, input_buffers, output_buffers,
                       processor.sample_count);
+
+    processor.UpdateEffectOutputSilence(input_indexes, output_indexes, effect_enabled);
+    if (effect_enabled && inputs_silent) {
+        const bool outputs_silent{std::all_of(
+            output_indexes.begin(), output_indexes.end(),
+            [&processor](s16 output) { return processor.UpdateMixBufferSilence(output); })};
+        // Checking the tail reads the whole state, so while it plays out only check every few
+        // frames. Processing the silent frames in between gives the same output.
+        if (outputs_silent &&
+            ++state_->tail_check_frames >= ADSP::CommandListProcessor::EffectTailCheckInterval) {
+            state_->tail_check_frames = 0;
+            state_->tail_silent = IsReverbTailSilent(*state_);
+        }
+    }
 }
 
 bool ReverbCommand::Verify(const ADSP::CommandListProcessor& processor) {
@@ -43,6 +43,8 @@ enum class CommandId : u8 {
     /* 0x1C */ MultiTapBiquadFilter,
     /* 0x1D */ Capture,
     /* 0x1E */ Compressor,
+    /* 0x1F */ MultiChannelBiquadFilter,
+    /* 0x20 */ AdvanceVoicePosition,
 };
 
 constexpr u32 CommandMagic{0xCAFEBABE};
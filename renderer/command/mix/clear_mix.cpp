@@ -15,6 +15,7 @@ void ClearMixBufferCommand::Dump([[maybe_unused]] const ADSP::CommandListProcess
 
 void ClearMixBufferCommand::Process(const ADSP::CommandListProcessor& processor) {
     memset(processor.mix_buffers.data(), 0, processor.mix_buffers.size_bytes());
+    processor.SetAllMixBuffersSilent(true);
 }
 
 bool ClearMixBufferCommand::Verify(const ADSP::CommandListProcessor& processor) {
@@ -17,7 +17,14 @@ void CopyMixBufferCommand::Process(const ADSP::CommandListProcessor& processor)
                                               processor.sample_count)};
     auto input{processor.mix_buffers.subspan(input_index * processor.sample_count,
                                              processor.sample_count)};
+    if (processor.IsMixBufferSilent(input_index)) {
+        processor.SilenceMixBuffer(output_index);
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+
     std::memcpy(output.data(), input.data(), processor.sample_count * sizeof(s32));
+    processor.SetMixBufferSilent(output_index, false);
 }
 
 bool CopyMixBufferCommand::Verify(const ADSP::CommandListProcessor& processor) {
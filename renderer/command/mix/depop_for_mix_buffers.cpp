@@ -53,6 +53,7 @@ void DepopForMixBuffersCommand::Process(const ADSP::CommandListProcessor& proces
                                                             processor.sample_count)};
             depop_buff[index] =
                 ApplyDepopMix(input_buffer, depop_sample, decay, processor.sample_count);
+            processor.SetMixBufferSilent(static_cast<s32>(index), false);
         }
     }
 }
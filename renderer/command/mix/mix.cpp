@@ -48,6 +48,13 @@ void MixCommand::Process(const ADSP::CommandListProcessor& processor) {
         return;
     }
 
+    // Likewise if the input is silent.
+    if (processor.IsMixBufferSilent(input_index)) {
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+    processor.SetMixBufferSilent(output_index, false);
+
     switch (precision) {
     case 15:
         ApplyMix<15>(output, input, volume, processor.sample_count);
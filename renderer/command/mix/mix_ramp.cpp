@@ -58,6 +58,14 @@ void MixRampCommand::Process(const ADSP::CommandListProcessor& processor) {
         return;
     }
 
+    // Likewise if the input is silent, the last mixed sample is then 0 too.
+    if (processor.IsMixBufferSilent(input_index)) {
+        *prev_sample_ptr = 0;
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+    processor.SetMixBufferSilent(output_index, false);
+
     switch (precision) {
     case 15:
         *prev_sample_ptr =
@@ -39,6 +39,13 @@ void MixRampGroupedCommand::Process(const ADSP::CommandListProcessor& processor)
                 continue;
             }
 
+            if (processor.IsMixBufferSilent(inputs[i])) {
+                prev_samples[i] = 0;
+                processor.MarkSilentShortCircuit();
+                continue;
+            }
+            processor.SetMixBufferSilent(outputs[i], false);
+
             switch (precision) {
             case 15:
                 last_sample =
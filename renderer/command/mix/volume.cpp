@@ -45,6 +45,14 @@ void VolumeCommand::Process(const ADSP::CommandListProcessor& processor) {
         return;
     }
 
+    // A silent input stays silent whatever the gain.
+    if (processor.IsMixBufferSilent(input_index)) {
+        processor.SilenceMixBuffer(output_index);
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+    processor.SetMixBufferSilent(output_index, false);
+
     auto output{processor.mix_buffers.subspan(output_index * processor.sample_count,
                                               processor.sample_count)};
     auto input{processor.mix_buffers.subspan(input_index * processor.sample_count,
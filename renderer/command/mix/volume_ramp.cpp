@@ -62,6 +62,14 @@ void VolumeRampCommand::Process(const ADSP::CommandListProcessor& processor) {
         return;
     }
 
+    // A silent input stays silent whatever the gain.
+    if (processor.IsMixBufferSilent(input_index)) {
+        processor.SilenceMixBuffer(output_index);
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+    processor.SetMixBufferSilent(output_index, false);
+
     switch (precision) {
     case 15:
         ApplyLinearEnvelopeGain<15>(output, input, prev_volume, ramp, processor.sample_count);
@@ -46,6 +46,15 @@ void DownMix6chTo2chCommand::Process(const ADSP::CommandListProcessor& processor
     auto out_back_right{
         processor.mix_buffers.subspan(outputs[5] * processor.sample_count, processor.sample_count)};
 
+    // Silent inputs downmix to silence, every output just needs zeroing.
+    if (processor.AreMixBuffersSilent(inputs)) {
+        for (const auto output : outputs) {
+            processor.SilenceMixBuffer(output);
+        }
+        processor.MarkSilentShortCircuit();
+        return;
+    }
+
     for (u32 i = 0; i < processor.sample_count; i++) {
         const auto left_sample{(in_front_left[i] * down_mix_coeff[0] +
                                 in_center[i] * down_mix_coeff[1] + in_lfe[i] * down_mix_coeff[2] +
@@ -65,6 +74,12 @@ void DownMix6chTo2chCommand::Process(const ADSP::CommandListProcessor& processor
     std::memset(out_lfe.data(), 0, out_lfe.size_bytes());
     std::memset(out_back_left.data(), 0, out_back_left.size_bytes());
     std::memset(out_back_right.data(), 0, out_back_right.size_bytes());
+
+    processor.SetMixBufferSilent(outputs[0], false);
+    processor.SetMixBufferSilent(outputs[1], false);
+    for (u32 i = 2; i < MaxChannels; i++) {
+        processor.SetMixBufferSilent(outputs[i], true);
+    }
 }
 
 bool DownMix6chTo2chCommand::Verify(const ADSP::CommandListProcessor& processor) {
@@ -1,10 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
-#include <vector>
+#include <array>
 
 #include <audio_core/renderer/adsp/command_list_processor.h>
 #include <audio_core/renderer/command/sink/circular_buffer.h>
+#include <audio_core/sink/channel_converter.h>
 #include <core/memory.h>
 
 namespace AudioCore::AudioRenderer {
@@ -21,20 +22,30 @@ void CircularBufferSinkCommand::Dump([[maybe_unused]] const ADSP::CommandListPro
 }
 
 void CircularBufferSinkCommand::Process(const ADSP::CommandListProcessor& processor) {
-    constexpr s32 min{std::numeric_limits<s16>::min()};
-    constexpr s32 max{std::numeric_limits<s16>::max()};
-
-    std::vector<s16> output(processor.sample_count);
+    // Channels are written one after another, so clamp them all in one pass and write each run
+    // of channels which doesn't hit the end of the ring with a single copy.
+    std::array<s16, MaxChannels * TargetSampleCount> output;
+    const auto sample_count{std::min<u32>(processor.sample_count, TargetSampleCount)};
     for (u32 channel = 0; channel < input_count; channel++) {
-        auto input{processor.mix_buffers.subspan(inputs[channel] * processor.sample_count,
-                                                 processor.sample_count)};
-        for (u32 sample_index = 0; sample_index < processor.sample_count; sample_index++) {
-            output[sample_index] = static_cast<s16>(std::clamp(input[sample_index], min, max));
-        }
+        const std::array<const s32*, 1> input{
+            &processor.mix_buffers[inputs[channel] * processor.sample_count]};
+        Sink::InterleaveSamples(input, std::span(output).subspan(channel * sample_count),
+                                sample_count, 1.0f);
+    }
 
-        processor.memory->WriteBlockUnsafe(address + pos, output.data(),
-                                           output.size() * sizeof(s16));
-        pos += static_cast<u32>(processor.sample_count * sizeof(s16));
+    const auto block_size{static_cast<u32>(sample_count * sizeof(s16))};
+    u32 channel{0};
+    while (channel < input_count) {
+        const auto start_pos{pos};
+        const auto first_channel{channel};
+        do {
+            pos += block_size;
+            channel++;
+        } while (channel < input_count && pos < size);
+
+        processor.memory->WriteBlockUnsafe(address + start_pos,
+                                           &output[first_channel * sample_count],
+                                           (channel - first_channel) * block_size);
         if (pos >= size) {
             pos = 0;
         }
@@ -1,10 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
-#include <algorithm>
+#include <array>
+#include <vector>
 
 #include <audio_core/renderer/adsp/command_list_processor.h>
 #include <audio_core/renderer/command/sink/device.h>
+#include <audio_core/sink/channel_converter.h>
 #include <audio_core/sink/sink.h>
 
 namespace AudioCore::AudioRenderer {
@@ -20,9 +22,6 @@ void DeviceSinkCommand::Dump([[maybe_unused]] const ADSP::CommandListProcessor&
 }
 
 void DeviceSinkCommand::Process(const ADSP::CommandListProcessor& processor) {
-    constexpr s32 min = std::numeric_limits<s16>::min();
-    constexpr s32 max = std::numeric_limits<s16>::max();
-
     auto stream{processor.GetOutputSinkStream()};
     stream->SetSystemChannels(input_count);
 
@@ -31,21 +30,30 @@ void DeviceSinkCommand::Process(const ADSP::CommandListProcessor& processor) {
         .frames_played{0},
         .tag{0},
         .consumed{false},
+        .samples{nullptr},
     };
 
-    std::vector<s16> samples(out_buffer.frames * input_count);
-
+    std::array<const s32*, MaxChannels> channel_inputs{};
     for (u32 channel = 0; channel < input_count; channel++) {
-        const auto offset{inputs[channel] * out_buffer.frames};
-
-        for (u32 index = 0; index < out_buffer.frames; index++) {
-            samples[index * input_count + channel] =
-                static_cast<s16>(std::clamp(sample_buffer[offset + index], min, max));
-        }
+        channel_inputs[channel] = &sample_buffer[inputs[channel] * out_buffer.frames];
     }
+    const std::span<const s32* const> planar_inputs{channel_inputs.data(), input_count};
 
-    out_buffer.tag = reinterpret_cast<u64>(samples.data());
-    stream->AppendBuffer(out_buffer, samples);
+    if (input_count == stream->GetDeviceChannels()) {
+        // No channel conversion is needed, so clamp, apply the output volume and interleave
+        // straight into the stream's sample ring in one pass, rather than using AppendBuffer.
+        // The reservation may be truncated, the buffer only covers the frames committed.
+        const auto out{stream->ReserveBuffer(out_buffer.frames * input_count)};
+        out_buffer.frames = out.size() / input_count;
+        Sink::InterleaveSamples(planar_inputs, out, out_buffer.frames, stream->GetOutputVolume());
+        stream->CommitBuffer(out_buffer, out_buffer.frames * input_count);
+    } else {
+        std::vector<s16> samples(out_buffer.frames * input_count);
+        Sink::InterleaveSamples(planar_inputs, samples, out_buffer.frames, 1.0f);
+
+        out_buffer.tag = reinterpret_cast<u64>(samples.data());
+        stream->AppendBuffer(out_buffer, samples);
+    }
 
     if (stream->IsPaused()) {
         stream->Start();
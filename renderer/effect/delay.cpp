@@ -1,7 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
+#include <bit>
+
 #include <audio_core/renderer/effect/delay.h>
+#include <audio_core/common/alignment.h>
+#include <audio_core/common/log.h>
 
 namespace AudioCore::AudioRenderer {
 
@@ -31,6 +36,7 @@ void DelayInfo::Update(BehaviorInfo::ErrorInfo& error_info, const InParameterVer
             params->state = ParameterState::Initialized;
             buffer_unmapped = !pool_mapper.TryAttachBuffer(
                 error_info, workbuffers[0], in_params.workbuffer, in_params.workbuffer_size);
+            UpdateHostBufferSize();
             return;
         }
     }
@@ -64,6 +70,7 @@ void DelayInfo::Update(BehaviorInfo::ErrorInfo& error_info, const InParameterVer
             params->state = ParameterState::Initialized;
             buffer_unmapped = !pool_mapper.TryAttachBuffer(
                 error_info, workbuffers[0], in_params.workbuffer, in_params.workbuffer_size);
+            UpdateHostBufferSize();
             return;
         }
     }
@@ -90,4 +97,49 @@ CpuAddr DelayInfo::GetWorkbuffer(s32 index) {
     return GetSingleBuffer(index);
 }
 
+u32 DelayInfo::GetDelaySampleCount(const ParameterVersion1& params) {
+    Common::FixedPoint<32, 32> sample_count_max{0.064f};
+    sample_count_max *= params.sample_rate.to_int_floor() * params.delay_time_max;
+
+    Common::FixedPoint<18, 14> delay_time{params.delay_time};
+    delay_time *= params.sample_rate / 1000;
+    Common::FixedPoint<32, 32> sample_count{delay_time};
+
+    if (sample_count > sample_count_max) {
+        sample_count = sample_count_max;
+    }
+    return std::max(static_cast<u32>(std::max<s64>(sample_count.to_int_floor(), 0)), 1U);
+}
+
+u32 DelayInfo::GetDelayLineSize(const ParameterVersion1& params) {
+    // Past this, lines are only sized for the current delay rather than delay_time_max.
+    constexpr u64 MaxLineSize{1 << 20};
+    const u64 max_sample_count{static_cast<u64>(params.delay_time_max) *
+                               std::max(params.sample_rate.to_int_floor(), 0) / 1000};
+    return std::bit_ceil(std::max(GetDelaySampleCount(params),
+                                  static_cast<u32>(std::min(max_sample_count, MaxLineSize))));
+}
+
+u64 DelayInfo::GetRequiredWorkbufferSize(const ParameterVersion1& params, const CpuAddr buffer) {
+    const u64 channel_count{
+        std::min<u16>(std::max(params.channel_count, params.channel_count_max), MaxChannels)};
+    return channel_count * GetDelayLineSize(params) * sizeof(Common::FixedPoint<50, 14>) +
+           Common::AlignUp(buffer, 0x40) - buffer;
+}
+
+void DelayInfo::UpdateHostBufferSize() {
+    const auto params{reinterpret_cast<ParameterVersion1*>(parameter.data())};
+    const auto workbuffer{workbuffers[0].GetReference(false)};
+    host_buffer_size = 0;
+    if (workbuffer != 0 &&
+        GetRequiredWorkbufferSize(*params, workbuffer) <= GetSingleBufferSize()) {
+        return;
+    }
+
+    // The lines hold 8-byte samples, so games usually size the workbuffer too small for them.
+    host_buffer_size = GetRequiredWorkbufferSize(*params, 0);
+    LOG_DEBUG(Service_Audio, "Delay workbuffer holds {:08X} bytes, using {:08X} of host memory",
+              GetSingleBufferSize(), host_buffer_size);
+}
+
 } // namespace AudioCore::AudioRenderer
@@ -4,7 +4,6 @@
 #pragma once
 
 #include <array>
-#include <vector>
 
 #include <audio_core/common/common.h>
 #include <audio_core/renderer/effect/effect_info_base.h>
@@ -55,18 +54,23 @@ public:
 
     struct DelayLine {
         Common::FixedPoint<50, 14> Read() const {
-            return buffer[buffer_pos];
+            return buffer[(buffer_pos - delay) & buffer_mask];
         }
 
         void Write(const Common::FixedPoint<50, 14> value) {
             buffer[buffer_pos] = value;
-            buffer_pos = static_cast<u32>((buffer_pos + 1) % buffer.size());
+            buffer_pos = (buffer_pos + 1) & buffer_mask;
         }
 
         s32 sample_count_max{};
         s32 sample_count{};
-        std::vector<Common::FixedPoint<50, 14>> buffer{};
+        /// Power of two sized ring, holding at least delay samples
+        Common::FixedPoint<50, 14>* buffer{};
+        /// Size of the ring minus one
+        u32 buffer_mask{};
         u32 buffer_pos{};
+        /// Distance between the read and write positions, at least 1
+        u32 delay{};
         Common::FixedPoint<18, 14> decay_rate{};
     };
 
@@ -79,6 +83,10 @@ public:
         /* 0x0BC */ Common::FixedPoint<18, 14> lowpass_gain;
         /* 0x0C0 */ Common::FixedPoint<18, 14> lowpass_feedback_gain;
         /* 0x0C4 */ std::array<Common::FixedPoint<50, 14>, MaxChannels> lowpass_z;
+        /// True once the delay lines and lowpass have decayed to zero, see DelayCommand::Process
+        bool tail_silent;
+        /// Silent frames processed since the tail was last checked
+        u32 tail_check_frames;
     };
     static_assert(sizeof(State) <= sizeof(EffectInfoBase::State),
                   "DelayInfo::State has the wrong size!");
@@ -130,6 +138,41 @@ public:
      * @return Address of the buffer.
      */
     CpuAddr GetWorkbuffer(s32 index) override;
+
+    /**
+     * Get the number of samples each channel is delayed by, for the given parameters.
+     *
+     * @param params - Parameters to check.
+     * @return Number of samples, at least 1.
+     */
+    static u32 GetDelaySampleCount(const ParameterVersion1& params);
+
+    /**
+     * Get the number of samples each delay line holds. This is enough for delay_time_max, so a
+     * reinitialization with a longer delay can reuse the lines, rounded up to a power of two so
+     * the lines can be indexed with a mask.
+     *
+     * @param params - Parameters to check.
+     * @return Number of samples.
+     */
+    static u32 GetDelayLineSize(const ParameterVersion1& params);
+
+    /**
+     * Get the memory the delay lines need for the given parameters, including the alignment of
+     * the lines within the given buffer.
+     *
+     * @param params - Parameters to check.
+     * @param buffer - Address of the buffer the lines are placed in.
+     * @return Size in bytes.
+     */
+    static u64 GetRequiredWorkbufferSize(const ParameterVersion1& params, CpuAddr buffer);
+
+private:
+    /**
+     * Request host memory for the delay lines if the workbuffer assigned to this effect can't
+     * hold them, see EffectInfoBase::GetHostBufferSize.
+     */
+    void UpdateHostBufferSize();
 };
 
 } // namespace AudioCore::AudioRenderer
@@ -1,7 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <bit>
+
 #include <audio_core/renderer/effect/effect_context.h>
+#include <audio_core/common/alignment.h>
 
 namespace AudioCore::AudioRenderer {
 
@@ -14,6 +17,7 @@ void EffectContext::Initialize(std::span<EffectInfoBase> effect_infos_, const u3
     result_states_cpu = result_states_cpu_;
     result_states_dsp = result_states_dsp_;
     dsp_state_count = dsp_state_count_;
+    host_buffers.assign(effect_count, {});
 }
 
 EffectInfoBase& EffectContext::GetInfo(const u32 index) {
@@ -28,6 +32,20 @@ EffectResultState& EffectContext::GetDspSharedResultState(const u32 index) {
     return result_states_dsp[index];
 }
 
+std::span<u8> EffectContext::GetHostBuffer(const u32 index, const u64 size) {
+    auto& host_buffer{host_buffers[index]};
+    if (host_buffer.size() >= size) {
+        return host_buffer;
+    }
+
+    // Round up, so an effect growing step by step only retires a bounded amount of memory.
+    const auto buffer_size{std::bit_ceil(size)};
+    auto& storage{host_buffer_storage.emplace_back(std::make_unique<u8[]>(buffer_size + 0x40))};
+    const auto address{reinterpret_cast<uintptr_t>(storage.get())};
+    host_buffer = {reinterpret_cast<u8*>(Common::AlignUp(address, 0x40)), buffer_size};
+    return host_buffer;
+}
+
 u32 EffectContext::GetCount() const {
     return effect_count;
 }
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <memory>
 #include <span>
+#include <vector>
 
 #include <audio_core/renderer/effect/effect_info_base.h>
 #include <audio_core/renderer/effect/effect_result_state.h>
@@ -46,6 +48,18 @@ public:
      */
     EffectResultState& GetDspSharedResultState(const u32 index);
 
+    /**
+     * Get host memory for an effect whose workbuffer is too small.
+     * Memory is only ever added, and kept until the context is destroyed, so the AudioRenderer
+     * can't be left rendering into memory freed by a later update. An effect at the same index
+     * reuses the previous memory if it's big enough.
+     *
+     * @param index - Index of the effect.
+     * @param size  - Size needed, in bytes.
+     * @return The memory, 0x40-aligned and at least size bytes.
+     */
+    std::span<u8> GetHostBuffer(u32 index, u64 size);
+
     /**
      * Get the number of effects in this context
      * @return The number of effects
@@ -70,6 +84,10 @@ private:
     std::span<EffectResultState> result_states_dsp{};
     /// Number of result states in the workbuffers
     size_t dsp_state_count{};
+    /// Host memory for each effect, see GetHostBuffer
+    std::vector<std::span<u8>> host_buffers{};
+    /// All host memory handed out, including memory since replaced by a larger buffer
+    std::vector<std::unique_ptr<u8[]>> host_buffer_storage{};
 };
 
 } // namespace AudioCore::AudioRenderer
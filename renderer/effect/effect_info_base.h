@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <span>
 
 #include <audio_core/common/common.h>
 #include <audio_core/renderer/behavior/behavior_info.h>
@@ -120,6 +121,8 @@ public:
         for (auto& workbuffer : workbuffers) {
             workbuffer.Setup(CpuAddr(0), 0);
         }
+        host_buffer_size = 0;
+        host_buffer = {};
     }
 
     /**
@@ -367,6 +370,42 @@ public:
         return 0;
     }
 
+    /**
+     * Get the size of the first workbuffer assigned to this effect.
+     *
+     * @return Size of the buffer.
+     */
+    u64 GetSingleBufferSize() const {
+        return workbuffers[0].GetSize();
+    }
+
+    /**
+     * Get the size of host memory this effect needs, because its workbuffer is too small.
+     *
+     * @return Size in bytes, 0 if the workbuffer is enough.
+     */
+    u64 GetHostBufferSize() const {
+        return host_buffer_size;
+    }
+
+    /**
+     * Get the host memory assigned to this effect, see EffectContext::GetHostBuffer.
+     *
+     * @return The host memory, empty if none is assigned.
+     */
+    std::span<u8> GetHostBuffer() const {
+        return host_buffer;
+    }
+
+    /**
+     * Assign host memory to this effect, see EffectContext::GetHostBuffer.
+     *
+     * @param buffer - The host memory, at least GetHostBufferSize bytes.
+     */
+    void SetHostBuffer(std::span<u8> buffer) {
+        host_buffer = buffer;
+    }
+
     /**
      * Get the send buffer info, used by Aux and Capture.
      *
@@ -426,6 +465,10 @@ protected:
     CpuAddr return_buffer_info{};
     /// Aux/Capture buffer for writing
     CpuAddr return_buffer{};
+    /// Size of host memory needed in place of the workbuffer, see GetHostBufferSize
+    u64 host_buffer_size{};
+    /// Host memory owned by the EffectContext, used when the workbuffer is too small
+    std::span<u8> host_buffer{};
     /// Parameters of this effect
     std::array<u8, sizeof(InParameterVersion2)> parameter{};
     /// State of this effect used by the AudioRenderer across calls
@@ -145,6 +145,11 @@ public:
         std::array<std::array<f32, 3>, MaxDelayLines> lowpass_coeff;
         std::array<f32, MaxDelayLines> shelf_filter;
         f32 dry_gain;
+        /// True once the delay lines and filters have decayed to zero,
+        /// see I3dl2ReverbCommand::Process
+        bool tail_silent;
+        /// Silent frames processed since the tail was last checked
+        u32 tail_check_frames;
     };
     static_assert(sizeof(State) <= sizeof(EffectInfoBase::State),
                   "I3dl2ReverbInfo::State is too large!");
@@ -134,6 +134,10 @@ public:
         std::array<Common::FixedPoint<50, 14>, MaxDelayLines> hf_decay_gain;
         std::array<Common::FixedPoint<50, 14>, MaxDelayLines> hf_decay_prev_gain;
         std::array<Common::FixedPoint<50, 14>, MaxDelayLines> prev_feedback_output;
+        /// True once the delay lines and feedback have decayed to zero, see ReverbCommand::Process
+        bool tail_silent;
+        /// Silent frames processed since the tail was last checked
+        u32 tail_check_frames;
     };
     static_assert(sizeof(State) <= sizeof(EffectInfoBase::State),
                   "ReverbInfo::State is too large!");
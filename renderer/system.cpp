@@ -8,6 +8,7 @@
 #include <audio_core/common/audio_renderer_parameter.h>
 #include <audio_core/common/common.h>
 #include <audio_core/common/feature_support.h>
+#include <audio_core/common/settings.h>
 #include <audio_core/common/workbuffer_allocator.h>
 #include <audio_core/renderer/adsp/adsp.h>
 #include <audio_core/renderer/behavior/info_updater.h>
@@ -28,13 +29,26 @@
 #include <audio_core/renderer/voice/voice_info.h>
 #include <audio_core/renderer/voice/voice_state.h>
 #include <audio_core/common/alignment.h>
+#include <audio_core/common/microprofile.h>
 #include <core/core.h>
 #include <core/core_timing.h>
 #include <core/hle/kernel/k_event.h>
 #include <core/hle/kernel/k_transfer_memory.h>
 #include <core/memory.h>
 
+MICROPROFILE_DEFINE(Audio_GenerateCommand, "Audio", "Generate Command List",
+                    MP_RGB(60, 19, 97));
+
 namespace AudioCore::AudioRenderer {
+namespace {
+u64 GetCommandBufferSize(const BehaviorInfo& behavior,
+                         const AudioRendererParameterInternal& params) {
+    if (behavior.IsVariadicCommandBufferSizeSupported()) {
+        return CommandGenerator::CalculateCommandBufferSize(behavior, params);
+    }
+    return 0x18000;
+}
+} // namespace
 
 u64 System::GetWorkBufferSize(const AudioRendererParameterInternal& params) {
     BehaviorInfo behavior;
@@ -84,11 +98,7 @@ u64 System::GetWorkBufferSize(const AudioRendererParameterInternal& params) {
         size += Common::AlignUp(perf_size * (params.perf_frames + 1) + 0xC0, 0x100);
     }
 
-    if (behavior.IsVariadicCommandBufferSizeSupported()) {
-        size += CommandGenerator::CalculateCommandBufferSize(behavior, params) + (0x40 - 1) * 2;
-    } else {
-        size += 0x18000 + (0x40 - 1) * 2;
-    }
+    size += GetCommandBufferSize(behavior, params) + (0x40 - 1) * 2;
 
     size = Common::AlignUp(size, 0x1000);
     return size;
@@ -97,6 +107,12 @@ u64 System::GetWorkBufferSize(const AudioRendererParameterInternal& params) {
 System::System(Core::System& core_, KernelShim::KEvent* adsp_rendered_event_)
     : core{core_}, adsp{core.AudioCore().GetADSP()}, adsp_rendered_event{adsp_rendered_event_} {}
 
+System::~System() {
+    if (workbuffer_locked) {
+        Common::UnlockMemory(workbuffer.get(), workbuffer_size);
+    }
+}
+
 Result System::Initialize(const AudioRendererParameterInternal& params,
                           KernelShim::KTransferMemory* transfer_memory, u64 transfer_memory_size,
                           u32 process_handle_, u64 applet_resource_user_id_, s32 session_id_) {
@@ -132,8 +148,22 @@ Result System::Initialize(const AudioRendererParameterInternal& params,
 
     // Note: We're not actually using the transfer memory because it's a pain to code for.
     // Allocate the memory normally instead and hope the game doesn't try to read anything back
-    workbuffer = std::make_unique<u8[]>(transfer_memory_size);
-    workbuffer_size = transfer_memory_size;
+    if (workbuffer_locked) {
+        Common::UnlockMemory(workbuffer.get(), workbuffer_size);
+    }
+    // Performance metrics are written by the AudioRenderer into the frame generation would be
+    // starting, so they can't be pipelined.
+    pipelined = Settings::values.audio_pipelined_command_generation && params.perf_frames == 0;
+
+    // A pipelined system generates into a second command buffer while the first is processed.
+    const u64 extra_command_buffer_size{
+        pipelined ? Common::AlignUp(GetCommandBufferSize(behavior, params) + 0x40, 0x1000) : 0};
+    workbuffer_size = transfer_memory_size + extra_command_buffer_size;
+    workbuffer = std::make_unique<u8[]>(workbuffer_size);
+
+    // Rendering touches all of the workbuffer every frame, so keep it from being paged out.
+    workbuffer_locked = Settings::values.audio_lock_memory &&
+                        Common::LockMemory(workbuffer.get(), workbuffer_size);
 
     PoolMapper pool_mapper(process_handle, false);
     pool_mapper.InitializeSystemPool(memory_pool_info, workbuffer.get(), workbuffer_size);
@@ -335,6 +365,7 @@ Result System::Initialize(const AudioRendererParameterInternal& params,
 
     voice_context.Initialize(sorted_voice_infos, voice_infos, voice_channel_resources,
                              voice_cpu_states, voice_dsp_states, params.voices);
+    voice_context.SetDeferDspSharedUpdates(pipelined);
 
     if (params.perf_frames > 0) {
         const auto perf_workbuffer_size{
@@ -358,12 +389,24 @@ Result System::Initialize(const AudioRendererParameterInternal& params,
 
     allocator.Align(0x40);
     command_workbuffer_size = allocator.GetRemainingSize();
+    if (pipelined) {
+        command_workbuffer_size = Common::AlignDown(command_workbuffer_size / 2, 0x40);
+        next_command_workbuffer = allocator.Allocate<u8>(command_workbuffer_size, 0x40);
+        if (next_command_workbuffer.empty()) {
+            return Service::Audio::ResultInsufficientBuffer;
+        }
+    }
     command_workbuffer = allocator.Allocate<u8>(command_workbuffer_size, 0x40);
     if (command_workbuffer.empty()) {
         return Service::Audio::ResultInsufficientBuffer;
     }
 
     command_buffer_size = 0;
+    next_command_buffer_size = 0;
+    next_command_prepared = false;
+    pipeline_paused = false;
+    resent_remaining_commands = false;
+    next_pools_in_use.assign(pipelined ? memory_pool_count : 0, false);
     reset_command_buffers = true;
 
     // nn::audio::dsp::FlushDataCache(transferMemory, transferMemorySize);
@@ -390,6 +433,12 @@ Result System::Initialize(const AudioRendererParameterInternal& params,
                                                                      mix_buffer_count);
     }
 
+    if (Settings::values.adaptive_processing_time_estimation) {
+        command_processing_time_estimator =
+            std::make_unique<CommandProcessingTimeEstimatorAdaptive>(
+                std::move(command_processing_time_estimator), sample_count);
+    }
+
     initialized = true;
     return ResultSuccess;
 }
@@ -590,8 +639,31 @@ void System::SendCommandToDsp() {
             u64 command_size{0};
 
             if (remaining_command_count) {
+                // A pipelined list prepared meanwhile is kept until this one finishes, as
+                // generating it already advanced the voice and effect states. No more are
+                // prepared until the AudioRenderer keeps up again, so none are held for longer.
                 adsp_behind = true;
+                pipeline_paused = pipelined;
+                resent_remaining_commands = true;
                 command_size = command_buffer_size;
+            } else if (pipelined) {
+                if (!resent_remaining_commands) {
+                    pipeline_paused = false;
+                }
+                resent_remaining_commands = false;
+                if (!next_command_prepared) {
+                    GenerateNextCommand();
+                }
+                // The previous list has been processed, so the AudioRenderer states can be
+                // updated and read back.
+                voice_context.ApplyDeferredDspSharedUpdates();
+                UpdateStateByDspShared();
+                for (u32 i = 0; i < memory_pool_count; i++) {
+                    memory_pool_workbuffer[i].SetUsed(next_pools_in_use[i]);
+                }
+                std::swap(command_workbuffer, next_command_workbuffer);
+                command_size = next_command_buffer_size;
+                next_command_prepared = false;
             } else {
                 command_size = GenerateCommand(command_workbuffer, command_workbuffer_size);
             }
@@ -620,6 +692,7 @@ void System::SendCommandToDsp() {
                 .reset_buffers{reset_command_buffers},
                 .applet_resource_user_id{applet_resource_user_id},
                 .render_time_taken{adsp.GetRenderTimeTaken(session_id)},
+                .time_estimator{command_processing_time_estimator.get()},
             };
 
             adsp.SendCommandBuffer(session_id, command_buffer);
@@ -635,8 +708,44 @@ void System::SendCommandToDsp() {
     }
 }
 
+void System::PrepareNextCommand() {
+    std::scoped_lock l{lock};
+
+    if (initialized && active && pipelined && !pipeline_paused && !next_command_prepared) {
+        GenerateNextCommand();
+    }
+}
+
+void System::GenerateNextCommand() {
+    // Generation marks only the memory pools the new list uses, but those the list being processed
+    // uses must stay attached until it finishes.
+    for (u32 i = 0; i < memory_pool_count; i++) {
+        next_pools_in_use[i] = memory_pool_workbuffer[i].IsUsed();
+    }
+
+    next_command_buffer_size = GenerateCommand(next_command_workbuffer, command_workbuffer_size);
+    next_command_prepared = true;
+
+    for (u32 i = 0; i < memory_pool_count; i++) {
+        const bool used{memory_pool_workbuffer[i].IsUsed()};
+        memory_pool_workbuffer[i].SetUsed(used || next_pools_in_use[i]);
+        next_pools_in_use[i] = used;
+    }
+}
+
+void System::UpdateStateByDspShared() {
+    voice_context.UpdateStateByDspShared();
+
+    if (behavior.IsEffectInfoVersion2Supported()) {
+        effect_context.UpdateStateByDspShared();
+    }
+
+    render_start_tick = adsp.GetRenderingStartTick(session_id);
+}
+
 u64 System::GenerateCommand(std::span<u8> in_command_buffer,
                             [[maybe_unused]] u64 command_buffer_size_) {
+    MICROPROFILE_SCOPE(Audio_GenerateCommand);
     PoolMapper::ClearUseState(memory_pool_workbuffer, memory_pool_count);
     const auto start_time{core.CoreTiming().GetClockTicks()};
 
@@ -729,16 +838,15 @@ u64 System::GenerateCommand(std::span<u8> in_command_buffer,
     command_list_header->buffer_size = command_buffer.size;
     command_list_header->command_count = command_buffer.count;
 
-    voice_context.UpdateStateByDspShared();
-
-    if (render_context.behavior->IsEffectInfoVersion2Supported()) {
-        effect_context.UpdateStateByDspShared();
+    // A pipelined list is generated while the AudioRenderer is still processing the previous
+    // one, so its states are only read back once that finishes, in SendCommandToDsp.
+    if (!pipelined) {
+        UpdateStateByDspShared();
     }
 
     const auto end_time{core.CoreTiming().GetClockTicks()};
     total_ticks_elapsed += end_time - start_time;
     num_command_lists_generated++;
-    render_start_tick = adsp.GetRenderingStartTick(session_id);
     frames_elapsed++;
 
     return command_buffer.size;
@@ -6,6 +6,7 @@
 #include <memory>
 #include <mutex>
 #include <span>
+#include <vector>
 
 #include <audio_core/renderer/behavior/behavior_info.h>
 #include <audio_core/renderer/command/command_processing_time_estimator.h>
@@ -52,6 +53,7 @@ class System {
 
 public:
     explicit System(Core::System& core, KernelShim::KEvent* adsp_rendered_event);
+    ~System();
 
     /**
      * Calculate the total size required for all audio render workbuffers.
@@ -171,9 +173,20 @@ public:
     /**
      * Prepare and generate a list of commands for the AudioRenderer based on current state,
      * signalling the buffer event when all processed.
+     * When pipelined, the list prepared by PrepareNextCommand is sent instead, if there is one.
      */
     void SendCommandToDsp();
 
+    /**
+     * Generate the next list of commands ahead of time, if this system is pipelined.
+     * Called while the AudioRenderer processes the list sent by SendCommandToDsp, so generation
+     * overlaps rendering, at the cost of voice states being read back a frame later. The list is
+     * generated before the game's next update arrives, so updates take a frame longer to be heard.
+     * Nothing is generated while the AudioRenderer is behind, as the list would be held for
+     * several frames and miss their updates, see pipeline_paused.
+     */
+    void PrepareNextCommand();
+
     /**
      * Generate a list of commands for the AudioRenderer based on current state.
      *
@@ -184,6 +197,16 @@ public:
      */
     u64 GenerateCommand(std::span<u8> command_buffer, u64 command_buffer_size);
 
+    /**
+     * Generate the next list of commands into the spare command buffer.
+     */
+    void GenerateNextCommand();
+
+    /**
+     * Read back the states the AudioRenderer updated while processing the last command list.
+     */
+    void UpdateStateByDspShared();
+
     /**
      * Try to drop some voices if the AudioRenderer fell behind.
      *
@@ -243,6 +266,21 @@ private:
     u64 command_workbuffer_size{};
     /// Numebr of commands in the workbuffer
     u64 command_buffer_size{};
+    /// Is command generation pipelined? See Settings::values.audio_pipelined_command_generation
+    bool pipelined{};
+    /// Workbuffer the next commands are generated into while pipelined, swapped when sent
+    std::span<u8> next_command_workbuffer{};
+    /// Size of the commands in the next workbuffer
+    u64 next_command_buffer_size{};
+    /// Has the next command list been generated, and not sent yet?
+    bool next_command_prepared{};
+    /// Is pipelining paused as the AudioRenderer fell behind? Lists are generated when sent until
+    /// it processes a whole list in time again
+    bool pipeline_paused{};
+    /// Was the last list sent the remainder of an unfinished one?
+    bool resent_remaining_commands{};
+    /// Memory pools used by the next command list, applied once it's sent
+    std::vector<bool> next_pools_in_use{};
     /// Manager for upsamplers
     UpsamplerManager* upsampler_manager{};
     /// Upsampler workbuffer
@@ -283,6 +321,8 @@ private:
     std::unique_ptr<u8[]> workbuffer{};
     /// Size of the main workbuffer
     u64 workbuffer_size{};
+    /// Is the main workbuffer locked in RAM? See Settings::values.audio_lock_memory
+    bool workbuffer_locked{};
     /// Unknown buffer/marker
     std::span<u8> unk_2A8{};
     /// Size of the above unknown buffer/marker
@@ -7,6 +7,7 @@
 #include <audio_core/renderer/adsp/adsp.h>
 #include <audio_core/renderer/system_manager.h>
 #include <audio_core/common/microprofile.h>
+#include <audio_core/common/settings.h>
 #include <audio_core/common/thread.h>
 #include <core/core.h>
 #include <core/core_timing.h>
@@ -89,6 +90,8 @@ void SystemManager::ThreadFunc(std::stop_token stop_token) {
     MicroProfileOnThreadCreate(name);
     Common::SetCurrentThreadName(name);
     Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    Common::SetCurrentThreadAffinity(Settings::values.audio_thread_cpu_mask);
+    Common::PrefaultCurrentThreadStack(Common::PrefaultStackSize);
     while (active && !stop_token.stop_requested()) {
         {
             std::scoped_lock l{mutex1};
@@ -101,6 +104,17 @@ void SystemManager::ThreadFunc(std::stop_token stop_token) {
         }
 
         adsp.Signal();
+
+        // Pipelined systems generate their next command lists while the AudioRenderer processes
+        // the ones just sent.
+        {
+            std::scoped_lock l{mutex1};
+
+            for (auto system : systems) {
+                system->PrepareNextCommand();
+            }
+        }
+
         adsp.Wait();
     }
 }
@@ -8,6 +8,45 @@
 #include <audio_core/common/polyfill_ranges.h>
 
 namespace AudioCore::AudioRenderer {
+namespace {
+void ApplyDspSharedStateUpdate(VoiceState& state, const DspSharedStateUpdate& update) {
+    const auto wave_index{update.wave_buffer_index};
+
+    switch (update.type) {
+    case DspSharedStateUpdate::Type::Reset:
+        state = {};
+        break;
+
+    case DspSharedStateUpdate::Type::SendWaveBuffer:
+        state.wave_buffer_valid[wave_index] = true;
+        break;
+
+    case DspSharedStateUpdate::Type::FlushWaveBuffer:
+        if (state.wave_buffer_index == wave_index) {
+            state.wave_buffer_index = (state.wave_buffer_index + 1) % MaxWaveBuffers;
+            state.wave_buffers_consumed++;
+        }
+        state.wave_buffer_valid[wave_index] = false;
+        break;
+
+    case DspSharedStateUpdate::Type::StopWaveBuffer:
+        if (state.wave_buffer_valid[wave_index]) {
+            state.wave_buffer_index = (state.wave_buffer_index + 1) % MaxWaveBuffers;
+            state.wave_buffers_consumed++;
+        }
+        state.wave_buffer_valid[wave_index] = false;
+        break;
+
+    case DspSharedStateUpdate::Type::ResetPosition:
+        state.offset = 0;
+        state.played_sample_count = 0;
+        state.adpcm_context = {};
+        state.sample_history.fill(0);
+        state.fraction = 0;
+        break;
+    }
+}
+} // namespace
 
 VoiceState& VoiceContext::GetDspSharedState(const u32 index) {
     if (index >= dsp_states.size()) {
@@ -16,6 +55,34 @@ VoiceState& VoiceContext::GetDspSharedState(const u32 index) {
     return dsp_states[index];
 }
 
+VoiceState& VoiceContext::GetGenerationState(const u32 index) {
+    return defer_dsp_shared_updates ? GetState(index) : GetDspSharedState(index);
+}
+
+void VoiceContext::UpdateDspSharedState(const DspSharedStateUpdate& update) {
+    if (!defer_dsp_shared_updates) {
+        ApplyDspSharedStateUpdate(GetDspSharedState(update.index), update);
+        return;
+    }
+
+    // The AudioRenderer may be using its state right now, so keep the host-side copy current for
+    // the rest of generation to read, and hold the real update back.
+    ApplyDspSharedStateUpdate(GetState(update.index), update);
+    deferred_dsp_shared_updates.push_back(update);
+}
+
+void VoiceContext::SetDeferDspSharedUpdates(const bool defer) {
+    defer_dsp_shared_updates = defer;
+    deferred_dsp_shared_updates.clear();
+}
+
+void VoiceContext::ApplyDeferredDspSharedUpdates() {
+    for (const auto& update : deferred_dsp_shared_updates) {
+        ApplyDspSharedStateUpdate(GetDspSharedState(update.index), update);
+    }
+    deferred_dsp_shared_updates.clear();
+}
+
 VoiceChannelResource& VoiceContext::GetChannelResource(const u32 index) {
     if (index >= channel_resources.size()) {
         LOG_ERROR(Service_Audio, "Invalid voice channel resource index {:04X}", index);
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <span>
+#include <vector>
 
 #include <audio_core/renderer/voice/voice_channel_resource.h>
 #include <audio_core/renderer/voice/voice_info.h>
@@ -11,6 +12,31 @@
 #include <audio_core/common/common_types.h>
 
 namespace AudioCore::AudioRenderer {
+/**
+ * A change command generation makes to an AudioRenderer-side voice state.
+ */
+struct DspSharedStateUpdate {
+    enum class Type : u8 {
+        /// Reset the whole state, for a new voice
+        Reset,
+        /// Mark a wavebuffer as sent, so the AudioRenderer plays it
+        SendWaveBuffer,
+        /// Mark a wavebuffer as consumed, moving past it if it's the one playing
+        FlushWaveBuffer,
+        /// Mark a wavebuffer as consumed if it's still valid, when stopping the voice
+        StopWaveBuffer,
+        /// Rewind the playback position, when stopping the voice
+        ResetPosition,
+    };
+
+    /// Index of the state to update
+    u32 index;
+    /// What to change
+    Type type;
+    /// Wavebuffer to change, if the update applies to one
+    u32 wave_buffer_index;
+};
+
 /**
  * Contains all voices, with utility functions for managing them.
  */
@@ -24,6 +50,38 @@ public:
      */
     VoiceState& GetDspSharedState(u32 index);
 
+    /**
+     * Get the voice state command generation should read for a given index.
+     * This is the AudioRenderer state, or while deferring updates, the host-side copy of it.
+     *
+     * @param index - State index to get.
+     * @return The requested voice state.
+     */
+    VoiceState& GetGenerationState(u32 index);
+
+    /**
+     * Update the AudioRenderer state for a given index during command generation.
+     * While deferring updates, the host-side copy is updated instead and the update is queued,
+     * to be applied by ApplyDeferredDspSharedUpdates.
+     *
+     * @param update - The update to make.
+     */
+    void UpdateDspSharedState(const DspSharedStateUpdate& update);
+
+    /**
+     * Set whether updates to the AudioRenderer states are deferred. Deferring lets commands be
+     * generated while the AudioRenderer is still processing the previous command list.
+     *
+     * @param defer - Defer updates made during command generation.
+     */
+    void SetDeferDspSharedUpdates(bool defer);
+
+    /**
+     * Apply the updates queued during command generation to the AudioRenderer states.
+     * Must only be called while the AudioRenderer isn't processing a command list.
+     */
+    void ApplyDeferredDspSharedUpdates();
+
     /**
      * Get the channel resource for a given index
      *
@@ -121,6 +179,10 @@ private:
     u32 voice_count{};
     /// Number of active voices
     u32 active_count{};
+    /// Are updates to the AudioRenderer-side states deferred?
+    bool defer_dsp_shared_updates{};
+    /// Updates to the AudioRenderer-side states waiting to be applied, in order
+    std::vector<DspSharedStateUpdate> deferred_dsp_shared_updates{};
 };
 
 } // namespace AudioCore::AudioRenderer
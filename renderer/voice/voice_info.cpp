@@ -32,6 +32,7 @@ void VoiceInfo::Initialize() {
     splitter_id = UnusedSplitterId;
     biquads = {};
     biquad_initialized = {};
+    biquad_stale = {};
     voice_dropped = false;
     data_unmapped = false;
     buffer_unmapped = false;
@@ -286,7 +287,7 @@ bool VoiceInfo::HasAnyConnection() const {
     return mix_id != UnusedMixId || splitter_id != UnusedSplitterId;
 }
 
-void VoiceInfo::FlushWaveBuffers(const u32 flush_count, std::span<VoiceState*> voice_states,
+void VoiceInfo::FlushWaveBuffers(const u32 flush_count, VoiceContext& voice_context,
                                  const s8 channel_count_) {
     auto wave_index{wave_buffer_index};
 
@@ -294,22 +295,21 @@ void VoiceInfo::FlushWaveBuffers(const u32 flush_count, std::span<VoiceState*> v
         wavebuffers[wave_index].sent_to_DSP = true;
 
         for (s8 j = 0; j < channel_count_; j++) {
-            auto voice_state{voice_states[j]};
-            if (voice_state->wave_buffer_index == wave_index) {
-                voice_state->wave_buffer_index =
-                    (voice_state->wave_buffer_index + 1) % MaxWaveBuffers;
-                voice_state->wave_buffers_consumed++;
-            }
-            voice_state->wave_buffer_valid[wave_index] = false;
+            voice_context.UpdateDspSharedState({
+                .index{channel_resource_ids[j]},
+                .type{DspSharedStateUpdate::Type::FlushWaveBuffer},
+                .wave_buffer_index{wave_index},
+            });
         }
 
         wave_index = (wave_index + 1) % MaxWaveBuffers;
     }
 }
 
-bool VoiceInfo::UpdateParametersForCommandGeneration(std::span<VoiceState*> voice_states) {
+bool VoiceInfo::UpdateParametersForCommandGeneration(VoiceContext& voice_context,
+                                                      std::span<VoiceState*> voice_states) {
     if (flush_buffer_count > 0) {
-        FlushWaveBuffers(flush_buffer_count, voice_states, channel_count);
+        FlushWaveBuffers(flush_buffer_count, voice_context, channel_count);
         flush_buffer_count = 0;
     }
 
@@ -318,7 +318,11 @@ bool VoiceInfo::UpdateParametersForCommandGeneration(std::span<VoiceState*> voic
         for (u32 i = 0; i < MaxWaveBuffers; i++) {
             if (!wavebuffers[i].sent_to_DSP) {
                 for (s8 channel = 0; channel < channel_count; channel++) {
-                    voice_states[channel]->wave_buffer_valid[i] = true;
+                    voice_context.UpdateDspSharedState({
+                        .index{channel_resource_ids[channel]},
+                        .type{DspSharedStateUpdate::Type::SendWaveBuffer},
+                        .wave_buffer_index{i},
+                    });
                 }
                 wavebuffers[i].sent_to_DSP = true;
             }
@@ -354,21 +358,20 @@ bool VoiceInfo::UpdateParametersForCommandGeneration(std::span<VoiceState*> voic
             wavebuffers[i].sent_to_DSP = true;
 
             for (s8 channel = 0; channel < channel_count; channel++) {
-                if (voice_states[channel]->wave_buffer_valid[i]) {
-                    voice_states[channel]->wave_buffer_index =
-                        (voice_states[channel]->wave_buffer_index + 1) % MaxWaveBuffers;
-                    voice_states[channel]->wave_buffers_consumed++;
-                }
-                voice_states[channel]->wave_buffer_valid[i] = false;
+                voice_context.UpdateDspSharedState({
+                    .index{channel_resource_ids[channel]},
+                    .type{DspSharedStateUpdate::Type::StopWaveBuffer},
+                    .wave_buffer_index{i},
+                });
             }
         }
 
         for (s8 channel = 0; channel < channel_count; channel++) {
-            voice_states[channel]->offset = 0;
-            voice_states[channel]->played_sample_count = 0;
-            voice_states[channel]->adpcm_context = {};
-            voice_states[channel]->sample_history.fill(0);
-            voice_states[channel]->fraction = 0;
+            voice_context.UpdateDspSharedState({
+                .index{channel_resource_ids[channel]},
+                .type{DspSharedStateUpdate::Type::ResetPosition},
+                .wave_buffer_index{0},
+            });
         }
 
         current_play_state = ServerPlayState::Stopped;
@@ -389,16 +392,19 @@ bool VoiceInfo::UpdateForCommandGeneration(VoiceContext& voice_context) {
     }
 
     for (s8 channel = 0; channel < channel_count; channel++) {
-        voice_states[channel] = &voice_context.GetDspSharedState(channel_resource_ids[channel]);
+        voice_states[channel] = &voice_context.GetGenerationState(channel_resource_ids[channel]);
     }
 
-    return UpdateParametersForCommandGeneration(voice_states);
+    return UpdateParametersForCommandGeneration(voice_context, voice_states);
 }
 
 void VoiceInfo::ResetResources(VoiceContext& voice_context) const {
     for (s8 channel = 0; channel < channel_count; channel++) {
-        auto& state{voice_context.GetDspSharedState(channel_resource_ids[channel])};
-        state = {};
+        voice_context.UpdateDspSharedState({
+            .index{channel_resource_ids[channel]},
+            .type{DspSharedStateUpdate::Type::Reset},
+            .wave_buffer_index{0},
+        });
 
         auto& channel_resource{voice_context.GetChannelResource(channel_resource_ids[channel])};
         channel_resource.prev_mix_volumes = channel_resource.mix_volumes;
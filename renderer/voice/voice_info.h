@@ -285,19 +285,21 @@ public:
      * Flush flush_count wavebuffers, marking them as consumed.
      *
      * @param flush_count   - Number of wavebuffers to flush.
-     * @param voice_states  - Voice states for these wavebuffers.
+     * @param voice_context - Voice context holding the voice states for these wavebuffers.
      * @param channel_count - Number of active channels.
      */
-    void FlushWaveBuffers(u32 flush_count, std::span<VoiceState*> voice_states, s8 channel_count);
+    void FlushWaveBuffers(u32 flush_count, VoiceContext& voice_context, s8 channel_count);
 
     /**
      * Update this voice's parameters on command generation,
      * updating voice states and flushing if needed.
      *
-     * @param voice_states  - Voice states for these wavebuffers.
+     * @param voice_context - Voice context holding the voice states, updated through it.
+     * @param voice_states  - Voice states for these wavebuffers, as generation sees them.
      * @return True if this voice should be generated, otherwise false.
      */
-    bool UpdateParametersForCommandGeneration(std::span<VoiceState*> voice_states);
+    bool UpdateParametersForCommandGeneration(VoiceContext& voice_context,
+                                              std::span<VoiceState*> voice_states);
 
     /**
      * Update this voice on command generation.
@@ -373,6 +375,8 @@ public:
     bool buffer_unmapped{};
     /// Initialisation state of the biquads
     std::array<bool, MaxBiquadFilters> biquad_initialized{};
+    /// Channels whose biquad states went stale while only their position was advanced
+    std::array<bool, MaxChannels> biquad_stale{};
     /// Number of wavebuffers to flush
     u8 flush_buffer_count{};
 };
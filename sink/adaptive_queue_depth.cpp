@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+
+#include <audio_core/common/common.h>
+#include <audio_core/sink/adaptive_queue_depth.h>
+
+namespace AudioCore::Sink {
+
+void AdaptiveQueueDepth::Configure(const u32 min_depth_, const u32 max_depth_,
+                                   const u32 shrink_windows_, const u32 initial_depth) {
+    min_depth = std::max(min_depth_, 1U);
+    max_depth = std::max(max_depth_, min_depth);
+    shrink_windows = std::max(shrink_windows_, 1U);
+    depth.store(std::clamp(initial_depth, min_depth, max_depth), std::memory_order_relaxed);
+    started = false;
+    window_frames = 0;
+    window_min_slack = std::numeric_limits<u64>::max();
+    stable_windows = 0;
+}
+
+bool AdaptiveQueueDepth::Update(const u64 queued_frames, const u64 num_frames,
+                                const bool underrun) {
+    if (!started) {
+        started = queued_frames != 0;
+        return false;
+    }
+
+    const auto current{depth.load(std::memory_order_relaxed)};
+    if (underrun) {
+        // Grow straight away, and start proving stability again from scratch.
+        window_frames = 0;
+        window_min_slack = std::numeric_limits<u64>::max();
+        stable_windows = 0;
+        if (current < max_depth) {
+            depth.store(current + 1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    const auto slack{queued_frames - std::min(queued_frames, num_frames)};
+    window_frames += num_frames;
+    window_min_slack = std::min(window_min_slack, slack);
+    if (window_frames < TargetSampleRate) {
+        return false;
+    }
+
+    // A window is stable if a whole buffer was always left queued, so one fewer would have been
+    // enough for it.
+    const bool stable{window_min_slack >= TargetSampleCount};
+    stable_windows = stable ? stable_windows + 1 : 0;
+    window_frames = 0;
+    window_min_slack = std::numeric_limits<u64>::max();
+
+    if (stable_windows >= shrink_windows && current > min_depth) {
+        stable_windows = 0;
+        depth.store(current - 1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+
+#include <audio_core/common/common_types.h>
+
+namespace AudioCore::Sink {
+
+/**
+ * Adapts how many buffers a stream queues to how regularly its backend consumes them.
+ *
+ * Callbacks are grouped into windows of one second of audio. The depth grows by a buffer as soon
+ * as the stream underruns, and shrinks by one after a number of consecutive windows in which at
+ * least one whole buffer was left queued after every callback, i.e. was never needed.
+ */
+class AdaptiveQueueDepth {
+public:
+    /**
+     * Set the depth limits, and restart adapting from the initial depth.
+     * Must not race with Update.
+     *
+     * @param min_depth_      - Fewest buffers to queue.
+     * @param max_depth_      - Most buffers to queue.
+     * @param shrink_windows_ - Consecutive stable windows needed before shrinking.
+     * @param initial_depth   - Depth to start from, clamped to the limits.
+     */
+    void Configure(u32 min_depth_, u32 max_depth_, u32 shrink_windows_, u32 initial_depth);
+
+    /**
+     * Update the depth after a backend callback.
+     * Must only be called from the backend thread.
+     *
+     * @param queued_frames - Frames queued when the callback started.
+     * @param num_frames    - Frames requested by the callback.
+     * @param underrun      - True if the callback ran out of queued buffers.
+     * @return True if the depth changed.
+     */
+    bool Update(u64 queued_frames, u64 num_frames, bool underrun);
+
+    /**
+     * Get the number of buffers which should be queued.
+     *
+     * @return The current depth.
+     */
+    u32 GetDepth() const {
+        return depth.load(std::memory_order_relaxed);
+    }
+
+private:
+    /// Fewest buffers to queue
+    u32 min_depth{};
+    /// Most buffers to queue
+    u32 max_depth{};
+    /// Consecutive stable windows needed before shrinking
+    u32 shrink_windows{};
+    /// Current number of buffers to queue
+    std::atomic<u32> depth{};
+    /// Has audio been queued yet? Underruns before the stream first fills are ignored
+    bool started{};
+    /// Frames consumed in the current window
+    u64 window_frames{};
+    /// Fewest frames left queued after a callback in the current window
+    u64 window_min_slack{std::numeric_limits<u64>::max()};
+    /// Number of consecutive stable windows
+    u32 stable_windows{};
+};
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,202 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <audio_core/common/simd.h>
+#include <audio_core/sink/channel_converter.h>
+
+namespace AudioCore::Sink {
+
+using namespace Common::Simd;
+
+/**
+ * Scale samples by a volume, saturating the results.
+ *
+ * @param samples - Samples to scale in place.
+ * @param volume  - Volume to scale by.
+ */
+static void ScaleSamples(std::span<s16> samples, const f32 volume) {
+    constexpr s32 min{std::numeric_limits<s16>::min()};
+    constexpr s32 max{std::numeric_limits<s16>::max()};
+
+    u64 i{0};
+    for (; i + VectorWidth <= samples.size(); i += VectorWidth) {
+        StoreSaturatedS16x4(&samples[i], MulF32x4(LoadS16x4(&samples[i]), volume));
+    }
+    for (; i < samples.size(); i++) {
+        samples[i] = static_cast<s16>(
+            std::clamp(static_cast<s32>(static_cast<f32>(samples[i]) * volume), min, max));
+    }
+}
+
+void ChannelConverter::Configure(u32 src_channels_, u32 dst_channels_, const f32 volume_) {
+    src_channels_ = std::min(src_channels_, MaxChannels);
+    dst_channels_ = std::min(dst_channels_, MaxChannels);
+    if (src_channels_ == src_channels && dst_channels_ == dst_channels && volume_ == volume) {
+        return;
+    }
+    src_channels = src_channels_;
+    dst_channels = dst_channels_;
+    volume = volume_;
+
+    constexpr auto FL{static_cast<u32>(Channels::FrontLeft)};
+    constexpr auto FR{static_cast<u32>(Channels::FrontRight)};
+    constexpr auto C{static_cast<u32>(Channels::Center)};
+    constexpr auto BL{static_cast<u32>(Channels::BackLeft)};
+    constexpr auto BR{static_cast<u32>(Channels::BackRight)};
+
+    matrix = {};
+    identity = false;
+    if (src_channels == 6 && dst_channels == 2) {
+        // Standard downmix, surround and center channels folded into the front pair.
+        matrix[FL] = {1.0f, 0.0f, 0.707f, 0.251f, 0.707f, 0.0f};
+        matrix[FR] = {0.0f, 1.0f, 0.707f, 0.251f, 0.0f, 0.707f};
+    } else if (src_channels == 6 && dst_channels == 1) {
+        matrix[0] = {0.5f, 0.5f, 0.707f, 0.251f, 0.354f, 0.354f};
+    } else if (src_channels == 2 && dst_channels == 6) {
+        // Passive upmix: the center gets the mid signal at -3dB and the backs get their side at
+        // -6dB. LFE is left silent, as there's no low-pass filter here.
+        matrix[FL][FL] = 1.0f;
+        matrix[FR][FR] = 1.0f;
+        matrix[C] = {0.354f, 0.354f};
+        matrix[BL][FL] = 0.5f;
+        matrix[BR][FR] = 0.5f;
+    } else if (src_channels == 2 && dst_channels == 1) {
+        matrix[0] = {0.5f, 0.5f};
+    } else if (src_channels == 1 && dst_channels == 2) {
+        matrix[FL][0] = 1.0f;
+        matrix[FR][0] = 1.0f;
+    } else if (src_channels == 1 && dst_channels == 6) {
+        matrix[C][0] = 1.0f;
+    } else {
+        for (u32 channel = 0; channel < std::min(src_channels, dst_channels); channel++) {
+            matrix[channel][channel] = 1.0f;
+        }
+        identity = src_channels == dst_channels;
+    }
+
+    for (auto& row : matrix) {
+        for (auto& coeff : row) {
+            coeff *= volume;
+        }
+    }
+}
+
+void ChannelConverter::MixFrames(const s16* input, s16* output, const u64 count) const {
+    // Deinterleave the source frames, so each vector holds one channel of every frame.
+    F32x4 in[MaxChannels];
+    for (u32 src = 0; src < src_channels; src++) {
+        std::array<f32, VectorWidth> channel{};
+        for (u64 frame = 0; frame < count; frame++) {
+            channel[frame] = static_cast<f32>(input[frame * src_channels + src]);
+        }
+        in[src] = LoadF32x4(channel.data());
+    }
+
+    for (u32 dst = 0; dst < dst_channels; dst++) {
+        auto mixed{SplatF32x4(0.0f)};
+        for (u32 src = 0; src < src_channels; src++) {
+            mixed = MulAddF32x4(mixed, in[src], matrix[dst][src]);
+        }
+
+        std::array<s16, VectorWidth> channel;
+        StoreSaturatedS16x4(channel.data(), mixed);
+        for (u64 frame = 0; frame < count; frame++) {
+            output[frame * dst_channels + dst] = channel[frame];
+        }
+    }
+}
+
+void ChannelConverter::Convert(std::span<s16> samples, const u64 num_frames) const {
+    if (IsPassthrough() || src_channels == 0 || dst_channels == 0) {
+        return;
+    }
+
+    if (identity) {
+        ScaleSamples(samples.first(num_frames * src_channels), volume);
+        return;
+    }
+
+    // Each block is fully read before it's written. When shrinking, writes never pass the next
+    // block's input going forwards. When growing, walk backwards so they never reach the
+    // previous block's input.
+    if (dst_channels <= src_channels) {
+        for (u64 frame = 0; frame < num_frames; frame += VectorWidth) {
+            MixFrames(&samples[frame * src_channels], &samples[frame * dst_channels],
+                      std::min<u64>(VectorWidth, num_frames - frame));
+        }
+    } else if (num_frames != 0) {
+        for (u64 block = (num_frames - 1) / VectorWidth + 1; block-- > 0;) {
+            const auto frame{block * VectorWidth};
+            MixFrames(&samples[frame * src_channels], &samples[frame * dst_channels],
+                      std::min<u64>(VectorWidth, num_frames - frame));
+        }
+    }
+}
+
+void ChannelConverter::Convert(std::span<const s16> input, std::span<s16> output,
+                               const u64 num_frames) const {
+    if (src_channels == 0 || dst_channels == 0) {
+        return;
+    }
+
+    if (identity) {
+        const auto samples{output.first(num_frames * dst_channels)};
+        std::memcpy(samples.data(), input.data(), samples.size_bytes());
+        if (volume != 1.0f) {
+            ScaleSamples(samples, volume);
+        }
+        return;
+    }
+
+    for (u64 frame = 0; frame < num_frames; frame += VectorWidth) {
+        MixFrames(&input[frame * src_channels], &output[frame * dst_channels],
+                  std::min<u64>(VectorWidth, num_frames - frame));
+    }
+}
+
+void InterleaveSamples(std::span<const s32* const> inputs, std::span<s16> output,
+                       const u64 num_frames, const f32 volume) {
+    constexpr s32 min{std::numeric_limits<s16>::min()};
+    constexpr s32 max{std::numeric_limits<s16>::max()};
+    const auto num_channels{inputs.size()};
+
+    const auto load = [&](const s32* input) {
+        return MulF32x4(ClampF32x4(LoadS32x4(input), min, max), volume);
+    };
+
+    u64 frame{0};
+    if (num_channels == 1) {
+        for (; frame + VectorWidth <= num_frames; frame += VectorWidth) {
+            StoreSaturatedS16x4(&output[frame], load(&inputs[0][frame]));
+        }
+    } else if (num_channels == 2) {
+        for (; frame + VectorWidth <= num_frames; frame += VectorWidth) {
+            StoreInterleavedSaturatedS16x4x2(&output[frame * 2], load(&inputs[0][frame]),
+                                             load(&inputs[1][frame]));
+        }
+    } else {
+        for (; frame + VectorWidth <= num_frames; frame += VectorWidth) {
+            for (u64 channel = 0; channel < num_channels; channel++) {
+                std::array<s16, VectorWidth> samples;
+                StoreSaturatedS16x4(samples.data(), load(&inputs[channel][frame]));
+                for (u64 i = 0; i < VectorWidth; i++) {
+                    output[(frame + i) * num_channels + channel] = samples[i];
+                }
+            }
+        }
+    }
+
+    for (; frame < num_frames; frame++) {
+        for (u64 channel = 0; channel < num_channels; channel++) {
+            const auto sample{static_cast<s16>(std::clamp(inputs[channel][frame], min, max))};
+            output[frame * num_channels + channel] = static_cast<s16>(
+                std::clamp(static_cast<s32>(static_cast<f32>(sample) * volume), min, max));
+        }
+    }
+}
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <array>
+#include <span>
+
+#include <audio_core/common/common.h>
+#include <audio_core/common/common_types.h>
+
+namespace AudioCore::Sink {
+
+/**
+ * Converts interleaved PCM16 frames between channel layouts, applying a volume at the same time.
+ * Conversions are done with a mixing matrix precomputed for the source and destination layouts,
+ * with the volume folded in, and processed 4 frames at a time with SIMD where available.
+ *
+ * Mono, stereo and 5.1 layouts are mixed between, including a stereo to 5.1 upmix. Any other
+ * combination copies the channels both layouts have and silences the rest.
+ */
+class ChannelConverter {
+public:
+    /**
+     * Set the layouts and volume to convert with. The matrix is only rebuilt if they changed.
+     *
+     * @param src_channels - Number of channels in the source frames, at most MaxChannels.
+     * @param dst_channels - Number of channels in the converted frames, at most MaxChannels.
+     * @param volume       - Volume to apply to the converted samples.
+     */
+    void Configure(u32 src_channels, u32 dst_channels, f32 volume);
+
+    /**
+     * Check if converting would leave the samples unchanged.
+     *
+     * @return True if the layouts match and the volume is 1.
+     */
+    bool IsPassthrough() const {
+        return src_channels == dst_channels && identity && volume == 1.0f;
+    }
+
+    /**
+     * Convert frames in place, saturating the results.
+     *
+     * @param samples    - Source frames on input, converted frames on output. Must hold
+     *                     num_frames * max(src_channels, dst_channels) samples.
+     * @param num_frames - Number of frames to convert.
+     */
+    void Convert(std::span<s16> samples, u64 num_frames) const;
+
+    /**
+     * Convert frames into a separate buffer, saturating the results.
+     *
+     * @param input      - Source frames, must hold num_frames * src_channels samples.
+     * @param output     - Converted frames, must hold num_frames * dst_channels samples and not
+     *                     overlap the input.
+     * @param num_frames - Number of frames to convert.
+     */
+    void Convert(std::span<const s16> input, std::span<s16> output, u64 num_frames) const;
+
+private:
+    /**
+     * Mix up to 4 frames with the matrix.
+     *
+     * @param input  - First source frame.
+     * @param output - First destination frame, may alias input.
+     * @param count  - Number of frames to mix, at most 4.
+     */
+    void MixFrames(const s16* input, s16* output, u64 count) const;
+
+    /// Channels in the source frames
+    u32 src_channels{};
+    /// Channels in the destination frames
+    u32 dst_channels{};
+    /// Volume folded into the matrix
+    f32 volume{};
+    /// True if the matrix is the identity before the volume is applied
+    bool identity{};
+    /// Coefficient of each source channel in each destination channel, indexed [dst][src]
+    std::array<std::array<f32, MaxChannels>, MaxChannels> matrix{};
+};
+
+/**
+ * Interleave planar mix buffers into PCM16 frames in a single pass, clamping each sample to the
+ * PCM16 range, then applying a volume and saturating the result.
+ *
+ * @param inputs     - One buffer of num_frames samples for each channel of the output.
+ * @param output     - Output frames, must hold num_frames * inputs.size() samples.
+ * @param num_frames - Number of frames to write.
+ * @param volume     - Volume to apply to the clamped samples.
+ */
+void InterleaveSamples(std::span<const s32* const> inputs, std::span<s16> output, u64 num_frames,
+                       f32 volume);
+
+} // namespace AudioCore::Sink
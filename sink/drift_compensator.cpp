@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <audio_core/sink/drift_compensator.h>
+
+namespace AudioCore::Sink {
+
+/// Weight of each new fill level in the smoothed fill, averaging over a few hundred callbacks
+constexpr f64 FillSmoothing{1.0 / 256.0};
+/// Ratio offset for a fill error equal to the target
+constexpr f64 ProportionalGain{DriftCompensator::MaxRatioOffset};
+/// Integral gain per callback, reaching the limit after a few thousand callbacks at full error
+constexpr f64 IntegralGain{DriftCompensator::MaxRatioOffset / 4096.0};
+/// Largest change of the ratio per callback
+constexpr f64 MaxRatioStep{DriftCompensator::MaxRatioOffset / 1024.0};
+
+DriftCompensator::DriftCompensator() : pending(MaxPendingFrames * MaxChannels) {}
+
+void DriftCompensator::Reset() {
+    ratio = 1.0;
+    integral = 0.0;
+    smoothed_fill = 0.0;
+    has_fill = false;
+    position = 0.0;
+    carried_frames = 0;
+    pending_frames = 0;
+}
+
+void DriftCompensator::UpdateRatio(const u64 queued_frames, const u64 target_frames) {
+    if (target_frames == 0) {
+        return;
+    }
+
+    const auto fill{static_cast<f64>(queued_frames)};
+    if (!has_fill) {
+        smoothed_fill = fill;
+        has_fill = true;
+    }
+    smoothed_fill += (fill - smoothed_fill) * FillSmoothing;
+
+    // Consume faster while the ring is fuller than the target, and slower while it's emptier.
+    const auto target{static_cast<f64>(target_frames)};
+    const auto error{std::clamp((smoothed_fill - target) / target, -1.0, 1.0)};
+    integral = std::clamp(integral + error * IntegralGain, -MaxRatioOffset, MaxRatioOffset);
+    const auto wanted{
+        1.0 + std::clamp(error * ProportionalGain + integral, -MaxRatioOffset, MaxRatioOffset)};
+
+    ratio += std::clamp(wanted - ratio, -MaxRatioStep, MaxRatioStep);
+}
+
+std::span<s16> DriftCompensator::PrepareInput(const u64 num_frames, const u32 num_channels) {
+    if (num_channels != channels) {
+        channels = num_channels;
+        carried_frames = 0;
+        position = 0.0;
+    }
+
+    // The last output frame interpolates between the frame at its position and the one after.
+    pending_frames = carried_frames;
+    if (num_frames != 0) {
+        pending_frames = std::max<u64>(
+            carried_frames,
+            static_cast<u64>(position + static_cast<f64>(num_frames - 1) * ratio) + 2);
+    }
+    pending_frames = std::min(pending_frames, MaxPendingFrames);
+
+    return std::span(pending).subspan(carried_frames * channels,
+                                      (pending_frames - carried_frames) * channels);
+}
+
+void DriftCompensator::Resample(std::span<s16> output, const u64 num_frames) {
+    constexpr f64 min{std::numeric_limits<s16>::min()};
+    constexpr f64 max{std::numeric_limits<s16>::max()};
+
+    for (u64 frame = 0; frame < num_frames; frame++) {
+        const auto pos{position + static_cast<f64>(frame) * ratio};
+        const auto index{std::min(static_cast<u64>(pos), pending_frames - 1)};
+        const auto fraction{std::min(pos - static_cast<f64>(index), 1.0)};
+        const auto* current{&pending[index * channels]};
+        const auto* next{&pending[std::min(index + 1, pending_frames - 1) * channels]};
+
+        for (u32 channel = 0; channel < channels; channel++) {
+            const auto sample{static_cast<f64>(current[channel]) +
+                              (static_cast<f64>(next[channel]) - current[channel]) * fraction};
+            output[frame * channels + channel] =
+                static_cast<s16>(std::clamp(std::round(sample), min, max));
+        }
+    }
+
+    // Carry the frames the next output still needs over to the next callback.
+    const auto advance{position + static_cast<f64>(num_frames) * ratio};
+    const auto consumed{std::min(static_cast<u64>(advance), pending_frames)};
+    position = advance - static_cast<f64>(consumed);
+    carried_frames = pending_frames - consumed;
+    std::memmove(pending.data(), &pending[consumed * channels],
+                 carried_frames * channels * sizeof(s16));
+}
+
+} // namespace AudioCore::Sink
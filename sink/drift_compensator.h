@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include <audio_core/common/common.h>
+#include <audio_core/common/common_types.h>
+
+namespace AudioCore::Sink {
+
+/**
+ * Compensates for drift between the rate a stream's producer queues frames, and the rate the
+ * device really consumes them. The fill level of the sample ring is kept centered on a target by
+ * resampling the queued frames with a ratio within MaxRatioOffset of 1, which only changes
+ * slowly so the pitch change is inaudible.
+ *
+ * Each callback calls UpdateRatio, pops the frames it asks for into the span from PrepareInput,
+ * then resamples them into its output with Resample. Only used by the backend thread, which it
+ * never allocates on, its input storage is allocated up front for MaxPendingFrames.
+ */
+class DriftCompensator {
+public:
+    /// Largest distance of the resampling ratio from 1
+    static constexpr f64 MaxRatioOffset{0.005};
+    /// Most frames which can be pending for one callback, ~170ms at 48KHz. Larger callbacks are
+    /// given only this many input frames, and repeat the last one.
+    static constexpr u64 MaxPendingFrames{0x2000};
+
+    DriftCompensator();
+
+    /**
+     * Forget the measured drift and any carried frames.
+     */
+    void Reset();
+
+    /**
+     * Update the resampling ratio from the ring fill level at the start of a callback.
+     *
+     * @param queued_frames - Frames queued in the ring.
+     * @param target_frames - Fill level to keep the ring centered on.
+     */
+    void UpdateRatio(u64 queued_frames, u64 target_frames);
+
+    /**
+     * Get the span new input frames should be written to for the next Resample.
+     *
+     * @param num_frames   - Number of output frames which will be resampled.
+     * @param num_channels - Number of channels in each frame, at most MaxChannels.
+     * @return Span to write the input frames to, its size is the number of samples needed.
+     */
+    std::span<s16> PrepareInput(u64 num_frames, u32 num_channels);
+
+    /**
+     * Resample the frames written after PrepareInput into the output.
+     *
+     * @param output     - Output frames.
+     * @param num_frames - Number of output frames, as passed to PrepareInput.
+     */
+    void Resample(std::span<s16> output, u64 num_frames);
+
+    /**
+     * Get the current resampling ratio.
+     *
+     * @return Input frames consumed per output frame.
+     */
+    f64 GetRatio() const {
+        return ratio;
+    }
+
+private:
+    /// Input frames consumed per output frame
+    f64 ratio{1.0};
+    /// Accumulated fill error, removes the steady state error a proportional term leaves
+    f64 integral{};
+    /// Smoothed ring fill level, in frames
+    f64 smoothed_fill{};
+    /// Has smoothed_fill been initialised?
+    bool has_fill{};
+    /// Position of the next output frame between input frames, relative to the first pending one
+    f64 position{};
+    /// Channels in each frame
+    u32 channels{};
+    /// Frames carried over from the previous callback, used for interpolation
+    u64 carried_frames{};
+    /// Total frames in pending for the current callback
+    u64 pending_frames{};
+    /// Carried frames followed by the new input frames, interleaved, sized for MaxPendingFrames
+    /// of MaxChannels
+    std::vector<s16> pending{};
+};
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,342 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <audio_core/common/common.h>
+#include <audio_core/common/polyfill_thread.h>
+#include <audio_core/common/reader_writer_queue.h>
+#include <audio_core/common/settings.h>
+#include <audio_core/common/thread.h>
+#include <audio_core/sink/file_sink.h>
+#include <audio_core/sink/sink_stream.h>
+#include <audio_core/sink/virtual_sink_stream.h>
+#include <audio_core/common/logging/log.h>
+#include <core/core.h>
+
+namespace AudioCore::Sink {
+
+/// Size of a WAV header with a single fmt chunk
+constexpr size_t WavHeaderSize{44};
+/// Number of sample chunks shared by the device and writer threads
+constexpr size_t ChunkCount{16};
+
+/**
+ * Build a PCM16 WAV header.
+ *
+ * @param num_channels - Channels in each frame.
+ * @param data_size    - Size of the sample data following the header, in bytes.
+ * @return The header.
+ */
+static std::array<u8, WavHeaderSize> BuildWavHeader(const u32 num_channels, const u64 data_size) {
+    // WAV sizes are 32-bit, so longer captures are truncated in the header.
+    const auto size{static_cast<u32>(
+        std::min<u64>(data_size, std::numeric_limits<u32>::max() - WavHeaderSize))};
+    const auto block_align{static_cast<u32>(num_channels * sizeof(s16))};
+
+    std::array<u8, WavHeaderSize> header{};
+    size_t offset{0};
+    const auto write_tag{[&](const char* tag) {
+        std::copy_n(tag, 4, &header[offset]);
+        offset += 4;
+    }};
+    const auto write_le{[&](const u32 value, const size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            header[offset++] = static_cast<u8>(value >> (i * 8));
+        }
+    }};
+
+    write_tag("RIFF");
+    write_le(static_cast<u32>(WavHeaderSize - 8) + size, 4);
+    write_tag("WAVE");
+    write_tag("fmt ");
+    write_le(16, 4);
+    write_le(1, 2); // PCM
+    write_le(num_channels, 2);
+    write_le(TargetSampleRate, 4);
+    write_le(TargetSampleRate * block_align, 4);
+    write_le(block_align, 2);
+    write_le(16, 2);
+    write_tag("data");
+    write_le(size, 4);
+    return header;
+}
+
+/**
+ * File sink stream, emulates a device consuming samples and writes them to a file.
+ *
+ * The device thread consumes samples either on a real time clock or whenever buffers are queued,
+ * and hands them to a writer thread through a lock-free queue, so file I/O never delays the
+ * emulated device. Spent sample chunks are handed back through a second queue to be reused, from
+ * a fixed pool of ChunkCount allocated with the stream. If the writer falls behind and the pool
+ * runs dry, a paced stream drops the frames like a real device would, while an unpaced stream
+ * waits for the writer, so unpaced captures are never missing frames.
+ */
+class FileSinkStream final : public VirtualSinkStream {
+public:
+    /**
+     * Create a new sink stream.
+     *
+     * @param device_channels_ - Number of channels written to the file.
+     * @param system_channels_ - Number of channels the audio systems expect.
+     * @param path_            - Path of the file to write, unused for input streams.
+     * @param paced_           - Consume on a wall clock rather than as fast as buffers queue.
+     * @param name_            - Name of this stream.
+     * @param type_            - Type of this stream.
+     * @param system_          - Core system.
+     */
+    FileSinkStream(u32 device_channels_, u32 system_channels_, std::filesystem::path path_,
+                   bool paced_, const std::string& name_, StreamType type_, Core::System& system_)
+        : VirtualSinkStream{system_, type_, paced_ ? 1U : 0U}, path{std::move(path_)} {
+        system_channels = system_channels_;
+        device_channels = device_channels_;
+        name = name_;
+
+        if (type == StreamType::In) {
+            LOG_INFO(Service_Audio, "Opening file input stream {}, recording silence", name);
+            silence.resize(TargetSampleCount * device_channels);
+            return;
+        }
+
+        file = std::fopen(path.string().c_str(), "wb");
+        if (file == nullptr) {
+            LOG_CRITICAL(Audio_Sink, "Error opening audio output file {}", path.string());
+            return;
+        }
+
+        auto extension{path.extension().string()};
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](const char c) { return static_cast<char>(std::tolower(c)); });
+        wav = extension == ".wav";
+        if (wav) {
+            const auto header{BuildWavHeader(device_channels, 0)};
+            std::fwrite(header.data(), 1, header.size(), file);
+        }
+
+        for (size_t i = 0; i < ChunkCount; i++) {
+            std::vector<s16> chunk;
+            chunk.reserve(MaxCallbackFrames * device_channels);
+            free_chunks.enqueue(std::move(chunk));
+        }
+        dropped_chunk.resize(MaxCallbackFrames * device_channels);
+
+        writer_thread =
+            std::jthread([this](std::stop_token stop_token) { WriterThreadFunc(stop_token); });
+
+        LOG_INFO(Service_Audio,
+                 "Opening file stream {} to {} with: rate {} channels {} (system channels {}) {}",
+                 name, path.string(), TargetSampleRate, device_channels, system_channels,
+                 IsUnclocked() ? "unpaced" : "paced");
+    }
+
+    /**
+     * Destroy the sink stream.
+     */
+    ~FileSinkStream() override {
+        LOG_DEBUG(Service_Audio, "Destructing file stream {}", name);
+        Finalize();
+    }
+
+    /**
+     * Finalize the sink stream, flushing all consumed samples to the file.
+     */
+    void Finalize() override {
+        Stop();
+        if (file == nullptr) {
+            return;
+        }
+
+        // The writer drains everything queued before it exits.
+        writer_thread.request_stop();
+        writer_thread.join();
+
+        if (wav) {
+            const auto header{BuildWavHeader(device_channels, data_size)};
+            std::fseek(file, 0, SEEK_SET);
+            std::fwrite(header.data(), 1, header.size(), file);
+        }
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    /**
+     * Start the sink stream.
+     *
+     * @param resume - Set to true if this is resuming the stream a previously-active stream.
+     *                 Default false.
+     */
+    void Start(bool resume = false) override {
+        if (type != StreamType::In && file == nullptr) {
+            return;
+        }
+        VirtualSinkStream::Start(resume);
+    }
+
+protected:
+    /**
+     * Run the stream callback for a number of frames, queueing output samples for writing.
+     *
+     * @param num_frames - Number of frames to consume or record.
+     */
+    void Callback(const u64 num_frames) override {
+        if (type == StreamType::In) {
+            ProcessAudioIn(std::span(silence).first(num_frames * device_channels), num_frames);
+            return;
+        }
+
+        // Chunks are reserved for MaxCallbackFrames, so resizing them never allocates.
+        std::vector<s16> chunk;
+        if (IsUnclocked()) {
+            free_chunks.wait_dequeue(chunk);
+        } else if (!free_chunks.try_dequeue(chunk)) {
+            if (!dropping_frames) {
+                LOG_WARNING(Audio_Sink, "File stream {} is writing too slowly, dropping frames",
+                            name);
+                dropping_frames = true;
+            }
+            ProcessAudioOutAndRender(
+                std::span(dropped_chunk).first(num_frames * device_channels), num_frames);
+            return;
+        }
+        dropping_frames = false;
+
+        chunk.resize(num_frames * device_channels);
+        ProcessAudioOutAndRender(chunk, num_frames);
+        filled_chunks.enqueue(std::move(chunk));
+    }
+
+private:
+    /**
+     * Writes consumed samples to the file until stopped and every chunk has been written.
+     *
+     * @param stop_token - Token signalled when the stream is finalized.
+     */
+    void WriterThreadFunc(std::stop_token stop_token) {
+        Common::SetCurrentThreadName("AudioFileSinkWriter");
+
+        std::vector<s16> chunk;
+        while (true) {
+            if (!filled_chunks.wait_dequeue_timed(chunk, CallbackPeriod)) {
+                if (stop_token.stop_requested()) {
+                    break;
+                }
+                continue;
+            }
+
+            if constexpr (std::endian::native == std::endian::big) {
+                // Both WAV and the raw output are little endian.
+                for (auto& sample : chunk) {
+                    const auto value{static_cast<u16>(sample)};
+                    sample = static_cast<s16>((value >> 8) | (value << 8));
+                }
+            }
+
+            const auto written{std::fwrite(chunk.data(), sizeof(s16), chunk.size(), file)};
+            data_size += written * sizeof(s16);
+            if (written < chunk.size() && !write_failed) {
+                LOG_ERROR(Audio_Sink, "Error writing audio output file {}", path.string());
+                write_failed = true;
+            }
+            free_chunks.enqueue(std::move(chunk));
+        }
+    }
+
+    /// Path of the output file
+    std::filesystem::path path;
+    /// Output file, null for input streams or if it couldn't be opened
+    std::FILE* file{};
+    /// Is the output file a WAV, rather than raw PCM16?
+    bool wav{};
+    /// Bytes of sample data written to the file, only used by the writer thread and Finalize
+    u64 data_size{};
+    /// Has a write failed? Only the first failure is logged
+    bool write_failed{};
+    /// Chunks of consumed samples waiting to be written, device thread to writer thread
+    Common::BlockingReaderWriterQueue<std::vector<s16>> filled_chunks{ChunkCount};
+    /// Written chunks to be reused, writer thread to device thread
+    Common::BlockingReaderWriterQueue<std::vector<s16>> free_chunks{ChunkCount};
+    /// Consumes frames while the pool is empty, they're never written
+    std::vector<s16> dropped_chunk;
+    /// Is a paced stream dropping frames? Only logged once each time it starts
+    bool dropping_frames{};
+    /// Samples fed to input streams
+    std::vector<s16> silence;
+    /// Thread writing consumed samples to the file
+    std::jthread writer_thread;
+};
+
+FileSink::FileSink(std::string_view device_id) {
+    if (device_id != auto_device_name && !device_id.empty()) {
+        output_path = device_id;
+    } else {
+        output_path = "audio_output.wav";
+    }
+
+    device_channels = 2;
+}
+
+FileSink::~FileSink() = default;
+
+SinkStream* FileSink::AcquireSinkStream(Core::System& system, u32 system_channels,
+                                        const std::string& name, StreamType type) {
+    // Every stream gets its own file, named after the sink's path and the stream.
+    auto path{output_path};
+    path.replace_filename(output_path.stem().string() + "_" + name +
+                          output_path.extension().string());
+
+    SinkStreamPtr& stream = sink_streams.emplace_back(
+        std::make_unique<FileSinkStream>(device_channels, system_channels, std::move(path),
+                                         Settings::values.audio_file_sink_paced, name, type,
+                                         system));
+    return stream.get();
+}
+
+void FileSink::CloseStream(SinkStream* stream) {
+    for (size_t i = 0; i < sink_streams.size(); i++) {
+        if (sink_streams[i].get() == stream) {
+            sink_streams[i].reset();
+            sink_streams.erase(sink_streams.begin() + i);
+            break;
+        }
+    }
+}
+
+void FileSink::CloseStreams() {
+    sink_streams.clear();
+}
+
+f32 FileSink::GetDeviceVolume() const {
+    if (sink_streams.empty()) {
+        return 1.0f;
+    }
+
+    return sink_streams[0]->GetDeviceVolume();
+}
+
+void FileSink::SetDeviceVolume(f32 volume) {
+    for (auto& stream : sink_streams) {
+        stream->SetDeviceVolume(volume);
+    }
+}
+
+void FileSink::SetSystemVolume(f32 volume) {
+    for (auto& stream : sink_streams) {
+        stream->SetSystemVolume(volume);
+    }
+}
+
+u32 GetFileLatency() {
+    return TargetSampleCount;
+}
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <audio_core/sink/sink.h>
+
+namespace Core {
+class System;
+}
+
+namespace AudioCore::Sink {
+class SinkStream;
+
+/**
+ * File backend sink, writes each output stream to its own WAV or raw PCM file instead of a
+ * device. Used for headless runs, capturing output, and benchmarks not bounded by a device.
+ *
+ * Streams are consumed either on a wall clock emulating a 48 kHz device, or as fast as buffers are
+ * queued, see Settings::values.audio_file_sink_paced. Input streams record silence.
+ */
+class FileSink final : public Sink {
+public:
+    /**
+     * Create a new file sink.
+     *
+     * @param device_id - Path to write to, streams append their name to its stem. Files ending in
+     *                    .wav are written as WAV, anything else as raw PCM16.
+     */
+    explicit FileSink(std::string_view device_id);
+    ~FileSink() override;
+
+    /**
+     * Create a new sink stream.
+     *
+     * @param system          - Core system.
+     * @param system_channels - Number of channels the audio system expects.
+     *                          May differ from the device's channel count.
+     * @param name            - Name of this stream.
+     * @param type            - Type of this stream, render/in/out.
+     *
+     * @return A pointer to the created SinkStream
+     */
+    SinkStream* AcquireSinkStream(Core::System& system, u32 system_channels,
+                                  const std::string& name, StreamType type) override;
+
+    /**
+     * Close a given stream.
+     *
+     * @param stream - The stream to close.
+     */
+    void CloseStream(SinkStream* stream) override;
+
+    /**
+     * Close all streams.
+     */
+    void CloseStreams() override;
+
+    /**
+     * Get the device volume. Set from calls to the IAudioDevice service.
+     *
+     * @return Volume of the device.
+     */
+    f32 GetDeviceVolume() const override;
+
+    /**
+     * Set the device volume. Set from calls to the IAudioDevice service.
+     *
+     * @param volume - New volume of the device.
+     */
+    void SetDeviceVolume(f32 volume) override;
+
+    /**
+     * Set the system volume. Comes from the audio system using this stream.
+     *
+     * @param volume - New volume of the system.
+     */
+    void SetSystemVolume(f32 volume) override;
+
+private:
+    /// Path stream files are named after
+    std::filesystem::path output_path;
+    /// Vector of streams managed by this sink
+    std::vector<SinkStreamPtr> sink_streams;
+};
+
+/**
+ * Get the reported latency for this sink.
+ *
+ * @return Minimum latency for this sink.
+ */
+u32 GetFileLatency();
+
+} // namespace AudioCore::Sink
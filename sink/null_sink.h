@@ -7,43 +7,70 @@
 #include <string_view>
 #include <vector>
 
+#include <audio_core/common/settings.h>
 #include <audio_core/sink/sink.h>
 #include <audio_core/sink/sink_stream.h>
+#include <audio_core/sink/virtual_sink_stream.h>
 
 namespace Core {
 class System;
 } // namespace Core
 
 namespace AudioCore::Sink {
-class NullSinkStreamImpl final : public SinkStream {
+/**
+ * Null sink stream, consumes and discards samples on a virtual clock so buffer release and
+ * played-sample accounting behave as they would with a real device.
+ */
+class NullSinkStreamImpl final : public VirtualSinkStream {
 public:
-    explicit NullSinkStreamImpl(Core::System& system_, StreamType type_)
-        : SinkStream{system_, type_} {}
-    ~NullSinkStreamImpl() override {}
-    void AppendBuffer(SinkBuffer&, std::vector<s16>&) override {}
-    std::vector<s16> ReleaseBuffer(u64) override {
-        return {};
+    explicit NullSinkStreamImpl(Core::System& system_, StreamType type_, u32 device_channels_,
+                                u32 system_channels_, u32 speed_)
+        : VirtualSinkStream{system_, type_, speed_} {
+        device_channels = device_channels_;
+        system_channels = system_channels_;
+    }
+    ~NullSinkStreamImpl() override {
+        Stop();
+    }
+
+protected:
+    void Callback(u64 num_frames) override {
+        scratch.resize(num_frames * device_channels);
+        if (type == StreamType::In) {
+            ProcessAudioIn(scratch, num_frames);
+        } else {
+            ProcessAudioOutAndRender(scratch, num_frames);
+        }
     }
+
+private:
+    /// Discarded output samples, or the silence fed to input streams
+    std::vector<s16> scratch;
 };
 
 /**
- * A no-op sink for when no audio out is wanted.
+ * A sink for when no audio out is wanted. Each stream is still consumed on a virtual clock, see
+ * Settings::values.audio_null_sink_speed.
  */
 class NullSink final : public Sink {
 public:
     explicit NullSink(std::string_view) {}
     ~NullSink() override = default;
 
-    SinkStream* AcquireSinkStream(Core::System& system, u32, const std::string&,
+    SinkStream* AcquireSinkStream(Core::System& system, u32 system_channels, const std::string&,
                                   StreamType type) override {
-        if (null_sink == nullptr) {
-            null_sink = std::make_unique<NullSinkStreamImpl>(system, type);
-        }
-        return null_sink.get();
+        SinkStreamPtr& stream = sink_streams.emplace_back(std::make_unique<NullSinkStreamImpl>(
+            system, type, device_channels, system_channels,
+            Settings::values.audio_null_sink_speed));
+        return stream.get();
     }
 
-    void CloseStream(SinkStream*) override {}
-    void CloseStreams() override {}
+    void CloseStream(SinkStream* stream) override {
+        std::erase_if(sink_streams, [stream](const auto& ptr) { return ptr.get() == stream; });
+    }
+    void CloseStreams() override {
+        sink_streams.clear();
+    }
     f32 GetDeviceVolume() const override {
         return 1.0f;
     }
@@ -51,7 +78,8 @@ public:
     void SetSystemVolume(f32 volume) override {}
 
 private:
-    SinkStreamPtr null_sink{};
+    /// Vector of streams managed by this sink
+    std::vector<SinkStreamPtr> sink_streams;
 };
 
 } // namespace AudioCore::Sink
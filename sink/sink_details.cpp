@@ -14,6 +14,7 @@
 #ifdef HAVE_SDL2
 #include <audio_core/sink/sdl2_sink.h>
 #endif
+#include <audio_core/sink/file_sink.h>
 #include <audio_core/sink/null_sink.h>
 #include <audio_core/common/logging/log.h>
 
@@ -69,6 +70,14 @@ constexpr SinkDetails sink_details[] = {
         &GetSDLLatency,
     },
 #endif
+    SinkDetails{
+        "file",
+        [](std::string_view device_id) -> std::unique_ptr<Sink> {
+            return std::make_unique<FileSink>(device_id);
+        },
+        [](bool capture) { return std::vector<std::string>{auto_device_name}; },
+        &GetFileLatency,
+    },
     SinkDetails{"null",
                 [](std::string_view device_id) -> std::unique_ptr<Sink> {
                     return std::make_unique<NullSink>(device_id);
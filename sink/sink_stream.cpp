@@ -1,9 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: MPL-2.0
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <span>
 #include <vector>
 
@@ -12,13 +15,28 @@
 #include <audio_core/sink/sink_stream.h>
 #include <audio_core/common/common_types.h>
 #include <audio_core/common/fixed_point.h>
+#include <audio_core/common/logging/log.h>
+#include <audio_core/common/microprofile.h>
 #include <audio_core/common/settings.h>
 #include <core/core.h>
 #include <core/core_timing.h>
 #include <core/core_timing_util.h>
 
+MICROPROFILE_DEFINE(Audio_SinkCallback, "Audio", "Sink Callback", MP_RGB(60, 19, 97));
+
 namespace AudioCore::Sink {
 
+/// How long ClearQueue waits for the backend callback to clear the queue before doing it itself
+constexpr std::chrono::milliseconds ClearQueueTimeout{200};
+
+f32 SinkStream::GetOutputVolume() const {
+    auto yuzu_volume{Settings::Volume()};
+    if (yuzu_volume > 1.0f) {
+        yuzu_volume = 0.6f + 20 * std::log10(yuzu_volume);
+    }
+    return system_volume * device_volume * yuzu_volume;
+}
+
 void SinkStream::AppendBuffer(SinkBuffer& buffer, std::vector<s16>& samples) {
     if (type == StreamType::In) {
         queue.enqueue(buffer);
@@ -26,114 +44,138 @@ void SinkStream::AppendBuffer(SinkBuffer& buffer, std::vector<s16>& samples) {
         return;
     }
 
-    constexpr s32 min{std::numeric_limits<s16>::min()};
-    constexpr s32 max{std::numeric_limits<s16>::max()};
-
-    auto yuzu_volume{Settings::Volume()};
-    if (yuzu_volume > 1.0f) {
-        yuzu_volume = 0.6f + 20 * std::log10(yuzu_volume);
+    const auto num_frames{samples.size() / system_channels};
+    output_converter.Configure(system_channels, device_channels, GetOutputVolume());
+    if (!output_converter.IsPassthrough()) {
+        // Convert in place, growing the buffer first if the device has more channels.
+        samples.resize(num_frames * std::max(system_channels, device_channels));
+        output_converter.Convert(samples, num_frames);
+        samples.resize(num_frames * device_channels);
     }
-    auto volume{system_volume * device_volume * yuzu_volume};
-
-    if (system_channels == 6 && device_channels == 2) {
-        // We're given 6 channels, but our device only outputs 2, so downmix.
-        static constexpr std::array<f32, 4> down_mix_coeff{1.0f, 0.707f, 0.251f, 0.707f};
-
-        for (u32 read_index = 0, write_index = 0; read_index < samples.size();
-             read_index += system_channels, write_index += device_channels) {
-            const auto left_sample{
-                ((Common::FixedPoint<49, 15>(
-                      samples[read_index + static_cast<u32>(Channels::FrontLeft)]) *
-                      down_mix_coeff[0] +
-                  samples[read_index + static_cast<u32>(Channels::Center)] * down_mix_coeff[1] +
-                  samples[read_index + static_cast<u32>(Channels::LFE)] * down_mix_coeff[2] +
-                  samples[read_index + static_cast<u32>(Channels::BackLeft)] * down_mix_coeff[3]) *
-                 volume)
-                    .to_int()};
-
-            const auto right_sample{
-                ((Common::FixedPoint<49, 15>(
-                      samples[read_index + static_cast<u32>(Channels::FrontRight)]) *
-                      down_mix_coeff[0] +
-                  samples[read_index + static_cast<u32>(Channels::Center)] * down_mix_coeff[1] +
-                  samples[read_index + static_cast<u32>(Channels::LFE)] * down_mix_coeff[2] +
-                  samples[read_index + static_cast<u32>(Channels::BackRight)] * down_mix_coeff[3]) *
-                 volume)
-                    .to_int()};
-
-            samples[write_index + static_cast<u32>(Channels::FrontLeft)] =
-                static_cast<s16>(std::clamp(left_sample, min, max));
-            samples[write_index + static_cast<u32>(Channels::FrontRight)] =
-                static_cast<s16>(std::clamp(right_sample, min, max));
-        }
-
-        samples.resize(samples.size() / system_channels * device_channels);
-
-    } else if (system_channels == 2 && device_channels == 6) {
-        // We need moar samples! Not all games will provide 6 channel audio.
-        // TODO: Implement some upmixing here. Currently just passthrough, with other
-        // channels left as silence.
-        std::vector<s16> new_samples(samples.size() / system_channels * device_channels, 0);
-
-        for (u32 read_index = 0, write_index = 0; read_index < samples.size();
-             read_index += system_channels, write_index += device_channels) {
-            const auto left_sample{static_cast<s16>(std::clamp(
-                static_cast<s32>(
-                    static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontLeft)]) *
-                    volume),
-                min, max))};
-
-            new_samples[write_index + static_cast<u32>(Channels::FrontLeft)] = left_sample;
-
-            const auto right_sample{static_cast<s16>(std::clamp(
-                static_cast<s32>(
-                    static_cast<f32>(samples[read_index + static_cast<u32>(Channels::FrontRight)]) *
-                    volume),
-                min, max))};
 
-            new_samples[write_index + static_cast<u32>(Channels::FrontRight)] = right_sample;
-        }
-        samples = std::move(new_samples);
+    if (const auto pushed{samples_buffer.Push(samples)}; pushed < samples.size()) {
+        statistics.RecordOverrun(samples.size() - pushed);
+    }
+    last_buffer_frames = buffer.frames;
+    queue.enqueue(buffer);
+    queued_buffers++;
+    OnBufferQueued();
+}
 
-    } else if (volume != 1.0f) {
-        for (u32 i = 0; i < samples.size(); i++) {
-            samples[i] = static_cast<s16>(
-                std::clamp(static_cast<s32>(static_cast<f32>(samples[i]) * volume), min, max));
-        }
+std::span<s16> SinkStream::ReserveBuffer(const u64 num_samples) {
+    const auto span{samples_buffer.ReserveWrite(num_samples)};
+    if (span.size() < num_samples) {
+        statistics.RecordOverrun(num_samples - span.size());
     }
+    return span;
+}
 
-    samples_buffer.Push(samples);
+void SinkStream::CommitBuffer(SinkBuffer& buffer, const u64 num_samples) {
+    samples_buffer.CommitWrite(num_samples);
+    last_buffer_frames = buffer.frames;
     queue.enqueue(buffer);
     queued_buffers++;
+    OnBufferQueued();
 }
 
-std::vector<s16> SinkStream::ReleaseBuffer(u64 num_samples) {
-    constexpr s32 min = std::numeric_limits<s16>::min();
-    constexpr s32 max = std::numeric_limits<s16>::max();
+void SinkStream::AppendBufferInPlace(SinkBuffer& buffer) {
+    queued_in_place_frames += buffer.frames;
+    last_buffer_frames = buffer.frames;
+    queue.enqueue(buffer);
+    queued_buffers++;
+    OnBufferQueued();
+}
 
-    auto samples{samples_buffer.Pop(num_samples)};
+u64 SinkStream::ReleaseBuffer(std::span<s16> samples) {
+    const auto recorded{samples_buffer.Pop(samples.data(), samples.size())};
 
     // TODO: Up-mix to 6 channels if the game expects it.
     // For audio input this is unlikely to ever be the case though.
 
     // Incoming mic volume seems to always be very quiet, so multiply by an additional 8 here.
     // TODO: Play with this and find something that works better.
-    auto volume{system_volume * device_volume * 8};
-    for (u32 i = 0; i < samples.size(); i++) {
-        samples[i] = static_cast<s16>(
-            std::clamp(static_cast<s32>(static_cast<f32>(samples[i]) * volume), min, max));
-    }
+    input_converter.Configure(device_channels, device_channels,
+                              system_volume * device_volume * 8);
+    input_converter.Convert(samples.first(recorded), recorded / device_channels);
 
-    if (samples.size() < num_samples) {
-        samples.resize(num_samples, 0);
+    std::fill(samples.begin() + recorded, samples.end(), s16{0});
+    return recorded;
+}
+
+bool SinkStream::TakeConsumedBuffer(const u64 tag) {
+    // Buffers are consumed in order, so any other tag ahead of this one is from a buffer which
+    // was released without being checked.
+    while (const auto* consumed_tag{consumed_tags.peek()}) {
+        const bool found{*consumed_tag == tag};
+        consumed_tags.pop();
+        if (found) {
+            return true;
+        }
     }
-    return samples;
+    return false;
 }
 
 void SinkStream::ClearQueue() {
-    samples_buffer.Pop();
-    while (queue.pop()) {
+    bool cleared{false};
+    if (!paused) {
+        // The backend callback is consuming the queue, hand it the clear.
+        clear_requested.store(true, std::memory_order_release);
+        cleared = clear_done_sema.wait(
+            std::chrono::duration_cast<std::chrono::microseconds>(ClearQueueTimeout).count());
+        if (!cleared) {
+            // The backend may have stopped calling back. Take the request back, unless the
+            // callback took it just now, in which case it's about to finish.
+            if (clear_requested.exchange(false, std::memory_order_acq_rel)) {
+                LOG_WARNING(Audio_Sink, "Stream {} did not call back in time, clearing directly",
+                            name);
+            } else {
+                cleared = clear_done_sema.wait();
+            }
+        }
     }
+
+    if (!cleared) {
+        // A callback may still be running, or resume at any moment. Hold it off while the queue
+        // and any buffer it reads in place are dropped from this thread.
+        std::scoped_lock lock{callback_mutex};
+        DropQueuedBuffers();
+    }
+
+    // Recorded samples are consumed here rather than by the callback, which records into the ring.
+    if (type == StreamType::In) {
+        samples_buffer.CommitRead(samples_buffer.Size());
+    }
+
+    // The callback has stopped with the dropped buffers, so no more of their tags can be
+    // published, and none can match a buffer appended after this.
+    while (consumed_tags.pop()) {
+    }
+}
+
+void SinkStream::ProcessClearRequest() {
+    if (!clear_requested.load(std::memory_order_relaxed) ||
+        !clear_requested.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    DropQueuedBuffers();
+    clear_done_sema.signal();
+}
+
+void SinkStream::DropQueuedBuffers() {
+    // Count the dropped frames as consumed, so buffers read in place are seen as released.
+    u64 dropped_frames{0};
+    if (!playing_buffer.consumed) {
+        dropped_frames = playing_buffer.frames - playing_buffer.frames_played;
+    }
+    if (type != StreamType::In) {
+        samples_buffer.CommitRead(samples_buffer.Size());
+    }
+    SinkBuffer buffer{};
+    while (queue.try_dequeue(buffer)) {
+        dropped_frames += buffer.frames;
+    }
+    queued_in_place_frames = 0;
+    consumed_frame_count.fetch_add(dropped_frames, std::memory_order_release);
     queued_buffers = 0;
     playing_buffer = {};
     playing_buffer.consumed = true;
@@ -145,20 +187,32 @@ void SinkStream::ProcessAudioIn(std::span<const s16> input_buffer, std::size_t n
     const std::size_t frame_size_bytes = frame_size * sizeof(s16);
     size_t frames_written{0};
 
+    // ClearQueue holds this while it clears the queue itself, drop the input until it's done.
+    std::unique_lock callback_lock{callback_mutex, std::try_to_lock};
+    if (!callback_lock) {
+        return;
+    }
+
+    ProcessClearRequest();
+
     // If we're paused or going to shut down, we don't want to consume buffers as coretiming is
     // paused and we'll desync, so just return.
     if (system.IsPaused() || system.IsShuttingDown()) {
+        statistics.RecordPausedCallback();
         return;
     }
 
+    statistics.RecordCallback(samples_buffer.Size() / frame_size, num_frames);
+    bool buffer_consumed{false};
+
     while (frames_written < num_frames) {
         // If the playing buffer has been consumed or has no frames, we need a new one
         if (playing_buffer.consumed || playing_buffer.frames == 0) {
             if (!queue.try_dequeue(playing_buffer)) {
                 // If no buffer was available we've underrun, just push the samples and
                 // continue.
-                samples_buffer.Push(&input_buffer[frames_written * frame_size],
-                                    (num_frames - frames_written) * frame_size);
+                PushInput(&input_buffer[frames_written * frame_size],
+                          (num_frames - frames_written) * frame_size);
                 frames_written = num_frames;
                 continue;
             }
@@ -171,8 +225,7 @@ void SinkStream::ProcessAudioIn(std::span<const s16> input_buffer, std::size_t n
         size_t frames_available{std::min<u64>(playing_buffer.frames - playing_buffer.frames_played,
                                               num_frames - frames_written)};
 
-        samples_buffer.Push(&input_buffer[frames_written * frame_size],
-                            frames_available * frame_size);
+        PushInput(&input_buffer[frames_written * frame_size], frames_available * frame_size);
 
         frames_written += frames_available;
         playing_buffer.frames_played += frames_available;
@@ -181,30 +234,41 @@ void SinkStream::ProcessAudioIn(std::span<const s16> input_buffer, std::size_t n
         // consumed
         if (playing_buffer.frames_played >= playing_buffer.frames) {
             playing_buffer.consumed = true;
+            buffer_consumed |= PublishConsumedBuffer(playing_buffer);
         }
     }
 
     std::memcpy(&last_frame[0], &input_buffer[(frames_written - 1) * frame_size], frame_size_bytes);
+
+    if (buffer_consumed) {
+        buffer_consumed_callback();
+    }
 }
 
 void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::size_t num_frames) {
+    MICROPROFILE_SCOPE(Audio_SinkCallback);
     const std::size_t num_channels = GetDeviceChannels();
     const std::size_t frame_size = num_channels;
     const std::size_t frame_size_bytes = frame_size * sizeof(s16);
     size_t frames_written{0};
     size_t actual_frames_written{0};
 
+    // ClearQueue holds this while it clears the queue itself, play silence until it's done.
+    std::unique_lock callback_lock{callback_mutex, std::try_to_lock};
+    if (callback_lock) {
+        ProcessClearRequest();
+    }
+
     // If we're paused or going to shut down, we don't want to consume buffers as coretiming is
     // paused and we'll desync, so just play silence.
-    if (system.IsPaused() || system.IsShuttingDown()) {
+    if (!callback_lock || system.IsPaused() || system.IsShuttingDown()) {
         if (system.IsShuttingDown()) {
-            {
-                std::scoped_lock lk{release_mutex};
-                queued_buffers.store(0);
-            }
-            release_cv.notify_one();
+            queued_buffers.store(0);
+            free_space_sema.signal();
         }
 
+        statistics.RecordPausedCallback();
+
         static constexpr std::array<s16, 6> silence{};
         for (size_t i = frames_written; i < num_frames; i++) {
             std::memcpy(&output_buffer[i * frame_size], &silence[0], frame_size_bytes);
@@ -212,35 +276,70 @@ void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::siz
         return;
     }
 
-    while (frames_written < num_frames) {
+    const auto queued_frames{samples_buffer.Size() / frame_size + queued_in_place_frames.load()};
+    statistics.RecordCallback(queued_frames, num_frames);
+    bool underrun{false};
+    bool buffer_consumed{false};
+
+    // When compensating for drift, pop the frames the resampler asks for into its input, rather
+    // than straight into the output.
+    const bool compensate_drift{Settings::values.audio_drift_compensation};
+    if (compensate_drift && !compensating_drift) {
+        drift_compensator.Reset();
+    }
+    compensating_drift = compensate_drift;
+
+    std::span<s16> dest_buffer{output_buffer};
+    std::size_t dest_frames{num_frames};
+    if (compensate_drift) {
+        drift_compensator.UpdateRatio(queued_frames,
+                                      GetRingSize() * last_buffer_frames.load() / 2);
+        dest_buffer = drift_compensator.PrepareInput(num_frames, static_cast<u32>(num_channels));
+        dest_frames = dest_buffer.size() / frame_size;
+    }
+
+    while (frames_written < dest_frames) {
         // If the playing buffer has been consumed or has no frames, we need a new one
         if (playing_buffer.consumed || playing_buffer.frames == 0) {
             if (!queue.try_dequeue(playing_buffer)) {
                 // If no buffer was available we've underrun, fill the remaining buffer with
                 // the last written frame and continue.
-                for (size_t i = frames_written; i < num_frames; i++) {
-                    std::memcpy(&output_buffer[i * frame_size], &last_frame[0], frame_size_bytes);
+                statistics.RecordUnderrun(dest_frames - frames_written);
+                underrun = true;
+                for (size_t i = frames_written; i < dest_frames; i++) {
+                    std::memcpy(&dest_buffer[i * frame_size], &last_frame[0], frame_size_bytes);
                 }
-                frames_written = num_frames;
+                frames_written = dest_frames;
                 continue;
             }
-            // Successfully dequeued a new buffer.
-            queued_buffers--;
-
-            {
-                std::unique_lock lk{release_mutex};
+            // Successfully dequeued a new buffer. Only wake the renderer if it could be waiting
+            // on a full queue, signalling never blocks this thread.
+            if (queued_buffers.fetch_sub(1) >= max_queue_size) {
+                free_space_sema.signal();
+            }
+            if (playing_buffer.samples != nullptr) {
+                in_place_converter.Configure(system_channels, device_channels, GetOutputVolume());
             }
-
-            release_cv.notify_one();
         }
 
         // Get the minimum frames available between the currently playing buffer, and the
         // amount we have left to fill
         size_t frames_available{std::min<u64>(playing_buffer.frames - playing_buffer.frames_played,
-                                              num_frames - frames_written)};
-
-        samples_buffer.Pop(&output_buffer[frames_written * frame_size],
-                           frames_available * frame_size);
+                                              dest_frames - frames_written)};
+
+        if (playing_buffer.samples != nullptr) {
+            // Read straight from the buffer, converting as AppendBuffer would have.
+            const auto src_channels{GetSystemChannels()};
+            in_place_converter.Convert(
+                {&playing_buffer.samples[playing_buffer.frames_played * src_channels],
+                 frames_available * src_channels},
+                dest_buffer.subspan(frames_written * frame_size, frames_available * frame_size),
+                frames_available);
+            queued_in_place_frames -= frames_available;
+        } else {
+            samples_buffer.Pop(&dest_buffer[frames_written * frame_size],
+                               frames_available * frame_size);
+        }
 
         frames_written += frames_available;
         actual_frames_written += frames_available;
@@ -250,36 +349,103 @@ void SinkStream::ProcessAudioOutAndRender(std::span<s16> output_buffer, std::siz
         // consumed
         if (playing_buffer.frames_played >= playing_buffer.frames) {
             playing_buffer.consumed = true;
+            buffer_consumed |= PublishConsumedBuffer(playing_buffer);
         }
     }
 
-    std::memcpy(&last_frame[0], &output_buffer[(frames_written - 1) * frame_size],
-                frame_size_bytes);
+    if (frames_written != 0) {
+        std::memcpy(&last_frame[0], &dest_buffer[(frames_written - 1) * frame_size],
+                    frame_size_bytes);
+    }
+
+    // Published after the reads above, so a buffer read in place can be reused once it's counted.
+    consumed_frame_count.fetch_add(actual_frames_written, std::memory_order_release);
+    if (buffer_consumed) {
+        buffer_consumed_callback();
+    }
+
+    if (compensate_drift) {
+        drift_compensator.Resample(output_buffer, num_frames);
+    }
 
-    {
-        std::scoped_lock lk{sample_count_lock};
-        last_sample_count_update_time =
-            Core::Timing::CyclesToUs(system.CoreTiming().GetClockTicks());
-        min_played_sample_count = max_played_sample_count;
-        max_played_sample_count += actual_frames_written;
+    if (adaptive_ring_size && queue_depth.Update(queued_frames, num_frames, underrun)) {
+        // Wake the renderer in case the queue grew while it was waiting for space.
+        max_queue_size = queue_depth.GetDepth();
+        free_space_sema.signal();
     }
+
+    // Publish the new sample counts under the sequence counter. This is the only writer.
+    const auto update_time{Core::Timing::CyclesToUs(system.CoreTiming().GetClockTicks())};
+    const auto max_played{max_played_sample_count.load(std::memory_order_relaxed)};
+    const auto sequence{sample_count_sequence.load(std::memory_order_relaxed)};
+    sample_count_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    last_sample_count_update_time.store(update_time.count(), std::memory_order_relaxed);
+    min_played_sample_count.store(max_played, std::memory_order_relaxed);
+    max_played_sample_count.store(max_played + actual_frames_written, std::memory_order_relaxed);
+    sample_count_sequence.store(sequence + 2, std::memory_order_release);
 }
 
 u64 SinkStream::GetExpectedPlayedSampleCount() {
-    std::scoped_lock lk{sample_count_lock};
+    u64 min_played{};
+    u64 max_played{};
+    std::chrono::microseconds update_time{};
+    u32 sequence{};
+    do {
+        // Retry while the callback is mid-write, or wrote while we were reading.
+        sequence = sample_count_sequence.load(std::memory_order_acquire);
+        min_played = min_played_sample_count.load(std::memory_order_relaxed);
+        max_played = max_played_sample_count.load(std::memory_order_relaxed);
+        update_time = std::chrono::microseconds{
+            last_sample_count_update_time.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 ||
+             sequence != sample_count_sequence.load(std::memory_order_relaxed));
+
     auto cur_time{Core::Timing::CyclesToUs(system.CoreTiming().GetClockTicks())};
-    auto time_delta{cur_time - last_sample_count_update_time};
-    auto exp_played_sample_count{min_played_sample_count +
+    auto time_delta{cur_time - update_time};
+    auto exp_played_sample_count{min_played +
                                  (TargetSampleRate * time_delta) / std::chrono::seconds{1}};
 
     // Add 15ms of latency in sample reporting to allow for some leeway in scheduler timings
-    return std::min<u64>(exp_played_sample_count, max_played_sample_count) + TargetSampleCount * 3;
+    return std::min<u64>(exp_played_sample_count, max_played) + TargetSampleCount * 3;
 }
 
 void SinkStream::WaitFreeSpace() {
-    std::unique_lock lk{release_mutex};
-    release_cv.wait_for(lk, std::chrono::milliseconds(5),
-                        [this]() { return queued_buffers < max_queue_size; });
+    constexpr std::chrono::microseconds timeout{std::chrono::milliseconds(5)};
+    const auto start{std::chrono::steady_clock::now()};
+    auto waited{std::chrono::microseconds::zero()};
+    bool signalled{true};
+
+    // The semaphore may hold stale signals from buffers consumed while nobody was waiting, so
+    // recheck the queue after every wake.
+    while (queued_buffers >= max_queue_size) {
+        if (waited >= timeout || !free_space_sema.wait((timeout - waited).count())) {
+            signalled = false;
+            break;
+        }
+        waited = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+    statistics.RecordWaitFreeSpace(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now() - start),
+                                   !signalled);
+}
+
+bool SinkStream::PublishConsumedBuffer(const SinkBuffer& buffer) {
+    if (!buffer_consumed_callback) {
+        return false;
+    }
+    // Published after the buffer's last samples were read, so a buffer read in place can be
+    // reused once its tag is taken.
+    consumed_tags.enqueue(buffer.tag);
+    return true;
+}
+
+void SinkStream::PushInput(const s16* samples, const std::size_t num_samples) {
+    if (const auto pushed{samples_buffer.Push(samples, num_samples)}; pushed < num_samples) {
+        statistics.RecordOverrun(num_samples - pushed);
+    }
 }
 
 } // namespace AudioCore::Sink
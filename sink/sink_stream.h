@@ -6,6 +6,7 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <span>
@@ -13,9 +14,13 @@
 
 #include <audio_core/common/common.h>
 #include <audio_core/common/common_types.h>
+#include <audio_core/common/mirrored_ring_buffer.h>
 #include <audio_core/common/reader_writer_queue.h>
-#include <audio_core/common/ring_buffer.h>
 #include <audio_core/common/thread.h>
+#include <audio_core/sink/adaptive_queue_depth.h>
+#include <audio_core/sink/channel_converter.h>
+#include <audio_core/sink/drift_compensator.h>
+#include <audio_core/sink/sink_stream_statistics.h>
 
 namespace Core {
 class System;
@@ -34,6 +39,8 @@ struct SinkBuffer {
     u64 frames_played;
     u64 tag;
     bool consumed;
+    /// Samples the backend reads in place, see AppendBufferInPlace. Null if they're in the ring.
+    const s16* samples;
 };
 
 /**
@@ -147,6 +154,13 @@ public:
         device_volume = volume_;
     }
 
+    /**
+     * Get the volume applied to output samples, combining the system, device and yuzu volumes.
+     *
+     * @return The output volume.
+     */
+    f32 GetOutputVolume() const;
+
     /**
      * Get the number of queued audio buffers.
      *
@@ -157,12 +171,46 @@ public:
     }
 
     /**
-     * Set the maximum buffer queue size.
+     * Get the number of frames waiting in the sample ring.
+     *
+     * @return The number of queued frames.
+     */
+    u64 GetQueuedFrameCount() const {
+        return samples_buffer.Size() / device_channels + queued_in_place_frames.load();
+    }
+
+    /**
+     * Set the maximum buffer queue size, disabling adaptive sizing.
      */
     void SetRingSize(u32 ring_size) {
+        adaptive_ring_size = false;
         max_queue_size = ring_size;
     }
 
+    /**
+     * Let the backend callback adapt the maximum buffer queue size to how regularly it runs,
+     * see AdaptiveQueueDepth. Must be set before the stream is started.
+     *
+     * @param min_size       - Smallest queue size.
+     * @param max_size       - Largest queue size.
+     * @param shrink_windows - Seconds of stable playback needed before the queue shrinks.
+     * @param initial_size   - Queue size to start from.
+     */
+    void SetAdaptiveRingSize(u32 min_size, u32 max_size, u32 shrink_windows, u32 initial_size) {
+        queue_depth.Configure(min_size, max_size, shrink_windows, initial_size);
+        max_queue_size = queue_depth.GetDepth();
+        adaptive_ring_size = true;
+    }
+
+    /**
+     * Get the maximum buffer queue size.
+     *
+     * @return The current maximum queue size.
+     */
+    u32 GetRingSize() const {
+        return max_queue_size.load();
+    }
+
     /**
      * Append a new buffer and its samples to a waiting queue to play.
      *
@@ -172,15 +220,77 @@ public:
     virtual void AppendBuffer(SinkBuffer& buffer, std::vector<s16>& samples);
 
     /**
-     * Release a buffer. Audio In only, will fill a buffer with recorded samples.
+     * Reserve space in the sample ring to write a buffer's samples in place, avoiding the
+     * allocation and copies of AppendBuffer. Output streams only, samples must already be in the
+     * device's channel layout with GetOutputVolume applied. Must be followed by CommitBuffer.
+     *
+     * @param num_samples - Number of samples to reserve.
+     * @return Contiguous writable samples in the ring, fewer than requested if the ring is full.
+     */
+    std::span<s16> ReserveBuffer(u64 num_samples);
+
+    /**
+     * Queue a buffer whose samples were written in place after ReserveBuffer.
+     *
+     * @param buffer      - Audio buffer information to be queued.
+     * @param num_samples - Number of samples written, at most the number reserved.
+     */
+    void CommitBuffer(SinkBuffer& buffer, u64 num_samples);
+
+    /**
+     * Queue a buffer whose samples the backend reads in place, in the system's channel layout,
+     * avoiding the allocation and copies of AppendBuffer. Output streams only. The samples must
+     * stay valid until GetConsumedFrameCount passes the end of the buffer, or the queue is cleared.
+     *
+     * @param buffer - Audio buffer information to be queued, with samples set.
+     */
+    void AppendBufferInPlace(SinkBuffer& buffer);
+
+    /**
+     * Get the total number of frames consumed from queued buffers, by the backend or by clearing
+     * the queue. Once past the end of a buffer queued with AppendBufferInPlace, its samples are no
+     * longer read.
+     *
+     * @return The number of frames consumed.
+     */
+    u64 GetConsumedFrameCount() const {
+        return consumed_frame_count.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Release a buffer. Audio In only, will fill a buffer with recorded samples, popping them
+     * straight into it. Any samples not recorded yet are filled with silence.
      *
-     * @param num_samples - Maximum number of samples to receive.
-     * @return Vector of recorded samples. May have fewer than num_samples.
+     * @param samples - Buffer to fill, such as the game's buffer in its memory.
+     * @return Number of recorded samples written, the rest of the buffer is silence.
      */
-    virtual std::vector<s16> ReleaseBuffer(u64 num_samples);
+    virtual u64 ReleaseBuffer(std::span<s16> samples);
+
+    /**
+     * Publish the tag of each buffer once the backend is done with it, calling a function from
+     * the backend callback whenever any were, rather than having buffers polled for with
+     * GetExpectedPlayedSampleCount. Must be set before the stream is started. Audio In/Out only.
+     *
+     * @param callback - Function to call when buffers have been consumed.
+     */
+    void SetBufferConsumedCallback(std::function<void()> callback) {
+        buffer_consumed_callback = std::move(callback);
+    }
+
+    /**
+     * Check if a buffer's tag has been published by the backend, taking it if so. Must be checked
+     * in the order buffers were appended, see SetBufferConsumedCallback.
+     *
+     * @param tag - Tag of the oldest buffer not yet taken.
+     * @return True if the buffer has been consumed, otherwise false.
+     */
+    bool TakeConsumedBuffer(u64 tag);
 
     /**
      * Empty out the buffer queue.
+     * While the stream is started, the queue belongs to the backend callback, so the clear is
+     * handed to its next call, and this waits until it's done. If the callback doesn't run in
+     * time, the queue is dropped here with the callback held off, see callback_mutex.
      */
     void ClearQueue();
 
@@ -212,7 +322,36 @@ public:
      */
     void WaitFreeSpace();
 
+    /**
+     * Get a snapshot of this stream's underrun, overrun and callback timing telemetry.
+     *
+     * @return The statistics snapshot.
+     */
+    SinkStreamStatisticsSnapshot GetStatistics() const {
+        return statistics.GetSnapshot();
+    }
+
+    /**
+     * Clear this stream's telemetry.
+     */
+    void ResetStatistics() {
+        statistics.Reset();
+    }
+
 protected:
+    /**
+     * Called after an output buffer has been queued, for backends which consume on demand rather
+     * than on a device clock.
+     */
+    virtual void OnBufferQueued() {}
+
+    /**
+     * Run a clear requested by ClearQueue, if there is one. Must only be called from the backend
+     * callback's thread. The callbacks call this first, backends which go idle without calling
+     * back must also call it while idle.
+     */
+    void ProcessClearRequest();
+
     /// Core system
     Core::System& system;
     /// Type of this stream
@@ -227,10 +366,36 @@ protected:
     std::string name{};
 
 private:
+    /**
+     * Push recorded samples into the sample ring, counting any which don't fit as an overrun.
+     *
+     * @param samples     - Samples to push.
+     * @param num_samples - Number of samples to push.
+     */
+    void PushInput(const s16* samples, std::size_t num_samples);
+
+    /**
+     * Publish the tag of a buffer the backend is done with, if anyone is listening.
+     *
+     * @param buffer - The consumed buffer.
+     * @return True if the tag was published, otherwise false.
+     */
+    bool PublishConsumedBuffer(const SinkBuffer& buffer);
+
+    /**
+     * Drop the queued buffers and the one playing, counting their frames as consumed, and for
+     * output the samples waiting to be played. Only called by the backend callback, or by
+     * ClearQueue while holding callback_mutex.
+     */
+    void DropQueuedBuffers();
+
     /// Ring buffer of the samples waiting to be played or consumed
-    Common::RingBuffer<s16, 0x10000> samples_buffer;
+    Common::MirroredRingBuffer<s16> samples_buffer{0x10000};
     /// Audio buffers queued and waiting to play
     Common::ReaderWriterQueue<SinkBuffer> queue;
+    /// Held by the backend callback while it works on the queue, and by ClearQueue when it drops
+    /// the queue itself. The callback only ever tries to take it, so it's never kept waiting.
+    std::mutex callback_mutex;
     /// The currently-playing audio buffer
     SinkBuffer playing_buffer{};
     /// The last played (or received) frame of audio, used when the callback underruns
@@ -238,22 +403,55 @@ private:
     /// Number of buffers waiting to be played
     std::atomic<u32> queued_buffers{};
     /// The ring size for audio out buffers (usually 4, rarely 2 or 8)
-    u32 max_queue_size{};
-    /// Locks access to sample count tracking info
-    std::mutex sample_count_lock;
+    std::atomic<u32> max_queue_size{};
+    /// Is the ring size adapted by the backend callback?
+    std::atomic<bool> adaptive_ring_size{};
+    /// Adapts the ring size while adaptive_ring_size is set
+    AdaptiveQueueDepth queue_depth{};
+    /// Sequence counter guarding the sample count tracking below, odd while it's being written.
+    /// Only the backend callback writes, readers retry if they overlap a write.
+    std::atomic<u32> sample_count_sequence{};
     /// Minimum number of total samples that have been played since the last callback
-    u64 min_played_sample_count{};
+    std::atomic<u64> min_played_sample_count{};
     /// Maximum number of total samples that can be played since the last callback
-    u64 max_played_sample_count{};
-    /// The time the two above tracking variables were last written to
-    std::chrono::microseconds last_sample_count_update_time{};
+    std::atomic<u64> max_played_sample_count{};
+    /// The time the two above tracking variables were last written to, in microseconds
+    std::atomic<s64> last_sample_count_update_time{};
     /// Set by the audio render/in/out system which uses this stream
     f32 system_volume{1.0f};
     /// Set via IAudioDevice service calls
     f32 device_volume{1.0f};
-    /// Signalled when ring buffer entries are consumed
-    std::condition_variable release_cv;
-    std::mutex release_mutex;
+    /// Signalled when a buffer is consumed from a full queue, or the system is shutting down
+    Common::spsc_sema::LightweightSemaphore free_space_sema;
+    /// Set by ClearQueue for the backend callback to clear the queue, and reset by whichever of
+    /// them takes it
+    std::atomic<bool> clear_requested{};
+    /// Signalled by the backend callback once it has run a requested clear
+    Common::spsc_sema::LightweightSemaphore clear_done_sema;
+    /// Converts appended samples to the device layout, only used by AppendBuffer
+    ChannelConverter output_converter{};
+    /// Converts samples read in place to the device layout, only used by the backend callback
+    ChannelConverter in_place_converter{};
+    /// Frames of buffers queued with AppendBufferInPlace which haven't been read yet
+    std::atomic<u64> queued_in_place_frames{};
+    /// Frames consumed from queued buffers, see GetConsumedFrameCount
+    std::atomic<u64> consumed_frame_count{};
+    /// Applies the volume to recorded samples, only used by ReleaseBuffer
+    ChannelConverter input_converter{};
+    /// Resamples output to keep the sample ring centered, only used by the backend callback
+    DriftCompensator drift_compensator{};
+    /// Was drift being compensated in the last callback?
+    bool compensating_drift{};
+    /// Frames in the most recently appended buffer, the ring is centered on half the queue size
+    /// of these
+    std::atomic<u64> last_buffer_frames{};
+    /// Called from the backend callback when buffers were consumed, see SetBufferConsumedCallback
+    std::function<void()> buffer_consumed_callback{};
+    /// Tags of consumed buffers, with room for a full AudioOut/AudioIn ring so the backend
+    /// callback doesn't allocate
+    Common::ReaderWriterQueue<u64> consumed_tags{32};
+    /// Underrun, overrun and callback timing telemetry
+    SinkStreamStatistics statistics{};
 };
 
 using SinkStreamPtr = std::unique_ptr<SinkStream>;
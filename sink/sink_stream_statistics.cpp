@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <audio_core/common/common.h>
+#include <audio_core/sink/sink_stream_statistics.h>
+
+namespace AudioCore::Sink {
+
+static SinkStreamDistribution Summarise(const Common::LogHistogram<2, 32>::Snapshot& histogram) {
+    return {
+        .count{histogram.count},
+        .p50{histogram.Percentile(50)},
+        .p99{histogram.Percentile(99)},
+        .max{histogram.max},
+    };
+}
+
+void SinkStreamStatistics::RecordCallback(const u64 queued_frames, const u64 num_frames) {
+    const auto now{std::chrono::steady_clock::now()};
+    callbacks.fetch_add(1, std::memory_order_relaxed);
+    queue_depth_frames.Record(queued_frames);
+
+    if (last_callback_frames != 0) {
+        const auto interval{now - last_callback_time};
+        if (interval < MaxCallbackInterval) {
+            const auto interval_us{static_cast<s64>(
+                std::chrono::duration_cast<std::chrono::microseconds>(interval).count())};
+            const auto expected_us{static_cast<s64>(last_callback_frames * 1'000'000 /
+                                                    TargetSampleRate)};
+            callback_interval_us.Record(static_cast<u64>(interval_us));
+            callback_jitter_us.Record(static_cast<u64>(std::abs(interval_us - expected_us)));
+        }
+    }
+
+    last_callback_time = now;
+    last_callback_frames = num_frames;
+}
+
+void SinkStreamStatistics::RecordPausedCallback() {
+    last_callback_frames = 0;
+}
+
+void SinkStreamStatistics::RecordUnderrun(const u64 frames) {
+    underruns.fetch_add(1, std::memory_order_relaxed);
+    underrun_frames.fetch_add(frames, std::memory_order_relaxed);
+}
+
+void SinkStreamStatistics::RecordOverrun(const u64 samples) {
+    overruns.fetch_add(1, std::memory_order_relaxed);
+    overrun_samples.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void SinkStreamStatistics::RecordWaitFreeSpace(const std::chrono::microseconds time,
+                                               const bool timed_out) {
+    wait_free_space_us.Record(static_cast<u64>(std::max<s64>(time.count(), 0)));
+    if (timed_out) {
+        wait_free_space_timeouts.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SinkStreamStatisticsSnapshot SinkStreamStatistics::GetSnapshot() const {
+    constexpr auto order{std::memory_order_relaxed};
+    return {
+        .callbacks{callbacks.load(order)},
+        .underruns{underruns.load(order)},
+        .underrun_frames{underrun_frames.load(order)},
+        .overruns{overruns.load(order)},
+        .overrun_samples{overrun_samples.load(order)},
+        .queue_depth_frames{Summarise(queue_depth_frames.GetSnapshot())},
+        .callback_interval_us{Summarise(callback_interval_us.GetSnapshot())},
+        .callback_jitter_us{Summarise(callback_jitter_us.GetSnapshot())},
+        .wait_free_space_us{Summarise(wait_free_space_us.GetSnapshot())},
+        .wait_free_space_timeouts{wait_free_space_timeouts.load(order)},
+    };
+}
+
+void SinkStreamStatistics::Reset() {
+    constexpr auto order{std::memory_order_relaxed};
+    callbacks.store(0, order);
+    underruns.store(0, order);
+    underrun_frames.store(0, order);
+    overruns.store(0, order);
+    overrun_samples.store(0, order);
+    wait_free_space_timeouts.store(0, order);
+    queue_depth_frames.Reset();
+    callback_interval_us.Reset();
+    callback_jitter_us.Reset();
+    wait_free_space_us.Reset();
+}
+
+} // namespace AudioCore::Sink
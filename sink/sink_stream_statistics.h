@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <audio_core/common/common_types.h>
+#include <audio_core/common/log_histogram.h>
+
+namespace AudioCore::Sink {
+
+/**
+ * Summary of a distribution of values recorded by a sink stream.
+ */
+struct SinkStreamDistribution {
+    /// Number of values recorded
+    u64 count;
+    /// Median value
+    u64 p50;
+    /// 99th percentile value
+    u64 p99;
+    /// Largest value
+    u64 max;
+};
+
+/**
+ * Snapshot of the telemetry recorded by a sink stream.
+ */
+struct SinkStreamStatisticsSnapshot {
+    /// Number of backend callbacks
+    u64 callbacks;
+    /// Number of output callbacks which ran out of queued buffers
+    u64 underruns;
+    /// Number of frames filled with the last played frame because of underruns
+    u64 underrun_frames;
+    /// Number of times samples were dropped because the sample ring was full
+    u64 overruns;
+    /// Number of samples dropped because the sample ring was full
+    u64 overrun_samples;
+    /// Frames waiting in the sample ring at the start of each callback
+    SinkStreamDistribution queue_depth_frames;
+    /// Time between callbacks, in microseconds
+    SinkStreamDistribution callback_interval_us;
+    /// Distance of each callback interval from the duration of the previous callback's frames,
+    /// in microseconds
+    SinkStreamDistribution callback_jitter_us;
+    /// Time spent blocked in WaitFreeSpace, in microseconds
+    SinkStreamDistribution wait_free_space_us;
+    /// Number of WaitFreeSpace calls which timed out rather than being signalled
+    u64 wait_free_space_timeouts;
+};
+
+/**
+ * Underrun, overrun, queue depth and callback timing telemetry for a sink stream.
+ * Callbacks are recorded by the backend thread, buffer appends and waits by the thread feeding
+ * the stream, and snapshots may be taken from any thread.
+ */
+class SinkStreamStatistics {
+public:
+    /**
+     * Record the start of a backend callback.
+     * Must only be called from the backend thread.
+     *
+     * @param queued_frames - Frames waiting in the sample ring.
+     * @param num_frames    - Frames requested by the callback.
+     */
+    void RecordCallback(u64 queued_frames, u64 num_frames);
+
+    /**
+     * Record that the backend was given silence while the system was paused, so the interval
+     * across the pause is not counted as jitter.
+     * Must only be called from the backend thread.
+     */
+    void RecordPausedCallback();
+
+    /**
+     * Record an output callback running out of queued buffers.
+     *
+     * @param frames - Number of frames filled in place of real samples.
+     */
+    void RecordUnderrun(u64 frames);
+
+    /**
+     * Record samples being dropped because the sample ring was full.
+     *
+     * @param samples - Number of samples dropped.
+     */
+    void RecordOverrun(u64 samples);
+
+    /**
+     * Record the time spent waiting for free space in the buffer queue.
+     * Must only be called from the thread feeding the stream.
+     *
+     * @param time      - Time spent waiting.
+     * @param timed_out - True if the wait timed out rather than being signalled.
+     */
+    void RecordWaitFreeSpace(std::chrono::microseconds time, bool timed_out);
+
+    /**
+     * Summarise the recorded telemetry.
+     *
+     * @return The statistics snapshot.
+     */
+    SinkStreamStatisticsSnapshot GetSnapshot() const;
+
+    /**
+     * Clear all recorded telemetry. Values recorded concurrently may be lost.
+     */
+    void Reset();
+
+private:
+    /// ~25% resolution, covering values up to 2^32
+    using Histogram = Common::LogHistogram<2, 32>;
+    /// Callback intervals longer than this are a stream restart, rather than jitter
+    static constexpr std::chrono::seconds MaxCallbackInterval{1};
+
+    std::atomic<u64> callbacks{};
+    std::atomic<u64> underruns{};
+    std::atomic<u64> underrun_frames{};
+    std::atomic<u64> overruns{};
+    std::atomic<u64> overrun_samples{};
+    std::atomic<u64> wait_free_space_timeouts{};
+    Histogram queue_depth_frames{};
+    Histogram callback_interval_us{};
+    Histogram callback_jitter_us{};
+    Histogram wait_free_space_us{};
+
+    /// Time of the last callback, only accessed by the backend thread
+    std::chrono::steady_clock::time_point last_callback_time{};
+    /// Frames requested by the last callback, 0 if the interval from it shouldn't be recorded
+    u64 last_callback_frames{};
+};
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <audio_core/common/common_types.h>
+#include <audio_core/common/settings.h>
+#include <audio_core/common/thread.h>
+#include <audio_core/sink/virtual_sink_stream.h>
+#include <core/core.h>
+
+namespace AudioCore::Sink {
+
+/// How far a clocked stream may fall behind before it stops catching up, e.g. after a stall
+constexpr std::chrono::milliseconds MaxClockLag{100};
+
+VirtualSinkStream::VirtualSinkStream(Core::System& system_, StreamType type_, const u32 speed_)
+    : SinkStream{system_, type_}, speed{type_ == StreamType::In ? std::max(speed_, 1U) : speed_} {}
+
+void VirtualSinkStream::Start(bool resume) {
+    if (!paused) {
+        return;
+    }
+
+    paused = false;
+    device_thread =
+        std::jthread([this](std::stop_token stop_token) { DeviceThreadFunc(stop_token); });
+}
+
+void VirtualSinkStream::Stop() {
+    if (paused) {
+        return;
+    }
+
+    paused = true;
+    device_thread.request_stop();
+    queued_sema.signal();
+    device_thread.join();
+}
+
+void VirtualSinkStream::OnBufferQueued() {
+    if (IsUnclocked()) {
+        queued_sema.signal();
+    }
+}
+
+void VirtualSinkStream::DeviceThreadFunc(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("AudioVirtualDevice");
+    Common::SetCurrentThreadPriority(Common::ThreadPriority::High);
+    Common::SetCurrentThreadAffinity(Settings::values.audio_thread_cpu_mask);
+
+    const auto period{speed == 0 ? CallbackPeriod : CallbackPeriod / speed};
+    auto next_callback{std::chrono::steady_clock::now()};
+    while (!stop_token.stop_requested()) {
+        if (!IsUnclocked()) {
+            next_callback += period;
+            const auto now{std::chrono::steady_clock::now()};
+            if (now > next_callback + MaxClockLag) {
+                next_callback = now;
+            } else {
+                std::this_thread::sleep_until(next_callback);
+            }
+            Callback(TargetSampleCount);
+            continue;
+        }
+
+        // Only consume whole queued buffers, so unclocked output never underruns. The semaphore
+        // may hold stale signals, so recheck after every wake.
+        const auto queued_frames{GetQueuedFrameCount()};
+        if (queued_frames == 0 || system.IsPaused()) {
+            ProcessClearRequest();
+            queued_sema.wait(std::chrono::duration_cast<std::chrono::microseconds>(period).count());
+            continue;
+        }
+        Callback(std::min(queued_frames, MaxCallbackFrames));
+    }
+}
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright 2022 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+#include <chrono>
+
+#include <audio_core/common/common.h>
+#include <audio_core/common/common_types.h>
+#include <audio_core/common/polyfill_thread.h>
+#include <audio_core/common/reader_writer_queue.h>
+#include <audio_core/sink/sink_stream.h>
+
+namespace AudioCore::Sink {
+
+/**
+ * Sink stream without a real device, consumed by a thread emulating one instead.
+ *
+ * The thread calls Callback for TargetSampleCount frames on a virtual clock running at a multiple
+ * of real time, or with a speed of 0, for whole queued buffers as soon as they're queued.
+ * Input streams are always clocked, as there's nothing queued to wait for.
+ *
+ * Derived destructors must call Stop, as the thread calls back into the derived stream.
+ */
+class VirtualSinkStream : public SinkStream {
+public:
+    /// Time between clocked callbacks at real time
+    static constexpr std::chrono::nanoseconds CallbackPeriod{
+        std::chrono::nanoseconds{std::chrono::seconds{1}} * TargetSampleCount / TargetSampleRate};
+    /// Most frames passed to one Callback
+    static constexpr u64 MaxCallbackFrames{TargetSampleCount * 8};
+
+    /**
+     * Create a new virtual sink stream.
+     *
+     * @param system_ - Core system.
+     * @param type_   - Type of this stream.
+     * @param speed_  - Clock speed as a multiple of real time, 0 to consume buffers as they are
+     *                  queued.
+     */
+    VirtualSinkStream(Core::System& system_, StreamType type_, u32 speed_);
+
+    /**
+     * Start the sink stream.
+     *
+     * @param resume - Set to true if this is resuming the stream a previously-active stream.
+     *                 Default false.
+     */
+    void Start(bool resume = false) override;
+
+    /**
+     * Stop the sink stream, waiting for the device thread to exit.
+     */
+    void Stop() override;
+
+protected:
+    /**
+     * Consume or record frames, called from the device thread.
+     *
+     * @param num_frames - Number of frames to consume or record.
+     */
+    virtual void Callback(u64 num_frames) = 0;
+
+    /**
+     * Wake the device thread to consume the new buffer, if it isn't clocked.
+     */
+    void OnBufferQueued() override;
+
+    /**
+     * Check if the device thread consumes buffers as they're queued, rather than on a clock.
+     *
+     * @return True if unclocked.
+     */
+    bool IsUnclocked() const {
+        return speed == 0;
+    }
+
+private:
+    /**
+     * Emulated device, calls Callback on the virtual clock or whenever buffers are queued.
+     *
+     * @param stop_token - Token signalled when the stream stops.
+     */
+    void DeviceThreadFunc(std::stop_token stop_token);
+
+    /// Clock speed as a multiple of real time, 0 if unclocked
+    u32 speed;
+    /// Signalled when a buffer is queued to an unclocked stream, or the stream is stopping
+    Common::spsc_sema::LightweightSemaphore queued_sema;
+    /// Emulated device calling Callback
+    std::jthread device_thread;
+};
+
+} // namespace AudioCore::Sink
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Runs random reserves, commits, peeks and pops through a MirroredRingBuffer, both with mirrored
+// memory and forced onto the fallback which copies at the wrap, and checks every span read holds
+// the slots written, in order and contiguously, however often the ring wraps. The fallback is
+// then run with the writer and reader on separate threads, as the sink streams use it.
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <audio_core/common/common_types.h>
+#include <audio_core/common/mirrored_ring_buffer.h>
+
+namespace {
+
+constexpr std::size_t MinCapacity{1024};
+constexpr u32 StepCount{200000};
+constexpr u32 ThreadedSlotCount{2000000};
+
+class Random {
+public:
+    u32 Next(u32 bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<u32>((state >> 33) % bound);
+    }
+
+private:
+    u64 state{0x5EED};
+};
+
+bool RunSteps(bool mirrored) {
+    const auto mode{mirrored ? "mirrored" : "fallback"};
+    Common::MirroredRingBuffer<s16> ring{MinCapacity, mirrored};
+    if (ring.IsMirrored() != mirrored) {
+        std::printf("%s: ring memory is %s\n", mode, ring.IsMirrored() ? "mirrored" : "not");
+        return false;
+    }
+
+    const auto capacity{static_cast<u32>(ring.Capacity())};
+    std::deque<s16> expected;
+    Random random{};
+    s16 next_value{0};
+    u64 slots_written{0};
+
+    for (u32 step = 0; step < StepCount; step++) {
+        // Sizes up to the whole ring, so spans often run past its end.
+        const auto count{random.Next(capacity + 1)};
+        bool matches{true};
+
+        switch (random.Next(4)) {
+        case 0: {
+            const auto span{ring.ReserveWrite(count)};
+            matches = span.size() == std::min<std::size_t>(count, capacity - expected.size());
+            const auto written{random.Next(static_cast<u32>(span.size()) + 1)};
+            for (u32 i = 0; i < written; i++) {
+                span[i] = next_value;
+                expected.push_back(next_value++);
+            }
+            ring.CommitWrite(written);
+            slots_written += written;
+        } break;
+        case 1: {
+            std::vector<s16> values(count);
+            for (auto& value : values) {
+                value = next_value++;
+            }
+            const auto pushed{ring.Push(values)};
+            matches = pushed == std::min<std::size_t>(count, capacity - expected.size());
+            expected.insert(expected.end(), values.begin(), values.begin() + pushed);
+            next_value = static_cast<s16>(next_value - (count - pushed));
+            slots_written += pushed;
+        } break;
+        case 2: {
+            const auto span{ring.PeekRead(count)};
+            matches = span.size() == std::min<std::size_t>(count, expected.size()) &&
+                      std::equal(span.begin(), span.end(), expected.begin());
+            const auto read{random.Next(static_cast<u32>(span.size()) + 1)};
+            ring.CommitRead(read);
+            expected.erase(expected.begin(), expected.begin() + read);
+        } break;
+        default: {
+            const auto popped{ring.Pop(count)};
+            matches = popped.size() == std::min<std::size_t>(count, expected.size()) &&
+                      std::equal(popped.begin(), popped.end(), expected.begin());
+            expected.erase(expected.begin(), expected.begin() + popped.size());
+        } break;
+        }
+
+        if (!matches || ring.Size() != expected.size()) {
+            std::printf("%s step %u: ring differs\n", mode, step);
+            return false;
+        }
+    }
+
+    std::printf("%s: %u steps matched, wrapping %llu times\n", mode, StepCount,
+                static_cast<unsigned long long>(slots_written / capacity));
+    return true;
+}
+
+/// The fallback's copies at the wrap must stay clear of the slots the other thread is using
+bool RunThreaded() {
+    Common::MirroredRingBuffer<s16> ring{MinCapacity, false};
+    bool matches{true};
+
+    std::jthread writer([&ring] {
+        Random random{};
+        u32 next_value{0};
+        while (next_value < ThreadedSlotCount) {
+            const auto span{ring.ReserveWrite(random.Next(300) + 1)};
+            const auto count{std::min<u32>(static_cast<u32>(span.size()),
+                                           ThreadedSlotCount - next_value)};
+            for (u32 i = 0; i < count; i++) {
+                span[i] = static_cast<s16>(next_value++);
+            }
+            ring.CommitWrite(count);
+        }
+    });
+
+    Random random{};
+    u32 next_value{0};
+    while (next_value < ThreadedSlotCount) {
+        const auto span{ring.PeekRead(random.Next(300) + 1)};
+        for (const auto value : span) {
+            matches = matches && value == static_cast<s16>(next_value++);
+        }
+        ring.CommitRead(span.size());
+    }
+    writer.join();
+
+    if (!matches) {
+        std::printf("threaded: slots read out of order\n");
+        return false;
+    }
+    std::printf("threaded: %u slots read in order through the fallback\n", ThreadedSlotCount);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    if (!RunSteps(true) || !RunSteps(false) || !RunThreaded()) {
+        return 1;
+    }
+    return 0;
+}
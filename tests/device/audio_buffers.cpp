@@ -0,0 +1,379 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Runs random sequences of every AudioBuffers operation against the previous mutex-guarded ring,
+// and checks both return the same buffers, tags and counts after every step. Tags are drawn from
+// a small range so duplicates are common, which exercises the tag index's counting and its
+// backward-shift removal.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include <audio_core/device/audio_buffers.h>
+#include <audio_core/device/device_session.h>
+#include <audio_core/sink/sink_details.h>
+#include <core/core.h>
+
+namespace {
+
+using namespace AudioCore;
+
+constexpr size_t BufferCount{32};
+constexpr u32 StepCount{200000};
+/// Tags are drawn from 0 up to this, so the same tag is often in the ring more than once
+constexpr u64 TagRange{48};
+
+/**
+ * The ring AudioBuffers replaced, kept as it was apart from two fixes. Flushing appended buffers
+ * moves the registered index along with them, so it stays at the start of the registered section,
+ * and stops once max_buffers are flushed rather than flushing one appended buffer too many.
+ */
+template <size_t N>
+class ReferenceAudioBuffers {
+public:
+    explicit ReferenceAudioBuffers(size_t limit) : append_limit{static_cast<u32>(limit)} {}
+
+    void AppendBuffer(const AudioBuffer& buffer) {
+        std::scoped_lock l{lock};
+        buffers[appended_index] = buffer;
+        appended_count++;
+        appended_index = (appended_index + 1) % append_limit;
+    }
+
+    void RegisterBuffers(std::vector<AudioBuffer>& out_buffers) {
+        std::scoped_lock l{lock};
+        const s32 to_register{std::min(std::min(appended_count, BufferAppendLimit),
+                                       BufferAppendLimit - registered_count)};
+
+        for (s32 i = 0; i < to_register; i++) {
+            s32 index{appended_index - appended_count};
+            if (index < 0) {
+                index += N;
+            }
+
+            out_buffers.push_back(buffers[index]);
+            registered_count++;
+            registered_index = (registered_index + 1) % append_limit;
+
+            appended_count--;
+            if (appended_count == 0) {
+                break;
+            }
+        }
+    }
+
+    void ReleaseBuffer(s32 index, s64 timestamp) {
+        std::scoped_lock l{lock};
+        buffers[index].played_timestamp = timestamp;
+
+        registered_count--;
+        released_count++;
+        released_index = (released_index + 1) % append_limit;
+    }
+
+    bool ReleaseBuffers(const Core::Timing::CoreTiming& core_timing, DeviceSession& session,
+                        bool force) {
+        std::scoped_lock l{lock};
+        bool buffer_released{false};
+        while (registered_count > 0) {
+            auto index{registered_index - registered_count};
+            if (index < 0) {
+                index += N;
+            }
+
+            if (!force && !session.IsBufferConsumed(buffers[index])) {
+                break;
+            }
+
+            session.ReleaseBuffer(buffers[index]);
+            ReleaseBuffer(index, core_timing.GetGlobalTimeNs().count());
+            buffer_released = true;
+        }
+
+        return buffer_released || registered_count == 0;
+    }
+
+    u32 GetReleasedBuffers(std::span<u64> tags) {
+        std::scoped_lock l{lock};
+        u32 released{0};
+
+        while (released_count > 0) {
+            auto index{released_index - released_count};
+            if (index < 0) {
+                index += N;
+            }
+
+            auto& buffer{buffers[index]};
+            released_count--;
+
+            auto tag{buffer.tag};
+            buffer.played_timestamp = 0;
+            buffer.samples = 0;
+            buffer.tag = 0;
+            buffer.size = 0;
+
+            if (tag == 0) {
+                break;
+            }
+
+            if (released < tags.size()) {
+                tags[released] = tag;
+            }
+
+            released++;
+
+            if (released >= tags.size()) {
+                break;
+            }
+        }
+
+        return released;
+    }
+
+    u32 GetRegisteredAppendedBuffers(std::vector<AudioBuffer>& buffers_flushed, u32 max_buffers) {
+        std::scoped_lock l{lock};
+        if (registered_count + appended_count == 0) {
+            return 0;
+        }
+
+        size_t buffers_to_flush{
+            std::min(static_cast<u32>(registered_count + appended_count), max_buffers)};
+        if (buffers_to_flush == 0) {
+            return 0;
+        }
+
+        while (registered_count > 0) {
+            auto index{registered_index - registered_count};
+            if (index < 0) {
+                index += N;
+            }
+
+            buffers_flushed.push_back(buffers[index]);
+
+            registered_count--;
+            released_count++;
+            released_index = (released_index + 1) % append_limit;
+
+            if (buffers_flushed.size() >= buffers_to_flush) {
+                break;
+            }
+        }
+
+        while (appended_count > 0 && buffers_flushed.size() < buffers_to_flush) {
+            auto index{appended_index - appended_count};
+            if (index < 0) {
+                index += N;
+            }
+
+            buffers_flushed.push_back(buffers[index]);
+
+            appended_count--;
+            released_count++;
+            released_index = (released_index + 1) % append_limit;
+            registered_index = (registered_index + 1) % append_limit;
+        }
+
+        return static_cast<u32>(buffers_flushed.size());
+    }
+
+    bool ContainsBuffer(const u64 tag) const {
+        std::scoped_lock l{lock};
+        const auto registered_buffers{appended_count + registered_count + released_count};
+
+        if (registered_buffers == 0) {
+            return false;
+        }
+
+        auto index{released_index - released_count};
+        if (index < 0) {
+            index += append_limit;
+        }
+
+        for (s32 i = 0; i < registered_buffers; i++) {
+            if (buffers[index].tag == tag) {
+                return true;
+            }
+            index = (index + 1) % append_limit;
+        }
+
+        return false;
+    }
+
+    u32 GetAppendedRegisteredCount() const {
+        std::scoped_lock l{lock};
+        return appended_count + registered_count;
+    }
+
+    u32 GetTotalBufferCount() const {
+        std::scoped_lock l{lock};
+        return static_cast<u32>(appended_count + registered_count + released_count);
+    }
+
+    bool FlushBuffers(u32& buffers_released) {
+        std::scoped_lock l{lock};
+        std::vector<AudioBuffer> buffers_flushed{};
+
+        buffers_released = GetRegisteredAppendedBuffers(buffers_flushed, append_limit);
+
+        if (registered_count > 0) {
+            return false;
+        }
+
+        if (static_cast<u32>(released_count + appended_count) > append_limit) {
+            return false;
+        }
+
+        return true;
+    }
+
+    u64 GetNextTimestamp() const {
+        std::scoped_lock l{lock};
+        auto index{appended_index - 1};
+        if (index < 0) {
+            index += append_limit;
+        }
+        return buffers[index].end_timestamp;
+    }
+
+private:
+    mutable std::recursive_mutex lock{};
+    std::array<AudioBuffer, N> buffers{};
+    s32 released_index{};
+    s32 released_count{};
+    s32 registered_index{};
+    s32 registered_count{};
+    s32 appended_index{};
+    s32 appended_count{};
+    u32 append_limit{};
+};
+
+class Random {
+public:
+    u32 Next(u32 bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<u32>((state >> 33) % bound);
+    }
+
+private:
+    u64 state{0x5EED};
+};
+
+bool SameTags(const std::vector<AudioBuffer>& expected, const std::vector<AudioBuffer>& actual) {
+    return std::equal(expected.begin(), expected.end(), actual.begin(), actual.end(),
+                      [](const AudioBuffer& lhs, const AudioBuffer& rhs) {
+                          return lhs.tag == rhs.tag && lhs.end_timestamp == rhs.end_timestamp;
+                      });
+}
+
+bool Run(Core::System& system) {
+    // Never initialized, so a buffer counts as consumed once its end timestamp is 0.
+    DeviceSession session{system};
+    const auto& core_timing{system.CoreTiming()};
+
+    ReferenceAudioBuffers<BufferCount> expected{BufferCount};
+    AudioBuffers<BufferCount> actual{BufferCount};
+    Random random{};
+    u64 next_timestamp{0};
+
+    for (u32 step = 0; step < StepCount; step++) {
+        const auto operation{random.Next(7)};
+        bool matches{true};
+
+        switch (operation) {
+        case 0:
+        case 1: {
+            if (expected.GetTotalBufferCount() == BufferCount) {
+                break;
+            }
+            matches = expected.GetNextTimestamp() == actual.GetNextTimestamp();
+            // A tag of 0 stops GetReleasedBuffers early, so keep those rare.
+            const u64 tag{random.Next(16) == 0 ? 0 : random.Next(TagRange) + 1};
+            const AudioBuffer buffer{
+                .start_timestamp = next_timestamp,
+                .end_timestamp = random.Next(3) == 0 ? 1 : u64{0},
+                .played_timestamp = 0,
+                .samples = 0,
+                .tag = tag,
+                .size = ++next_timestamp,
+            };
+            expected.AppendBuffer(buffer);
+            actual.AppendBuffer(buffer);
+            if (random.Next(2) == 0) {
+                break;
+            }
+            [[fallthrough]];
+        }
+        case 2: {
+            std::vector<AudioBuffer> expected_registered;
+            std::vector<AudioBuffer> actual_registered;
+            expected.RegisterBuffers(expected_registered);
+            actual.RegisterBuffers(actual_registered);
+            matches = matches && SameTags(expected_registered, actual_registered);
+        } break;
+        case 3: {
+            const bool force{random.Next(4) == 0};
+            matches = expected.ReleaseBuffers(core_timing, session, force) ==
+                      actual.ReleaseBuffers(core_timing, session, force);
+        } break;
+        case 4: {
+            const auto max_tags{random.Next(BufferCount) + 1};
+            std::vector<u64> expected_tags(max_tags);
+            std::vector<u64> actual_tags(max_tags);
+            const auto expected_released{expected.GetReleasedBuffers(expected_tags)};
+            matches = expected_released == actual.GetReleasedBuffers(actual_tags) &&
+                      std::equal(expected_tags.begin(),
+                                 expected_tags.begin() + std::min(expected_released, max_tags),
+                                 actual_tags.begin());
+        } break;
+        case 5: {
+            if (random.Next(2) == 0) {
+                u32 expected_flushed{};
+                u32 actual_flushed{};
+                matches = expected.FlushBuffers(expected_flushed) ==
+                              actual.FlushBuffers(actual_flushed) &&
+                          expected_flushed == actual_flushed;
+            } else {
+                const auto max_buffers{random.Next(BufferCount) + 1};
+                std::vector<AudioBuffer> expected_flushed;
+                std::vector<AudioBuffer> actual_flushed;
+                matches = expected.GetRegisteredAppendedBuffers(expected_flushed, max_buffers) ==
+                              actual.GetRegisteredAppendedBuffers(actual_flushed, max_buffers) &&
+                          SameTags(expected_flushed, actual_flushed);
+            }
+        } break;
+        default:
+            break;
+        }
+
+        for (u64 tag = 0; tag <= TagRange + 1; tag++) {
+            matches = matches && expected.ContainsBuffer(tag) == actual.ContainsBuffer(tag);
+        }
+        matches = matches &&
+                  expected.GetAppendedRegisteredCount() == actual.GetAppendedRegisteredCount() &&
+                  expected.GetTotalBufferCount() == actual.GetTotalBufferCount();
+
+        if (!matches) {
+            std::printf("step %u: operation %u differs\n", step, operation);
+            return false;
+        }
+    }
+
+    std::printf("%u random operations matched\n", StepCount);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Sink::AudioSink = "null";
+    Core::System system{};
+
+    if (!Run(system)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Proxies the host normally implements, linked into every test.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include <audio_core/common/log.h>
+#include <core/core_timing.h>
+
+#include "host_stubs.h"
+
+namespace AudioCore::Tests {
+namespace {
+std::atomic<bool> logs_quiet{};
+} // namespace
+
+void SetLogsQuiet(const bool quiet) {
+    logs_quiet = quiet;
+}
+} // namespace AudioCore::Tests
+
+namespace AudioCore::Log {
+void Debug(const std::string& message) {}
+void Info(const std::string& message) {}
+void Warn(const std::string& message) {
+    if (!Tests::logs_quiet) {
+        std::fprintf(stderr, "%s\n", message.c_str());
+    }
+}
+void Error(const std::string& message) {
+    if (!Tests::logs_quiet) {
+        std::fprintf(stderr, "%s\n", message.c_str());
+    }
+}
+} // namespace AudioCore::Log
+
+namespace Core::Timing {
+std::chrono::nanoseconds GetClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch());
+}
+
+u64 GetClockTicks() {
+    return static_cast<u64>(GetClockNs().count());
+}
+} // namespace Core::Timing
@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+#pragma once
+
+namespace AudioCore::Tests {
+/**
+ * Drop warnings and errors rather than printing them, for tests which cause them on purpose.
+ *
+ * @param quiet - True to drop them, false to print them.
+ */
+void SetLogsQuiet(bool quiet);
+} // namespace AudioCore::Tests
@@ -0,0 +1,376 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Plays the same wavebuffers through a data source command and through an
+// AdvanceVoicePositionCommand, and checks both leave the voice in the same state every frame.
+// Covers each sample format, SRC quality and decode flag, with looping, stream ended and starved
+// wavebuffers. Also checks a filtered voice which is only advanced for a while restarts its
+// biquad from silence rather than the history it stopped with.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/command_buffer.h>
+#include <audio_core/renderer/command/command_processing_time_estimator.h>
+#include <audio_core/renderer/command/data_source/adpcm.h>
+#include <audio_core/renderer/command/data_source/advance_voice_position.h>
+#include <audio_core/renderer/command/data_source/pcm_float.h>
+#include <audio_core/renderer/command/data_source/pcm_int16.h>
+#include <audio_core/renderer/command/effect/biquad_filter.h>
+#include <audio_core/renderer/memory/memory_pool_info.h>
+#include <audio_core/renderer/voice/voice_info.h>
+#include <audio_core/renderer/voice/voice_state.h>
+#include <core/memory.h>
+
+#include "../host_stubs.h"
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 FrameCount{200};
+constexpr s8 ChannelCount{2};
+constexpr s8 ChannelIndex{1};
+/// Samples in each wavebuffer, chosen so buffers end part way through frames and ADPCM frames
+constexpr std::array<u32, MaxWaveBuffers> WaveBufferSamples{1000, 97, 2411, 530};
+
+/// Host copies of the game memory the wavebuffers point at
+struct WaveData {
+    WaveData() {
+        u32 seed{12345};
+        const auto next = [&seed]() {
+            seed = seed * 1103515245 + 12345;
+            return static_cast<u8>(seed >> 16);
+        };
+
+        for (u32 i = 0; i < MaxWaveBuffers; i++) {
+            const auto samples{WaveBufferSamples[i]};
+            pcm_int16[i].resize(samples * ChannelCount);
+            for (auto& sample : pcm_int16[i]) {
+                sample = static_cast<s16>((next() << 8) | next());
+            }
+            pcm_float[i].resize(samples * ChannelCount);
+            for (auto& sample : pcm_float[i]) {
+                sample = static_cast<f32>(next()) / 128.0f - 1.0f;
+            }
+            // 8 byte frames of a header then 14 nibbles. Decoding reads whole blocks which can
+            // run past the end of the data, so pad the buffer.
+            adpcm_sizes[i] = (samples + 13) / 14 * 8;
+            adpcm[i].resize(adpcm_sizes[i] + samples * 2);
+            for (u32 byte = 0; byte < adpcm[i].size(); byte++) {
+                adpcm[i][byte] = byte % 8 == 0 ? static_cast<u8>(((next() % 8) << 4) | next() % 12)
+                                               : next();
+            }
+            contexts[i] = {static_cast<u16>(adpcm[i][0]), 0, 0};
+        }
+    }
+
+    std::array<std::vector<s16>, MaxWaveBuffers> pcm_int16{};
+    std::array<std::vector<f32>, MaxWaveBuffers> pcm_float{};
+    std::array<std::vector<u8>, MaxWaveBuffers> adpcm{};
+    std::array<u64, MaxWaveBuffers> adpcm_sizes{};
+    std::array<VoiceState::AdpcmContext, MaxWaveBuffers> contexts{};
+    std::array<s16, 16> coefficients{
+        0, 0, 2048, 0, 4096, -2048, 3000, -1000, 1024, 1024, 3500, -1700, 500, 0, -1000, 0,
+    };
+};
+
+/// Wavebuffers of the given format, the third one looping twice over part of itself
+std::array<WaveBufferVersion2, MaxWaveBuffers> MakeWaveBuffers(const WaveData& data,
+                                                              SampleFormat format) {
+    std::array<WaveBufferVersion2, MaxWaveBuffers> wave_buffers{};
+    for (u32 i = 0; i < MaxWaveBuffers; i++) {
+        auto& wave_buffer{wave_buffers[i]};
+        const auto samples{WaveBufferSamples[i]};
+        switch (format) {
+        case SampleFormat::PcmInt16:
+            wave_buffer.buffer = reinterpret_cast<CpuAddr>(data.pcm_int16[i].data());
+            wave_buffer.buffer_size = data.pcm_int16[i].size() * sizeof(s16);
+            break;
+        case SampleFormat::PcmFloat:
+            wave_buffer.buffer = reinterpret_cast<CpuAddr>(data.pcm_float[i].data());
+            wave_buffer.buffer_size = data.pcm_float[i].size() * sizeof(f32);
+            break;
+        default:
+            wave_buffer.buffer = reinterpret_cast<CpuAddr>(data.adpcm[i].data());
+            wave_buffer.buffer_size = data.adpcm_sizes[i];
+            wave_buffer.context = reinterpret_cast<CpuAddr>(&data.contexts[i]);
+            wave_buffer.context_size = sizeof(VoiceState::AdpcmContext);
+            break;
+        }
+        wave_buffer.start_offset = i == 1 ? 5 : 0;
+        wave_buffer.end_offset = samples;
+        wave_buffer.loop = i == 2;
+        wave_buffer.loop_start_offset = 300;
+        wave_buffer.loop_end_offset = 1800;
+        wave_buffer.loop_count = 2;
+        wave_buffer.stream_ended = i == 3;
+    }
+    return wave_buffers;
+}
+
+struct Voice {
+    SampleFormat format;
+    SrcQuality src_quality;
+    u16 flags;
+    u32 sample_rate;
+    f32 pitch;
+};
+
+/// Process one frame of the voice, fully decoding it or only advancing it
+void RenderFrame(const ADSP::CommandListProcessor& processor, const WaveData& data,
+                 const Voice& voice, VoiceState& state, bool advance_only) {
+    const auto wave_buffers{MakeWaveBuffers(data, voice.format)};
+    const auto state_address{reinterpret_cast<CpuAddr>(&state)};
+    const auto channel_index{voice.format == SampleFormat::Adpcm ? s8{0} : ChannelIndex};
+    const auto channel_count{voice.format == SampleFormat::Adpcm ? s8{1} : ChannelCount};
+
+    if (advance_only) {
+        AdvanceVoicePositionCommand command{};
+        command.sample_format = voice.format;
+        command.src_quality = voice.src_quality;
+        command.flags = voice.flags;
+        command.sample_rate = voice.sample_rate;
+        command.pitch = voice.pitch;
+        command.channel_index = channel_index;
+        command.channel_count = channel_count;
+        command.wave_buffer_version1 = false;
+        command.wave_buffers = wave_buffers;
+        command.voice_state = state_address;
+        command.previous_sample_count = 0;
+        command.data_address = reinterpret_cast<CpuAddr>(data.coefficients.data());
+        command.data_size = sizeof(data.coefficients);
+        command.Process(processor);
+        return;
+    }
+
+    const auto setup = [&](auto& command) {
+        command.src_quality = voice.src_quality;
+        command.output_index = 0;
+        command.flags = voice.flags;
+        command.sample_rate = voice.sample_rate;
+        command.pitch = voice.pitch;
+        command.channel_index = channel_index;
+        command.channel_count = channel_count;
+        command.wave_buffers = wave_buffers;
+        command.voice_state = state_address;
+    };
+
+    switch (voice.format) {
+    case SampleFormat::PcmInt16: {
+        PcmInt16DataSourceVersion2Command command{};
+        setup(command);
+        command.Process(processor);
+    } break;
+    case SampleFormat::PcmFloat: {
+        PcmFloatDataSourceVersion2Command command{};
+        setup(command);
+        command.Process(processor);
+    } break;
+    default: {
+        AdpcmDataSourceVersion2Command command{};
+        setup(command);
+        command.data_address = reinterpret_cast<CpuAddr>(data.coefficients.data());
+        command.data_size = sizeof(data.coefficients);
+        command.Process(processor);
+    } break;
+    }
+}
+
+/// Compare the voice state fields which carry over between frames, printing the first mismatch
+bool StatesMatch(const VoiceState& decoded, const VoiceState& advanced) {
+    const auto check = [](const char* field, auto lhs, auto rhs) {
+        if (lhs != rhs) {
+            std::printf("%s differs, %lld decoded, %lld advanced\n", field,
+                        static_cast<long long>(lhs), static_cast<long long>(rhs));
+            return false;
+        }
+        return true;
+    };
+
+    if (!check("played_sample_count", decoded.played_sample_count,
+               advanced.played_sample_count) ||
+        !check("offset", decoded.offset, advanced.offset) ||
+        !check("wave_buffer_index", decoded.wave_buffer_index, advanced.wave_buffer_index) ||
+        !check("wave_buffers_consumed", decoded.wave_buffers_consumed,
+               advanced.wave_buffers_consumed) ||
+        !check("loop_count", decoded.loop_count, advanced.loop_count) ||
+        !check("fraction", decoded.fraction.to_raw(), advanced.fraction.to_raw()) ||
+        !check("adpcm_context.header", decoded.adpcm_context.header,
+               advanced.adpcm_context.header) ||
+        !check("adpcm_context.yn0", decoded.adpcm_context.yn0, advanced.adpcm_context.yn0) ||
+        !check("adpcm_context.yn1", decoded.adpcm_context.yn1, advanced.adpcm_context.yn1)) {
+        return false;
+    }
+    for (u32 i = 0; i < MaxWaveBuffers; i++) {
+        if (!check("wave_buffer_valid", decoded.wave_buffer_valid[i],
+                   advanced.wave_buffer_valid[i])) {
+            return false;
+        }
+    }
+    for (u32 i = 0; i < decoded.sample_history.size(); i++) {
+        if (!check("sample_history", decoded.sample_history[i], advanced.sample_history[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompareVoice(ADSP::CommandListProcessor& processor, const WaveData& data,
+                  const Voice& voice) {
+    VoiceState decoded{};
+    VoiceState advanced{};
+    u64 samples_played{0};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        // The game appends a new wavebuffer in each consumed slot, except now and then so the
+        // voice starves.
+        if (frame % 16 != 15) {
+            for (u32 i = 0; i < MaxWaveBuffers; i++) {
+                if (!decoded.wave_buffer_valid[i]) {
+                    decoded.wave_buffer_valid[i] = true;
+                    advanced.wave_buffer_valid[i] = true;
+                }
+            }
+        }
+
+        RenderFrame(processor, data, voice, decoded, false);
+        RenderFrame(processor, data, voice, advanced, true);
+        samples_played += decoded.played_sample_count;
+
+        if (!StatesMatch(decoded, advanced)) {
+            std::printf("format %u quality %u flags %u rate %u pitch %.2f: frame %u\n",
+                        static_cast<u32>(voice.format), static_cast<u32>(voice.src_quality),
+                        voice.flags, voice.sample_rate, voice.pitch, frame);
+            return false;
+        }
+    }
+
+    if (samples_played == 0) {
+        std::printf("format %u never played\n", static_cast<u32>(voice.format));
+        return false;
+    }
+    return true;
+}
+
+/// Play a voice through an enabled biquad, only advancing it for a stretch as the CommandGenerator
+/// does while it's inaudible. The first filtered frame afterwards must match a freshly started
+/// filter, as the skipped samples never reached the old history.
+bool CheckBiquadRestart(ADSP::CommandListProcessor& processor, const WaveData& data) {
+    constexpr u32 InaudibleStart{10};
+    constexpr u32 InaudibleEnd{20};
+    const Voice voice{SampleFormat::PcmInt16, SrcQuality::Medium, 0, TargetSampleRate, 1.0f};
+
+    VoiceInfo voice_info{};
+    voice_info.biquads[0] = {true, {1500, 3000, 1500}, {-20000, 8000}};
+    VoiceState state{};
+
+    // The DSP sees host memory as is.
+    MemoryPoolInfo memory_pool{};
+    memory_pool.SetCpuAddress(reinterpret_cast<CpuAddr>(&state), sizeof(state));
+    memory_pool.SetDspAddress(reinterpret_cast<CpuAddr>(&state));
+    CommandProcessingTimeEstimatorVersion5 estimator{SampleCount, 1};
+    std::vector<u8> command_list(sizeof(BiquadFilterCommand) * 2);
+
+    for (u32 frame = 0; frame <= InaudibleEnd; frame++) {
+        for (u32 i = 0; i < MaxWaveBuffers; i++) {
+            state.wave_buffer_valid[i] = true;
+        }
+
+        const bool audible{frame < InaudibleStart || frame >= InaudibleEnd};
+        RenderFrame(processor, data, voice, state, !audible);
+        if (!audible) {
+            voice_info.biquad_stale[0] = true;
+            continue;
+        }
+
+        const std::vector<s32> unfiltered(processor.mix_buffers.begin(),
+                                          processor.mix_buffers.end());
+
+        CommandBuffer command_buffer{
+            .command_list{command_list},
+            .sample_count{SampleCount},
+            .sample_rate{TargetSampleRate},
+            .memory_pool{&memory_pool},
+            .time_estimator{&estimator},
+        };
+        command_buffer.GenerateBiquadFilterCommand(0, voice_info, state, 0, 0, 0, false);
+        reinterpret_cast<BiquadFilterCommand*>(command_list.data())->Process(processor);
+        voice_info.biquad_stale[0] = false;
+        voice_info.biquad_initialized[0] = true;
+
+        if (frame == InaudibleEnd) {
+            std::vector<s32> expected(SampleCount);
+            VoiceState::BiquadFilterState fresh_state{};
+            const std::array<VoiceState::BiquadFilterState*, 1> states{&fresh_state};
+            ApplyBiquadFilterCascade(expected, unfiltered, std::span(voice_info.biquads).first(1),
+                                     states, SampleCount, false);
+            if (!std::equal(expected.begin(), expected.end(), processor.mix_buffers.begin())) {
+                std::printf("biquad did not restart once the voice was audible again\n");
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    // Starved voices log errors on purpose.
+    Tests::SetLogsQuiet(true);
+
+    const WaveData data{};
+    Core::Memory::Memory memory{};
+    std::vector<s32> mix_buffers(SampleCount);
+
+    ADSP::CommandListProcessor processor{};
+    processor.memory = &memory;
+    processor.sample_count = SampleCount;
+    processor.target_sample_rate = TargetSampleRate;
+    processor.buffer_count = 1;
+    processor.mix_buffers = mix_buffers;
+    processor.silent_mix_buffers.assign(1, false);
+
+    constexpr std::array formats{SampleFormat::PcmInt16, SampleFormat::PcmFloat,
+                                 SampleFormat::Adpcm};
+    constexpr std::array qualities{SrcQuality::Medium, SrcQuality::High, SrcQuality::Low};
+    constexpr std::array<std::pair<u32, f32>, 4> rates{{
+        {48000, 1.0f},
+        {32000, 1.3f},
+        {44100, 0.7f},
+        {22050, 2.5f},
+    }};
+
+    u32 voices{0};
+    for (const auto format : formats) {
+        for (const auto quality : qualities) {
+            for (u16 flags = 0; flags < 4; flags++) {
+                for (const auto& [sample_rate, pitch] : rates) {
+                    // Skipping pitch and SRC is only used for voices already at the output rate.
+                    if ((flags & 2) != 0 && (sample_rate != TargetSampleRate || pitch != 1.0f)) {
+                        continue;
+                    }
+                    const Voice voice{format, quality, flags, sample_rate, pitch};
+                    if (!CompareVoice(processor, data, voice)) {
+                        return 1;
+                    }
+                    voices++;
+                }
+            }
+        }
+    }
+
+    if (!CheckBiquadRestart(processor, data)) {
+        return 1;
+    }
+
+    std::printf("%u voices advanced identically over %u frames\n", voices, FrameCount);
+    return 0;
+}
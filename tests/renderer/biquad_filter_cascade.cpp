@@ -0,0 +1,276 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Checks a cascade of biquads filtered in a single pass over the samples matches the previous
+// path, a separate BiquadFilterCommand per biquad with each one filtering the last one's output.
+// Int mode must match exactly, as must the MultiTapBiquadFilterCommand's float mode. Also checks
+// a MultiChannelBiquadFilterCommand matches a BiquadFilterCommand per channel in both modes, for
+// the channel layouts the command generator accepts, and that it falls back to per-channel
+// commands when a channel's output is a later channel's input.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <vector>
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/effect/biquad_filter.h>
+#include <audio_core/renderer/command/effect/multi_channel_biquad_filter.h>
+#include <audio_core/renderer/command/effect/multi_tap_biquad_filter.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 BufferCount{MaxChannels * 2};
+constexpr u32 FrameCount{50};
+
+/// A lowpass followed by a highpass, both stable, in Q14
+constexpr std::array<VoiceInfo::BiquadFilterParameter, MaxBiquadFilters> Biquads{{
+    {true, {1500, 3000, 1500}, {-20000, 8000}},
+    {true, {12000, -24000, 12000}, {-18000, 6500}},
+}};
+
+struct Renderer {
+    Renderer() {
+        processor.sample_count = SampleCount;
+        processor.buffer_count = BufferCount;
+        processor.mix_buffers = mix_buffers;
+        processor.silent_mix_buffers.assign(BufferCount, false);
+    }
+
+    ADSP::CommandListProcessor processor{};
+    std::vector<s32> mix_buffers = std::vector<s32>(BufferCount * SampleCount);
+    std::array<VoiceState::BiquadFilterState, MaxBiquadFilters> states{};
+    std::array<VoiceState::BiquadFilterState, MaxChannels> channel_states{};
+};
+
+/// Fill mix buffer 0 with the input for the given frame, loud enough to exercise saturation
+void WriteInput(Renderer& renderer, u32 frame) {
+    auto samples{renderer.processor.mix_buffers.subspan(0, SampleCount)};
+    for (u32 i = 0; i < SampleCount; i++) {
+        const auto t{frame * SampleCount + i};
+        samples[i] = static_cast<s32>((t * 7919) % 60000) - 30000;
+    }
+}
+
+/// The previous path, one BiquadFilterCommand per biquad, buffer 0 through to buffer 1
+void RenderSerial(Renderer& renderer, u32 frame, bool use_float_processing) {
+    WriteInput(renderer, frame);
+    for (u32 tap = 0; tap < MaxBiquadFilters; tap++) {
+        BiquadFilterCommand command{};
+        command.input = tap == 0 ? 0 : 1;
+        command.output = 1;
+        command.biquad = Biquads[tap];
+        command.state = reinterpret_cast<CpuAddr>(&renderer.states[tap]);
+        command.needs_init = frame == 0;
+        command.use_float_processing = use_float_processing;
+        command.Process(renderer.processor);
+    }
+}
+
+/// Both biquads cascaded in a single pass, buffer 0 to buffer 1
+void RenderCascade(Renderer& renderer, u32 frame, bool use_float_processing) {
+    WriteInput(renderer, frame);
+    if (use_float_processing) {
+        MultiTapBiquadFilterCommand command{};
+        command.input = 0;
+        command.output = 1;
+        command.biquads = Biquads;
+        for (u32 tap = 0; tap < MaxBiquadFilters; tap++) {
+            command.states[tap] = reinterpret_cast<CpuAddr>(&renderer.states[tap]);
+            command.needs_init[tap] = frame == 0;
+        }
+        command.filter_tap_count = MaxBiquadFilters;
+        command.Process(renderer.processor);
+        return;
+    }
+
+    std::array<VoiceState::BiquadFilterState*, MaxBiquadFilters> states{};
+    for (u32 tap = 0; tap < MaxBiquadFilters; tap++) {
+        if (frame == 0) {
+            renderer.states[tap] = {};
+        }
+        states[tap] = &renderer.states[tap];
+    }
+    ApplyBiquadFilterCascade(renderer.processor.mix_buffers.subspan(SampleCount, SampleCount),
+                             renderer.processor.mix_buffers.subspan(0, SampleCount), Biquads,
+                             states, SampleCount, false);
+}
+
+bool StatesMatch(const Renderer& lhs, const Renderer& rhs) {
+    for (u32 tap = 0; tap < MaxBiquadFilters; tap++) {
+        const auto& l{lhs.states[tap]};
+        const auto& r{rhs.states[tap]};
+        if (l.s0 != r.s0 || l.s1 != r.s1 || l.s2 != r.s2 || l.s3 != r.s3) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Compare(bool use_float_processing) {
+    const auto mode{use_float_processing ? "float" : "int"};
+    Renderer serial{};
+    Renderer cascade{};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        RenderSerial(serial, frame, use_float_processing);
+        RenderCascade(cascade, frame, use_float_processing);
+
+        const auto serial_output{serial.processor.mix_buffers.subspan(SampleCount, SampleCount)};
+        const auto cascade_output{
+            cascade.processor.mix_buffers.subspan(SampleCount, SampleCount)};
+        const auto mismatch{std::mismatch(serial_output.begin(), serial_output.end(),
+                                          cascade_output.begin())};
+        if (mismatch.first != serial_output.end()) {
+            std::printf("%s frame %u: sample %lld differs, %d serial, %d cascaded\n", mode, frame,
+                        static_cast<long long>(mismatch.first - serial_output.begin()),
+                        *mismatch.first, *mismatch.second);
+            return false;
+        }
+        if (!StatesMatch(serial, cascade)) {
+            std::printf("%s frame %u: biquad states differ\n", mode, frame);
+            return false;
+        }
+    }
+
+    std::printf("%s: %u frames identical\n", mode, FrameCount);
+    return true;
+}
+
+/// Biquad filter effect parameters with the given buffers, using the first biquad
+BiquadFilterInfo::ParameterVersion1 GetEffectParameters(const std::vector<s8>& inputs,
+                                                        const std::vector<s8>& outputs) {
+    BiquadFilterInfo::ParameterVersion1 parameter{};
+    std::copy(inputs.begin(), inputs.end(), parameter.inputs.begin());
+    std::copy(outputs.begin(), outputs.end(), parameter.outputs.begin());
+    parameter.b = Biquads[0].b;
+    parameter.a = Biquads[0].a;
+    parameter.channel_count = static_cast<s8>(inputs.size());
+    return parameter;
+}
+
+/// Fill every mix buffer with a different loud input for the given frame
+void WriteChannelInputs(Renderer& renderer, u32 frame) {
+    for (u32 buffer = 0; buffer < BufferCount; buffer++) {
+        auto samples{renderer.processor.mix_buffers.subspan(buffer * SampleCount, SampleCount)};
+        for (u32 i = 0; i < SampleCount; i++) {
+            const auto t{frame * SampleCount + i};
+            samples[i] = static_cast<s32>((t * 7919 + buffer * 104729) % 60000) - 30000;
+        }
+    }
+}
+
+/// The per-channel path, one BiquadFilterCommand per channel in channel order
+void RenderPerChannel(Renderer& renderer, const BiquadFilterInfo::ParameterVersion1& parameter,
+                      u32 frame, bool use_float_processing) {
+    WriteChannelInputs(renderer, frame);
+    for (s8 channel = 0; channel < parameter.channel_count; channel++) {
+        BiquadFilterCommand command{};
+        command.input = parameter.inputs[channel];
+        command.output = parameter.outputs[channel];
+        command.biquad = {true, parameter.b, parameter.a};
+        command.state = reinterpret_cast<CpuAddr>(&renderer.channel_states[channel]);
+        command.needs_init = frame == 0;
+        command.use_float_processing = use_float_processing;
+        command.Process(renderer.processor);
+    }
+}
+
+/// Every channel in a single MultiChannelBiquadFilterCommand
+void RenderMultiChannel(Renderer& renderer, const BiquadFilterInfo::ParameterVersion1& parameter,
+                        u32 frame, bool use_float_processing) {
+    WriteChannelInputs(renderer, frame);
+    MultiChannelBiquadFilterCommand command{};
+    for (s8 channel = 0; channel < parameter.channel_count; channel++) {
+        command.inputs[channel] = parameter.inputs[channel];
+        command.outputs[channel] = parameter.outputs[channel];
+        command.states[channel] = reinterpret_cast<CpuAddr>(&renderer.channel_states[channel]);
+    }
+    command.b = parameter.b;
+    command.a = parameter.a;
+    command.channel_count = static_cast<u8>(parameter.channel_count);
+    command.needs_init = frame == 0;
+    command.use_float_processing = use_float_processing;
+    command.Process(renderer.processor);
+}
+
+/**
+ * Render the given layout both ways and report if every buffer and state matched.
+ *
+ * @param parameter            - Effect parameters giving the channel layout.
+ * @param use_float_processing - If true, use float processing rather than int.
+ * @return The first frame they differ at, or FrameCount if they always matched.
+ */
+u32 RenderLayout(const BiquadFilterInfo::ParameterVersion1& parameter,
+                 bool use_float_processing) {
+    Renderer per_channel{};
+    Renderer multi_channel{};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        RenderPerChannel(per_channel, parameter, frame, use_float_processing);
+        RenderMultiChannel(multi_channel, parameter, frame, use_float_processing);
+
+        const auto states_match{std::equal(
+            per_channel.channel_states.begin(), per_channel.channel_states.end(),
+            multi_channel.channel_states.begin(), [](const auto& l, const auto& r) {
+                return l.s0 == r.s0 && l.s1 == r.s1 && l.s2 == r.s2 && l.s3 == r.s3;
+            })};
+        if (per_channel.mix_buffers != multi_channel.mix_buffers || !states_match) {
+            return frame;
+        }
+    }
+    return FrameCount;
+}
+
+bool CompareMultiChannel(bool use_float_processing) {
+    const auto mode{use_float_processing ? "float" : "int"};
+    const std::array layouts{
+        GetEffectParameters({0, 1, 2, 3, 4, 5}, {6, 7, 8, 9, 10, 11}),
+        GetEffectParameters({0, 1, 2, 3, 4, 5}, {0, 1, 2, 3, 4, 5}),
+        GetEffectParameters({4, 0, 9}, {1, 11, 3}),
+        GetEffectParameters({2, 3}, {5, 2}),
+    };
+
+    for (const auto& parameter : layouts) {
+        const auto channel_count{static_cast<u32>(parameter.channel_count)};
+        if (!CanFilterBiquadChannelsTogether(parameter)) {
+            std::printf("%s: %u channels rejected for a multi-channel command\n", mode,
+                        channel_count);
+            return false;
+        }
+        const auto frame{RenderLayout(parameter, use_float_processing)};
+        if (frame != FrameCount) {
+            std::printf("%s: %u channels differ at frame %u\n", mode, channel_count, frame);
+            return false;
+        }
+    }
+
+    // Channel 0 writes the buffer channel 1 reads, so the per-channel commands filter it twice.
+    const auto aliased{GetEffectParameters({0, 1}, {1, 2})};
+    if (CanFilterBiquadChannelsTogether(aliased)) {
+        std::printf("%s: aliased channels accepted for a multi-channel command\n", mode);
+        return false;
+    }
+    if (RenderLayout(aliased, use_float_processing) == FrameCount) {
+        std::printf("%s: aliased channels matched, the layout doesn't test the fallback\n", mode);
+        return false;
+    }
+
+    std::printf("%s: %zu multi-channel layouts identical, aliased layout falls back\n", mode,
+                layouts.size());
+    return true;
+}
+
+} // namespace
+
+int main() {
+    if (!Compare(false) || !Compare(true) || !CompareMultiChannel(false) ||
+        !CompareMultiChannel(true)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Runs the same voices through command generation twice, once applying their AudioRenderer state
+// updates immediately as a serial system does, and once deferring them as a pipelined system does,
+// generating each frame while a thread renders the previous one. Wavebuffers are queued, flushed,
+// started, paused, stopped and voices reset at random, and the AudioRenderer states must be the
+// same in both every time a list is about to be rendered.
+
+#include <array>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <audio_core/renderer/voice/voice_channel_resource.h>
+#include <audio_core/renderer/voice/voice_context.h>
+#include <audio_core/renderer/voice/voice_info.h>
+#include <audio_core/renderer/voice/voice_state.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 FrameCount{2000};
+/// Voices in use, each taking a state per channel
+constexpr u32 VoiceCount{8};
+/// Voice slots and states, as many as the system has
+constexpr u32 StateCount{VoiceCount * 2};
+
+class Random {
+public:
+    u32 Next(u32 bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<u32>((state >> 33) % bound);
+    }
+
+private:
+    u64 state{0x5EED};
+};
+
+/// A voice context and the workbuffers it uses
+struct Voices {
+    explicit Voices(bool defer) {
+        for (u32 i = 0; i < StateCount; i++) {
+            channel_resources.emplace_back(i);
+        }
+        for (u32 i = 0; i < VoiceCount; i++) {
+            auto& voice{infos[i]};
+            voice.in_use = true;
+            voice.is_new = true;
+            voice.channel_count = static_cast<s8>(1 + i % 2);
+            voice.channel_resource_ids[0] = i * 2;
+            voice.channel_resource_ids[1] = i * 2 + 1;
+            voice.current_play_state = VoiceInfo::ServerPlayState::Started;
+        }
+        context.Initialize(sorted_infos, infos, channel_resources, cpu_states, dsp_states,
+                           StateCount);
+        context.SetDeferDspSharedUpdates(defer);
+    }
+
+    void Generate() {
+        for (u32 i = 0; i < VoiceCount; i++) {
+            infos[i].UpdateForCommandGeneration(context);
+        }
+    }
+
+    std::array<VoiceInfo, StateCount> infos{};
+    std::array<VoiceInfo*, StateCount> sorted_infos{};
+    std::vector<VoiceChannelResource> channel_resources{};
+    std::array<VoiceState, StateCount> cpu_states{};
+    std::array<VoiceState, StateCount> dsp_states{};
+    VoiceContext context{};
+};
+
+/// Make the same random changes a game might to the voices of both systems
+void ChangeVoices(Random& random, Voices& serial, Voices& pipelined) {
+    for (u32 i = 0; i < VoiceCount; i++) {
+        const auto action{random.Next(8)};
+        const auto wave_index{random.Next(MaxWaveBuffers)};
+        for (auto* voices : {&serial, &pipelined}) {
+            auto& voice{voices->infos[i]};
+            switch (action) {
+            case 0:
+            case 1:
+                voice.wavebuffers[wave_index].sent_to_DSP = false;
+                break;
+            case 2:
+                voice.wave_buffer_index = static_cast<u16>(wave_index);
+                voice.flush_buffer_count = static_cast<u8>(1 + wave_index % 2);
+                break;
+            case 3:
+                voice.last_play_state = voice.current_play_state;
+                voice.current_play_state = VoiceInfo::ServerPlayState::Started;
+                break;
+            case 4:
+                voice.last_play_state = voice.current_play_state;
+                voice.current_play_state = VoiceInfo::ServerPlayState::Paused;
+                break;
+            case 5:
+                voice.last_play_state = voice.current_play_state;
+                voice.current_play_state = VoiceInfo::ServerPlayState::RequestStop;
+                break;
+            case 6:
+                voice.is_new = true;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Play a frame of each state's current wavebuffer, as the AudioRenderer would.
+ *
+ * @param states - States to play.
+ * @return Number of wavebuffers finished.
+ */
+u32 Render(std::array<VoiceState, StateCount>& states) {
+    u32 finished{0};
+    for (auto& state : states) {
+        if (!state.wave_buffer_valid[state.wave_buffer_index]) {
+            continue;
+        }
+        state.offset += SampleCount;
+        state.played_sample_count += SampleCount;
+        state.sample_history[state.offset / SampleCount % state.sample_history.size()] =
+            static_cast<s16>(state.offset);
+        state.adpcm_context.yn0 = static_cast<s16>(state.played_sample_count);
+
+        if (state.offset >= SampleCount * (2 + state.wave_buffers_consumed % 3)) {
+            state.offset = 0;
+            state.wave_buffer_valid[state.wave_buffer_index] = false;
+            state.wave_buffer_index = (state.wave_buffer_index + 1) % MaxWaveBuffers;
+            state.wave_buffers_consumed++;
+            finished++;
+        }
+    }
+    return finished;
+}
+
+bool StatesMatch(const VoiceState& a, const VoiceState& b) {
+    return a.played_sample_count == b.played_sample_count && a.offset == b.offset &&
+           a.wave_buffer_index == b.wave_buffer_index &&
+           a.wave_buffer_valid == b.wave_buffer_valid &&
+           a.wave_buffers_consumed == b.wave_buffers_consumed &&
+           a.sample_history == b.sample_history && a.fraction == b.fraction &&
+           a.adpcm_context.yn0 == b.adpcm_context.yn0;
+}
+
+} // namespace
+
+int main() {
+    Voices serial{false};
+    Voices pipelined{true};
+    Random random{};
+    u32 wave_buffers_finished{0};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        // The serial system renders the previous list, then generates this one.
+        if (frame != 0) {
+            wave_buffers_finished += Render(serial.dsp_states);
+        }
+        ChangeVoices(random, serial, pipelined);
+        serial.Generate();
+        serial.context.UpdateStateByDspShared();
+
+        // The pipelined system generates this list while the previous one renders, then applies
+        // the updates it held back.
+        {
+            std::jthread renderer;
+            if (frame != 0) {
+                renderer = std::jthread([&pipelined] { Render(pipelined.dsp_states); });
+            }
+            pipelined.Generate();
+        }
+        pipelined.context.ApplyDeferredDspSharedUpdates();
+        pipelined.context.UpdateStateByDspShared();
+
+        for (u32 i = 0; i < StateCount; i++) {
+            if (!StatesMatch(serial.dsp_states[i], pipelined.dsp_states[i]) ||
+                !StatesMatch(pipelined.cpu_states[i], pipelined.dsp_states[i])) {
+                std::printf("frame %u: state %u differs\n", frame, i);
+                return 1;
+            }
+        }
+    }
+
+    std::printf("%u frames matched, %u wavebuffers played\n", FrameCount, wave_buffers_finished);
+    return 0;
+}
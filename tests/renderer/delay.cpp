@@ -0,0 +1,296 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Checks DelayCommand matches the previous delay, a std::vector per delay line with
+// Common::FixedPoint maths per sample, exactly for 1, 2, 4 and 6 channels. Each layout runs with
+// the lines in the game's workbuffer and in host memory, and through a parameter update and a
+// reinitialization with a different delay.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/effect/delay.h>
+#include <audio_core/common/alignment.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 BufferCount{MaxChannels * 2};
+constexpr u32 FrameCount{120};
+/// Frame the gains are changed at
+constexpr u32 UpdateFrame{40};
+/// Frame the effect is reinitialized with a different delay at
+constexpr u32 ReinitializeFrame{80};
+
+/// The previous delay, kept as it was
+struct ReferenceDelay {
+    struct DelayLine {
+        Common::FixedPoint<50, 14> Read() const {
+            return buffer[buffer_pos];
+        }
+
+        void Write(const Common::FixedPoint<50, 14> value) {
+            buffer[buffer_pos] = value;
+            buffer_pos = static_cast<u32>((buffer_pos + 1) % buffer.size());
+        }
+
+        std::vector<Common::FixedPoint<50, 14>> buffer{};
+        u32 buffer_pos{};
+    };
+
+    void SetParameter(const DelayInfo::ParameterVersion1& params) {
+        auto channel_spread{params.channel_spread};
+        feedback_gain = params.feedback_gain * 0.97998046875f;
+        delay_feedback_gain = feedback_gain * (1.0f - channel_spread);
+        if (params.channel_count == 4 || params.channel_count == 6) {
+            channel_spread >>= 1;
+        }
+        delay_feedback_cross_gain = channel_spread * feedback_gain;
+        lowpass_feedback_gain = params.lowpass_amount * 0.949951171875f;
+        lowpass_gain = 1.0f - lowpass_feedback_gain;
+    }
+
+    void Initialize(const DelayInfo::ParameterVersion1& params) {
+        lowpass_z = {};
+        for (u32 channel = 0; channel < params.channel_count; channel++) {
+            Common::FixedPoint<32, 32> sample_count_max{0.064f};
+            sample_count_max *= params.sample_rate.to_int_floor() * params.delay_time_max;
+
+            Common::FixedPoint<18, 14> delay_time{params.delay_time};
+            delay_time *= params.sample_rate / 1000;
+            Common::FixedPoint<32, 32> sample_count{delay_time};
+
+            if (sample_count > sample_count_max) {
+                sample_count = sample_count_max;
+            }
+
+            delay_lines[channel].buffer.assign(sample_count.to_int_floor(), 0);
+            if (delay_lines[channel].buffer.size() == 0) {
+                delay_lines[channel].buffer.push_back(0);
+            }
+            delay_lines[channel].buffer_pos = 0;
+        }
+        SetParameter(params);
+    }
+
+    template <size_t NumChannels>
+    void Apply(const DelayInfo::ParameterVersion1& params,
+               std::span<const std::span<const s32>> inputs, std::span<const std::span<s32>> outputs,
+               const u32 sample_count) {
+        for (u32 sample_index = 0; sample_index < sample_count; sample_index++) {
+            std::array<Common::FixedPoint<50, 14>, NumChannels> input_samples{};
+            for (u32 channel = 0; channel < NumChannels; channel++) {
+                input_samples[channel] = inputs[channel][sample_index] * 64;
+            }
+
+            std::array<Common::FixedPoint<50, 14>, NumChannels> delay_samples{};
+            for (u32 channel = 0; channel < NumChannels; channel++) {
+                delay_samples[channel] = delay_lines[channel].Read();
+            }
+
+            const auto g{delay_feedback_gain};
+            const auto x{delay_feedback_cross_gain};
+            const Common::FixedPoint<18, 14> z{0.0f};
+            std::array<std::array<Common::FixedPoint<18, 14>, NumChannels>, NumChannels> matrix{};
+            // clang-format off
+            if constexpr (NumChannels == 1) {
+                matrix = {{
+                    {feedback_gain},
+                }};
+            } else if constexpr (NumChannels == 2) {
+                matrix = {{
+                    {g, x},
+                    {x, g},
+                }};
+            } else if constexpr (NumChannels == 4) {
+                matrix = {{
+                    {g, x, x, z},
+                    {x, g, z, x},
+                    {x, z, g, x},
+                    {z, x, x, g},
+                }};
+            } else if constexpr (NumChannels == 6) {
+                matrix = {{
+                    {g, z, x, z, x, z},
+                    {z, g, x, z, z, x},
+                    {x, x, g, z, z, z},
+                    {z, z, z, params.feedback_gain, z, z},
+                    {x, z, z, z, g, x},
+                    {z, x, z, z, x, g},
+                }};
+            }
+            // clang-format on
+
+            std::array<Common::FixedPoint<50, 14>, NumChannels> gained_samples{};
+            for (u32 channel = 0; channel < NumChannels; channel++) {
+                Common::FixedPoint<50, 14> delay{};
+                for (u32 j = 0; j < NumChannels; j++) {
+                    delay += delay_samples[j] * matrix[j][channel];
+                }
+                gained_samples[channel] = input_samples[channel] * params.in_gain + delay;
+            }
+
+            for (u32 channel = 0; channel < NumChannels; channel++) {
+                lowpass_z[channel] = gained_samples[channel] * lowpass_gain +
+                                     lowpass_z[channel] * lowpass_feedback_gain;
+                delay_lines[channel].Write(lowpass_z[channel]);
+            }
+
+            for (u32 channel = 0; channel < NumChannels; channel++) {
+                outputs[channel][sample_index] = (input_samples[channel] * params.dry_gain +
+                                                  delay_samples[channel] * params.wet_gain)
+                                                     .to_int_floor() /
+                                                 64;
+            }
+        }
+    }
+
+    std::array<DelayLine, MaxChannels> delay_lines{};
+    Common::FixedPoint<18, 14> feedback_gain{};
+    Common::FixedPoint<18, 14> delay_feedback_gain{};
+    Common::FixedPoint<18, 14> delay_feedback_cross_gain{};
+    Common::FixedPoint<18, 14> lowpass_gain{};
+    Common::FixedPoint<18, 14> lowpass_feedback_gain{};
+    std::array<Common::FixedPoint<50, 14>, MaxChannels> lowpass_z{};
+};
+
+struct Renderer {
+    Renderer() {
+        processor.sample_count = SampleCount;
+        processor.buffer_count = BufferCount;
+        processor.mix_buffers = mix_buffers;
+        processor.silent_mix_buffers.assign(BufferCount, false);
+    }
+
+    ADSP::CommandListProcessor processor{};
+    std::vector<s32> mix_buffers = std::vector<s32>(BufferCount * SampleCount);
+};
+
+DelayInfo::ParameterVersion1 GetParameters(u16 channel_count, u32 frame) {
+    DelayInfo::ParameterVersion1 params{};
+    params.channel_count_max = channel_count;
+    params.channel_count = channel_count;
+    params.delay_time_max = 50;
+    params.delay_time = frame < ReinitializeFrame ? 21 : 37;
+    params.sample_rate = 48000.0f;
+    params.in_gain = frame < UpdateFrame ? 0.9f : 0.6f;
+    params.feedback_gain = frame < UpdateFrame ? 0.7f : 0.85f;
+    params.wet_gain = 0.7f;
+    params.dry_gain = frame < UpdateFrame ? 0.8f : 0.5f;
+    params.channel_spread = frame < UpdateFrame ? 0.3f : 0.6f;
+    params.lowpass_amount = 0.4f;
+    if (frame == 0 || frame == ReinitializeFrame) {
+        params.state = DelayInfo::ParameterState::Initialized;
+    } else if (frame == UpdateFrame) {
+        params.state = DelayInfo::ParameterState::Updating;
+    } else {
+        params.state = DelayInfo::ParameterState::Updated;
+    }
+    return params;
+}
+
+/// Fill each input buffer with a loud signal, different per channel and silent for a while so the
+/// delay's tail plays out on its own
+void WriteInput(Renderer& renderer, u32 channel_count, u32 frame) {
+    for (u32 channel = 0; channel < channel_count; channel++) {
+        auto samples{renderer.processor.mix_buffers.subspan(channel * SampleCount, SampleCount)};
+        for (u32 i = 0; i < SampleCount; i++) {
+            const auto t{frame * SampleCount + i};
+            samples[i] = frame % 30 < 20
+                             ? static_cast<s32>((t * 7919 + channel * 104729) % 120000) - 60000
+                             : 0;
+        }
+    }
+}
+
+template <size_t NumChannels>
+bool Compare(bool host_memory) {
+    const auto memory{host_memory ? "host memory" : "workbuffer"};
+    Renderer renderer{};
+    Renderer reference_renderer{};
+    ReferenceDelay reference{};
+    const auto state{std::make_unique<DelayInfo::State>()};
+
+    const auto required_size{DelayInfo::GetRequiredWorkbufferSize(
+        GetParameters(NumChannels, 0), 0)};
+    std::vector<u8> workbuffer(required_size + 0x40);
+    std::vector<u8> host_buffer(required_size + 0x40);
+    const auto workbuffer_address{
+        Common::AlignUp(reinterpret_cast<CpuAddr>(workbuffer.data()), 0x40)};
+    const auto host_buffer_address{
+        Common::AlignUp(reinterpret_cast<CpuAddr>(host_buffer.data()), 0x40)};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        const auto params{GetParameters(NumChannels, frame)};
+        WriteInput(renderer, NumChannels, frame);
+        WriteInput(reference_renderer, NumChannels, frame);
+
+        DelayCommand command{};
+        for (s16 channel = 0; channel < static_cast<s16>(NumChannels); channel++) {
+            command.inputs[channel] = channel;
+            command.outputs[channel] = static_cast<s16>(MaxChannels + channel);
+        }
+        command.parameter = params;
+        command.state = reinterpret_cast<CpuAddr>(state.get());
+        // A workbuffer too small for the lines is passed alongside the host memory.
+        command.workbuffer = workbuffer_address;
+        command.workbuffer_size = host_memory ? required_size / 4 : required_size;
+        command.host_buffer = host_memory ? host_buffer_address : 0;
+        command.host_buffer_size = host_memory ? required_size : 0;
+        command.effect_enabled = true;
+        command.Process(renderer.processor);
+
+        std::array<std::span<const s32>, MaxChannels> inputs{};
+        std::array<std::span<s32>, MaxChannels> outputs{};
+        for (u32 channel = 0; channel < NumChannels; channel++) {
+            inputs[channel] =
+                reference_renderer.processor.mix_buffers.subspan(channel * SampleCount, SampleCount);
+            outputs[channel] = reference_renderer.processor.mix_buffers.subspan(
+                (MaxChannels + channel) * SampleCount, SampleCount);
+        }
+        if (params.state == DelayInfo::ParameterState::Initialized) {
+            reference.Initialize(params);
+        } else if (params.state == DelayInfo::ParameterState::Updating) {
+            reference.SetParameter(params);
+        }
+        reference.Apply<NumChannels>(params, inputs, outputs, SampleCount);
+
+        for (u32 channel = 0; channel < NumChannels; channel++) {
+            const auto output{renderer.processor.mix_buffers.subspan(
+                (MaxChannels + channel) * SampleCount, SampleCount)};
+            const auto mismatch{
+                std::mismatch(output.begin(), output.end(), outputs[channel].begin())};
+            if (mismatch.first != output.end()) {
+                std::printf("%zu channels, %s, frame %u: channel %u sample %lld differs, %d new, "
+                            "%d previous\n",
+                            NumChannels, memory, frame, channel,
+                            static_cast<long long>(mismatch.first - output.begin()),
+                            *mismatch.first, *mismatch.second);
+                return false;
+            }
+        }
+    }
+
+    std::printf("%zu channels, %s: %u frames identical\n", NumChannels, memory, FrameCount);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    for (const bool host_memory : {false, true}) {
+        if (!Compare<1>(host_memory) || !Compare<2>(host_memory) || !Compare<4>(host_memory) ||
+            !Compare<6>(host_memory)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Renders the same command lists with mix buffer silence tracking on and off, and checks the
+// output is identical sample for sample. Frames alternate between audible bursts and long
+// stretches of silence, so the silent short-circuits of every command, including the effect
+// tails, are exercised and left again.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include <audio_core/renderer/adsp/command_list_processor.h>
+#include <audio_core/renderer/command/effect/delay.h>
+#include <audio_core/renderer/command/effect/reverb.h>
+#include <audio_core/renderer/command/mix/clear_mix.h>
+#include <audio_core/renderer/command/mix/depop_for_mix_buffers.h>
+#include <audio_core/renderer/command/mix/mix.h>
+#include <audio_core/renderer/command/mix/volume.h>
+#include <audio_core/renderer/command/resample/downmix_6ch_to_2ch.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 BufferCount{24};
+constexpr u32 FrameCount{1200};
+constexpr u64 DelayWorkbufferSize{0x10000};
+
+/// A renderer's processor with the buffers and effect states its commands work on
+struct Renderer {
+    explicit Renderer(bool silence_tracking) {
+        processor.silence_tracking = silence_tracking;
+        processor.sample_count = SampleCount;
+        processor.buffer_count = BufferCount;
+        processor.mix_buffers = mix_buffers;
+        processor.silent_mix_buffers.assign(BufferCount, false);
+    }
+
+    ADSP::CommandListProcessor processor{};
+    std::vector<s32> mix_buffers = std::vector<s32>(BufferCount * SampleCount);
+    std::array<s32, BufferCount> depop_buffer{};
+    std::unique_ptr<DelayInfo::State> delay_state{std::make_unique<DelayInfo::State>()};
+    std::vector<u8> delay_workbuffer = std::vector<u8>(DelayWorkbufferSize);
+    std::unique_ptr<ReverbInfo::State> reverb_state{std::make_unique<ReverbInfo::State>()};
+    u32 delay_tail_skips{};
+    u32 reverb_tail_skips{};
+};
+
+/// Is the given frame part of an audible burst, rather than the silence between them?
+bool IsFrameAudible(u32 frame) {
+    return frame % 400 < 20;
+}
+
+/// Stand in for a voice's data source, writing into a mix buffer and scanning it for silence
+void WriteVoice(Renderer& renderer, s16 buffer, u32 frame) {
+    auto samples{renderer.processor.mix_buffers.subspan(buffer * SampleCount, SampleCount)};
+    for (u32 i = 0; i < SampleCount; i++) {
+        const auto t{frame * SampleCount + i};
+        samples[i] = IsFrameAudible(frame) ? static_cast<s32>((t * 7919 + buffer * 104729) % 6000)
+                                           : 0;
+    }
+    renderer.processor.UpdateMixBufferSilence(buffer);
+}
+
+void RenderFrame(Renderer& renderer, u32 frame) {
+    const auto& processor{renderer.processor};
+    const bool initialize{frame == 0};
+
+    ClearMixBufferCommand clear{};
+    clear.Process(processor);
+
+    WriteVoice(renderer, 0, frame);
+    WriteVoice(renderer, 1, frame);
+
+    // A voice stopping at the end of each burst leaves a depop sample behind.
+    if (frame % 400 == 20) {
+        renderer.depop_buffer[0] = 3000;
+        renderer.depop_buffer[1] = -2000;
+    }
+    DepopForMixBuffersCommand depop{};
+    depop.input = 0;
+    depop.count = 2;
+    depop.decay = 0.9f;
+    depop.depop_buffer = reinterpret_cast<CpuAddr>(renderer.depop_buffer.data());
+    depop.Process(processor);
+
+    const auto mix_into = [&](s16 input, s16 output, f32 volume, u8 precision) {
+        MixCommand mix{};
+        mix.precision = precision;
+        mix.input_index = input;
+        mix.output_index = output;
+        mix.volume = volume;
+        mix.Process(processor);
+    };
+    mix_into(0, 2, 0.7f, 15);
+    mix_into(1, 3, 0.7f, 23);
+    mix_into(8, 3, 0.5f, 15);
+
+    const auto apply_volume = [&](s16 input, s16 output, f32 volume) {
+        VolumeCommand volume_command{};
+        volume_command.precision = 15;
+        volume_command.input_index = input;
+        volume_command.output_index = output;
+        volume_command.volume = volume;
+        volume_command.Process(processor);
+    };
+    apply_volume(2, 4, 0.5f);
+    apply_volume(3, 5, 1.0f);
+    apply_volume(9, 10, 0.25f);
+
+    DelayCommand delay{};
+    delay.inputs = {4, 5, 0, 0, 0, 0};
+    delay.outputs = {4, 5, 0, 0, 0, 0};
+    delay.parameter.channel_count_max = 2;
+    delay.parameter.channel_count = 2;
+    delay.parameter.delay_time_max = 1;
+    delay.parameter.delay_time = 20;
+    delay.parameter.sample_rate = 48000.0f;
+    delay.parameter.in_gain = 1.0f;
+    delay.parameter.feedback_gain = 0.5f;
+    delay.parameter.wet_gain = 0.5f;
+    delay.parameter.dry_gain = 1.0f;
+    delay.parameter.channel_spread = 0.25f;
+    delay.parameter.lowpass_amount = 0.3f;
+    delay.parameter.state = initialize ? DelayInfo::ParameterState::Initialized
+                                       : DelayInfo::ParameterState::Updated;
+    delay.state = reinterpret_cast<CpuAddr>(renderer.delay_state.get());
+    delay.workbuffer = reinterpret_cast<CpuAddr>(renderer.delay_workbuffer.data());
+    delay.workbuffer_size = DelayWorkbufferSize;
+    delay.effect_enabled = true;
+    renderer.delay_tail_skips += renderer.delay_state->tail_silent ? 1 : 0;
+    delay.Process(processor);
+
+    ReverbCommand reverb{};
+    reverb.inputs = {4, 5, 0, 0, 0, 0};
+    reverb.outputs = {6, 7, 0, 0, 0, 0};
+    reverb.parameter.channel_count_max = 2;
+    reverb.parameter.channel_count = 2;
+    reverb.parameter.sample_rate = 48 << 14;
+    reverb.parameter.early_mode = 0;
+    reverb.parameter.early_gain = 1 << 13;
+    reverb.parameter.pre_delay = 10 << 14;
+    reverb.parameter.late_mode = 0;
+    reverb.parameter.late_gain = 1 << 13;
+    reverb.parameter.decay_time = 1 << 10;
+    reverb.parameter.high_freq_decay_ratio = 1 << 13;
+    reverb.parameter.colouration = 1 << 13;
+    reverb.parameter.base_gain = 1 << 13;
+    reverb.parameter.wet_gain = 1 << 13;
+    reverb.parameter.dry_gain = 1 << 13;
+    reverb.parameter.state = initialize ? ReverbInfo::ParameterState::Initialized
+                                        : ReverbInfo::ParameterState::Updated;
+    reverb.state = reinterpret_cast<CpuAddr>(renderer.reverb_state.get());
+    reverb.effect_enabled = true;
+    reverb.long_size_pre_delay_supported = false;
+    renderer.reverb_tail_skips += renderer.reverb_state->tail_silent ? 1 : 0;
+    reverb.Process(processor);
+
+    DownMix6chTo2chCommand downmix{};
+    downmix.inputs = {6, 7, 11, 12, 13, 14};
+    downmix.outputs = {15, 16, 17, 18, 19, 20};
+    downmix.down_mix_coeff = {1.0f, 0.707f, 0.251f, 0.707f};
+    downmix.Process(processor);
+}
+
+/// Check every buffer the processor believes is silent really only holds zeroes
+bool CheckSilenceFlags(const Renderer& renderer, u32 frame) {
+    for (u32 buffer = 0; buffer < BufferCount; buffer++) {
+        if (!renderer.processor.IsMixBufferSilent(static_cast<s32>(buffer))) {
+            continue;
+        }
+        const auto samples{renderer.processor.mix_buffers.subspan(buffer * SampleCount,
+                                                                  SampleCount)};
+        if (!std::all_of(samples.begin(), samples.end(), [](s32 x) { return x == 0; })) {
+            std::printf("frame %u: buffer %u marked silent but holds samples\n", frame, buffer);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Renderer tracked{true};
+    Renderer reference{false};
+
+    for (u32 frame = 0; frame < FrameCount; frame++) {
+        RenderFrame(tracked, frame);
+        RenderFrame(reference, frame);
+
+        if (!CheckSilenceFlags(tracked, frame)) {
+            return 1;
+        }
+
+        const auto mismatch{std::mismatch(tracked.mix_buffers.begin(), tracked.mix_buffers.end(),
+                                          reference.mix_buffers.begin())};
+        if (mismatch.first != tracked.mix_buffers.end()) {
+            const auto index{mismatch.first - tracked.mix_buffers.begin()};
+            std::printf("frame %u: buffer %lld sample %lld differs, %d with tracking, %d without\n",
+                        frame, static_cast<long long>(index / SampleCount),
+                        static_cast<long long>(index % SampleCount), *mismatch.first,
+                        *mismatch.second);
+            return 1;
+        }
+    }
+
+    // Make sure the effect tails actually decayed, so their skipped frames were compared.
+    if (tracked.delay_tail_skips == 0 || tracked.reverb_tail_skips == 0) {
+        std::printf("effect tails never skipped, delay %u reverb %u\n", tracked.delay_tail_skips,
+                    tracked.reverb_tail_skips);
+        return 1;
+    }
+
+    std::printf("%u frames identical, delay skipped %u, reverb skipped %u\n", FrameCount,
+                tracked.delay_tail_skips, tracked.reverb_tail_skips);
+    return 0;
+}
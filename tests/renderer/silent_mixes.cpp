@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Routes an audible voice into a chain of submixes and checks CommandGenerator only treats it as
+// inaudible when nothing mixed into its submix can reach the final mix: the submix or one it mixes
+// into is unused, unconnected, at zero volume or mixes with zero volumes, and none of them has an
+// effect to process. A cycle of submixes must not recurse forever.
+
+#include <array>
+#include <cstdio>
+#include <vector>
+
+#include <audio_core/common/audio_renderer_parameter.h>
+#include <audio_core/renderer/behavior/behavior_info.h>
+#include <audio_core/renderer/command/command_buffer.h>
+#include <audio_core/renderer/command/command_generator.h>
+#include <audio_core/renderer/command/command_list_header.h>
+#include <audio_core/renderer/command/command_processing_time_estimator.h>
+#include <audio_core/renderer/effect/effect_context.h>
+#include <audio_core/renderer/mix/mix_context.h>
+#include <audio_core/renderer/sink/sink_context.h>
+#include <audio_core/renderer/splitter/splitter_context.h>
+#include <audio_core/renderer/voice/voice_channel_resource.h>
+#include <audio_core/renderer/voice/voice_context.h>
+#include <audio_core/renderer/voice/voice_info.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::AudioRenderer;
+
+constexpr u32 SampleCount{240};
+constexpr u32 MixCount{4};
+constexpr u32 EffectCount{1};
+constexpr s16 BufferCount{2};
+
+/// A final mix and three submixes, each connected straight to the final mix at full volume
+struct Mixes {
+    Mixes() {
+        for (u32 i = 0; i < MixCount; i++) {
+            auto& mix{infos.emplace_back(std::span(effect_orders[i]), EffectCount, behavior)};
+            mix.mix_id = static_cast<s32>(i);
+            mix.in_use = true;
+            mix.volume = 1.0f;
+            mix.buffer_count = BufferCount;
+            mix.buffer_offset = static_cast<s16>(i * BufferCount);
+            if (i != FinalMixId) {
+                mix.dst_mix_id = FinalMixId;
+                mix.mix_volumes[0][0] = 1.0f;
+                mix.mix_volumes[1][1] = 1.0f;
+            }
+        }
+        context.Initialize(sorted_infos, infos, MixCount, {}, EffectCount, {}, 0, {}, 0);
+    }
+
+    BehaviorInfo behavior{};
+    std::array<std::array<s32, EffectCount>, MixCount> effect_orders{};
+    std::vector<MixInfo> infos{};
+    std::array<MixInfo*, MixCount> sorted_infos{};
+    MixContext context{};
+};
+
+struct Case {
+    const char* name;
+    void (*setup)(Mixes& mixes);
+    bool audible;
+};
+
+constexpr std::array<Case, 11> Cases{{
+    {"submix to final mix", [](Mixes&) {}, true},
+    {"submix with zero volume", [](Mixes& mixes) { mixes.infos[1].volume = 0.0f; }, false},
+    {"unused submix", [](Mixes& mixes) { mixes.infos[1].in_use = false; }, false},
+    {"unconnected submix",
+     [](Mixes& mixes) { mixes.infos[1].dst_mix_id = UnusedMixId; }, false},
+    {"submix mixing with zero volumes",
+     [](Mixes& mixes) { mixes.infos[1].mix_volumes = {}; }, false},
+    {"submix mixing with one non-zero volume",
+     [](Mixes& mixes) {
+         mixes.infos[1].mix_volumes = {};
+         mixes.infos[1].mix_volumes[1][0] = 0.5f;
+     },
+     true},
+    {"submix into an audible submix", [](Mixes& mixes) { mixes.infos[1].dst_mix_id = 2; },
+     true},
+    {"submix into a silent submix",
+     [](Mixes& mixes) {
+         mixes.infos[1].dst_mix_id = 2;
+         mixes.infos[2].dst_mix_id = 3;
+         mixes.infos[3].volume = 0.0f;
+     },
+     false},
+    {"submix with an effect and zero volume",
+     [](Mixes& mixes) {
+         mixes.infos[1].volume = 0.0f;
+         mixes.infos[1].effect_order_buffer[0] = 0;
+     },
+     true},
+    {"submix into a silent submix with an effect",
+     [](Mixes& mixes) {
+         mixes.infos[1].dst_mix_id = 2;
+         mixes.infos[2].volume = 0.0f;
+         mixes.infos[2].effect_order_buffer[0] = 0;
+     },
+     true},
+    {"cycle of submixes",
+     [](Mixes& mixes) {
+         mixes.infos[1].dst_mix_id = 2;
+         mixes.infos[2].dst_mix_id = 1;
+     },
+     true},
+}};
+
+bool Check(const Case& test) {
+    Mixes mixes{};
+    test.setup(mixes);
+
+    std::array<EffectInfoBase, EffectCount> effect_infos{};
+    std::array<EffectResultState, EffectCount> result_states{};
+    EffectContext effect_context{};
+    effect_context.Initialize(effect_infos, EffectCount, result_states, result_states,
+                              EffectCount);
+
+    std::vector<u8> command_list(0x1000);
+    CommandProcessingTimeEstimatorVersion5 estimator{SampleCount, BufferCount};
+    CommandBuffer command_buffer{
+        .command_list{command_list},
+        .sample_count{SampleCount},
+        .sample_rate{TargetSampleRate},
+        .time_estimator{&estimator},
+    };
+    CommandListHeader command_list_header{};
+    AudioRendererSystemContext render_context{};
+    render_context.behavior = &mixes.behavior;
+    VoiceContext voice_context{};
+    SinkContext sink_context{};
+    SplitterContext splitter_context{};
+    CommandGenerator generator{command_buffer, command_list_header, render_context, voice_context,
+                               mixes.context, effect_context, sink_context, splitter_context,
+                               nullptr};
+
+    VoiceInfo voice_info{};
+    voice_info.mix_id = 1;
+    voice_info.channel_count = 1;
+    voice_info.volume = 1.0f;
+    voice_info.prev_volume = 1.0f;
+    VoiceChannelResource channel_resource{0};
+    channel_resource.mix_volumes[0] = 1.0f;
+    channel_resource.prev_mix_volumes[0] = 1.0f;
+
+    s16 previous_sample_count{};
+    const bool audible{
+        generator.IsVoiceChannelAudible(voice_info, channel_resource, 0, previous_sample_count)};
+    const s16 expected_previous_sample_count{test.audible ? s16{0} : BufferCount};
+    if (audible != test.audible || previous_sample_count != expected_previous_sample_count) {
+        std::printf("%s: voice is %s, %d previous samples reset\n", test.name,
+                    audible ? "audible" : "inaudible", previous_sample_count);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    for (const auto& test : Cases) {
+        if (!Check(test)) {
+            return 1;
+        }
+    }
+    std::printf("%zu routings checked\n", Cases.size());
+    return 0;
+}
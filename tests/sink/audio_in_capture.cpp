@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Records into appended AudioIn buffers through the backend callback, and releases each one
+// straight into the game's buffer. Every buffer must hold its own captured samples with the volume
+// applied and saturated, and a buffer released before it was fully recorded must have the rest of
+// it zeroed rather than left holding whatever the game had there.
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include <audio_core/sink/sink_details.h>
+#include <audio_core/sink/sink_stream.h>
+#include <core/core.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::Sink;
+
+constexpr u32 Channels{2};
+constexpr u64 BufferFrames{240};
+constexpr u32 BufferCount{8};
+constexpr u64 CallbackFrames{90};
+/// Frames recorded into the last buffer before it's released early, odd to hit the scalar tail
+constexpr u64 PartialFrames{101};
+/// The device volume, times the additional 8 applied to recordings
+constexpr f32 DeviceVolume{0.5f};
+constexpr s32 Gain{4};
+/// What the game's buffers hold before they're released into
+constexpr s16 Garbage{0x7777};
+
+/// A stream whose callback is driven by the test, standing in for a backend
+class TestSinkStream final : public SinkStream {
+public:
+    explicit TestSinkStream(Core::System& system_) : SinkStream{system_, StreamType::In} {
+        device_channels = Channels;
+        system_channels = Channels;
+        name = "test";
+    }
+
+    void Start(bool resume = false) override {
+        paused = false;
+    }
+
+    void Stop() override {
+        paused = true;
+    }
+};
+
+/// The microphone's sample at the given position, loud enough for the gain to saturate
+s16 MicSample(u64 index) {
+    return static_cast<s16>(static_cast<s64>(index * 7919 % 24000) - 12000);
+}
+
+s16 Captured(u64 index) {
+    constexpr s32 min{std::numeric_limits<s16>::min()};
+    constexpr s32 max{std::numeric_limits<s16>::max()};
+    return static_cast<s16>(std::clamp(MicSample(index) * Gain, min, max));
+}
+
+/// Record the given number of frames from the microphone, in callback sized chunks
+void Record(TestSinkStream& stream, u64& recorded_frames, u64 num_frames) {
+    std::vector<s16> samples;
+    for (u64 frames = 0; frames < num_frames;) {
+        const auto chunk{std::min(CallbackFrames, num_frames - frames)};
+        samples.resize(chunk * Channels);
+        for (u64 i = 0; i < samples.size(); i++) {
+            samples[i] = MicSample((recorded_frames + frames) * Channels + i);
+        }
+        stream.ProcessAudioIn(samples, chunk);
+        frames += chunk;
+    }
+    recorded_frames += num_frames;
+}
+
+/// Check a released buffer holds the given frames from the microphone, and zeroes after them
+bool CheckReleased(const std::vector<s16>& game_buffer, u64 first_frame, u64 num_frames,
+                   u64 tag) {
+    for (u64 i = 0; i < game_buffer.size(); i++) {
+        const auto expected{i < num_frames * Channels ? Captured(first_frame * Channels + i)
+                                                      : s16{0}};
+        if (game_buffer[i] != expected) {
+            std::printf("buffer %llu: sample %llu is %d, expected %d\n",
+                        static_cast<unsigned long long>(tag), static_cast<unsigned long long>(i),
+                        game_buffer[i], expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Run(Core::System& system) {
+    TestSinkStream stream{system};
+    stream.SetDeviceVolume(DeviceVolume);
+    stream.SetBufferConsumedCallback([] {});
+    stream.Start();
+
+    for (u64 tag = 0; tag < BufferCount; tag++) {
+        SinkBuffer buffer{BufferFrames, 0, tag, false, nullptr};
+        std::vector<s16> no_samples;
+        stream.AppendBuffer(buffer, no_samples);
+    }
+
+    // Fill all but the last buffer, and part of the last.
+    u64 recorded_frames{0};
+    Record(stream, recorded_frames, (BufferCount - 1) * BufferFrames + PartialFrames);
+
+    std::vector<s16> game_buffer(BufferFrames * Channels);
+    for (u64 tag = 0; tag < BufferCount - 1; tag++) {
+        if (!stream.TakeConsumedBuffer(tag)) {
+            std::printf("buffer %llu: not consumed after being recorded\n",
+                        static_cast<unsigned long long>(tag));
+            return false;
+        }
+        std::fill(game_buffer.begin(), game_buffer.end(), Garbage);
+        const auto released{stream.ReleaseBuffer(game_buffer)};
+        if (released != game_buffer.size()) {
+            std::printf("buffer %llu: %llu of %llu samples released\n",
+                        static_cast<unsigned long long>(tag),
+                        static_cast<unsigned long long>(released),
+                        static_cast<unsigned long long>(game_buffer.size()));
+            return false;
+        }
+        if (!CheckReleased(game_buffer, tag * BufferFrames, BufferFrames, tag)) {
+            return false;
+        }
+    }
+
+    // The last buffer is released before it's fully recorded.
+    const u64 last_tag{BufferCount - 1};
+    if (stream.TakeConsumedBuffer(last_tag)) {
+        std::printf("buffer %llu: consumed before being fully recorded\n",
+                    static_cast<unsigned long long>(last_tag));
+        return false;
+    }
+    std::fill(game_buffer.begin(), game_buffer.end(), Garbage);
+    const auto released{stream.ReleaseBuffer(game_buffer)};
+    if (released != PartialFrames * Channels) {
+        std::printf("buffer %llu: %llu samples released, %llu recorded\n",
+                    static_cast<unsigned long long>(last_tag),
+                    static_cast<unsigned long long>(released),
+                    static_cast<unsigned long long>(PartialFrames * Channels));
+        return false;
+    }
+    if (!CheckReleased(game_buffer, last_tag * BufferFrames, PartialFrames, last_tag)) {
+        return false;
+    }
+
+    std::printf("%u buffers released with their captured samples\n", BufferCount);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Sink::AudioSink = "null";
+    Core::System system{};
+
+    if (!Run(system)) {
+        return 1;
+    }
+    return 0;
+}
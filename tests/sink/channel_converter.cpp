@@ -0,0 +1,143 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Checks ChannelConverter against a plain per-frame mix for every pair of mono, stereo and 5.1
+// layouts, including the stereo to 5.1 upmix, both in place and into a separate buffer. Frame
+// counts which aren't a multiple of the vector width exercise the partial last block, and a loud
+// volume exercises saturation.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include <audio_core/common/simd.h>
+#include <audio_core/sink/channel_converter.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::Sink;
+
+using Matrix = std::array<std::array<f32, MaxChannels>, MaxChannels>;
+
+constexpr std::array<u32, 3> Layouts{1, 2, 6};
+constexpr std::array<f32, 3> Volumes{1.0f, 0.5f, 1.7f};
+constexpr std::array<u64, 9> FrameCounts{0, 1, 3, 4, 5, 7, 13, 64, 67};
+/// Written past the end of the output, it must be left alone
+constexpr s16 Guard{0x1234};
+
+static_assert(Common::Simd::VectorWidth == 4, "Frame counts assume 4 frames to a vector");
+
+/// The mixing matrix for a pair of layouts, indexed [dst][src], as documented for ChannelConverter
+Matrix GetMatrix(u32 src_channels, u32 dst_channels) {
+    Matrix matrix{};
+    if (src_channels == 6 && dst_channels == 2) {
+        matrix[0] = {1.0f, 0.0f, 0.707f, 0.251f, 0.707f, 0.0f};
+        matrix[1] = {0.0f, 1.0f, 0.707f, 0.251f, 0.0f, 0.707f};
+    } else if (src_channels == 6 && dst_channels == 1) {
+        matrix[0] = {0.5f, 0.5f, 0.707f, 0.251f, 0.354f, 0.354f};
+    } else if (src_channels == 2 && dst_channels == 6) {
+        matrix[0][0] = 1.0f;
+        matrix[1][1] = 1.0f;
+        matrix[2] = {0.354f, 0.354f};
+        matrix[4][0] = 0.5f;
+        matrix[5][1] = 0.5f;
+    } else if (src_channels == 2 && dst_channels == 1) {
+        matrix[0] = {0.5f, 0.5f};
+    } else if (src_channels == 1 && dst_channels == 2) {
+        matrix[0][0] = 1.0f;
+        matrix[1][0] = 1.0f;
+    } else if (src_channels == 1 && dst_channels == 6) {
+        matrix[2][0] = 1.0f;
+    } else {
+        for (u32 channel = 0; channel < std::min(src_channels, dst_channels); channel++) {
+            matrix[channel][channel] = 1.0f;
+        }
+    }
+    return matrix;
+}
+
+/// Mix one frame at a time, truncating and then saturating each result
+std::vector<s16> ReferenceConvert(const std::vector<s16>& input, u32 src_channels,
+                                  u32 dst_channels, f32 volume, u64 num_frames) {
+    constexpr s32 min{std::numeric_limits<s16>::min()};
+    constexpr s32 max{std::numeric_limits<s16>::max()};
+    const auto matrix{GetMatrix(src_channels, dst_channels)};
+
+    std::vector<s16> output(num_frames * dst_channels);
+    for (u64 frame = 0; frame < num_frames; frame++) {
+        for (u32 dst = 0; dst < dst_channels; dst++) {
+            f32 mixed{0.0f};
+            for (u32 src = 0; src < src_channels; src++) {
+                mixed += static_cast<f32>(input[frame * src_channels + src]) *
+                         (matrix[dst][src] * volume);
+            }
+            output[frame * dst_channels + dst] =
+                static_cast<s16>(std::clamp(static_cast<s32>(mixed), min, max));
+        }
+    }
+    return output;
+}
+
+class Random {
+public:
+    s16 Next() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<s16>(state >> 48);
+    }
+
+private:
+    u64 state{0x5EED};
+};
+
+bool Compare(u32 src_channels, u32 dst_channels, f32 volume, u64 num_frames, Random& random) {
+    std::vector<s16> input(num_frames * src_channels);
+    std::generate(input.begin(), input.end(), [&random] { return random.Next(); });
+    const auto expected{ReferenceConvert(input, src_channels, dst_channels, volume, num_frames)};
+
+    ChannelConverter converter{};
+    converter.Configure(src_channels, dst_channels, volume);
+
+    std::vector<s16> output(expected.size() + 1, Guard);
+    converter.Convert(input, output, num_frames);
+    const bool out_of_place_matches{std::equal(expected.begin(), expected.end(), output.begin())};
+
+    // Passthrough conversions are skipped by the stream, and leave the samples untouched here.
+    std::vector<s16> samples(num_frames * std::max(src_channels, dst_channels) + 1, Guard);
+    std::copy(input.begin(), input.end(), samples.begin());
+    converter.Convert(samples, num_frames);
+    const bool in_place_matches{std::equal(expected.begin(), expected.end(), samples.begin())};
+
+    if (!out_of_place_matches || !in_place_matches || output.back() != Guard ||
+        samples.back() != Guard) {
+        std::printf("%u to %u channels, volume %.1f, %llu frames: %s differs\n", src_channels,
+                    dst_channels, volume, static_cast<unsigned long long>(num_frames),
+                    out_of_place_matches && output.back() == Guard ? "in place" : "out of place");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Random random{};
+    u32 conversions{0};
+    for (const auto src_channels : Layouts) {
+        for (const auto dst_channels : Layouts) {
+            for (const auto volume : Volumes) {
+                for (const auto num_frames : FrameCounts) {
+                    if (!Compare(src_channels, dst_channels, volume, num_frames, random)) {
+                        return 1;
+                    }
+                    conversions++;
+                }
+            }
+        }
+    }
+
+    std::printf("%u conversions matched, in place and out of place\n", conversions);
+    return 0;
+}
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Clears a stream's queue from the game's side while a backend thread calls back, as games do
+// when flushing or stopping. The clear is handed to the callback, so once ClearQueue returns the
+// callback must never read a cleared buffer read in place, and every dropped frame and tag must be
+// accounted for. Input streams are cleared the same way. A backend which stalls for around the
+// ClearQueue timeout has the clear done directly, as it may resume mid-clear.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <audio_core/sink/sink_details.h>
+#include <audio_core/sink/sink_stream.h>
+#include <core/core.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::Sink;
+
+constexpr u32 Channels{2};
+constexpr u64 BufferFrames{240};
+constexpr u32 BuffersPerIteration{4};
+constexpr u32 Iterations{500};
+/// Written to buffers once they're cleared, the callback must never output it
+constexpr s16 Poison{0x5A5A};
+
+/// A stream whose callback is driven by the test, standing in for a backend
+class TestSinkStream final : public SinkStream {
+public:
+    TestSinkStream(Core::System& system_, StreamType type_) : SinkStream{system_, type_} {
+        device_channels = Channels;
+        system_channels = Channels;
+        name = "test";
+    }
+
+    void Start(bool resume = false) override {
+        paused = false;
+    }
+
+    void Stop() override {
+        paused = true;
+    }
+
+    bool IsInput() const {
+        return type == StreamType::In;
+    }
+};
+
+/// Calls the stream back on its own thread as fast as it can until destroyed, like a device would
+class Backend {
+public:
+    explicit Backend(TestSinkStream& stream_) : stream{stream_} {
+        thread = std::jthread([this](std::stop_token stop_token) { ThreadFunc(stop_token); });
+    }
+
+    bool SawPoison() const {
+        return saw_poison;
+    }
+
+    /// Stop calling back for a while, as a device might when it's reconfigured
+    void Stall(std::chrono::microseconds duration) {
+        stall_until = (std::chrono::steady_clock::now() + duration).time_since_epoch().count();
+    }
+
+private:
+    void ThreadFunc(std::stop_token stop_token) {
+        std::vector<s16> samples(BufferFrames / 4 * Channels);
+        while (!stop_token.stop_requested()) {
+            if (std::chrono::steady_clock::now().time_since_epoch().count() < stall_until) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                continue;
+            }
+            std::fill(samples.begin(), samples.end(), s16{1});
+            if (stream.IsInput()) {
+                stream.ProcessAudioIn(samples, samples.size() / Channels);
+            } else {
+                stream.ProcessAudioOutAndRender(samples, samples.size() / Channels);
+                if (std::find(samples.begin(), samples.end(), Poison) != samples.end()) {
+                    saw_poison = true;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    TestSinkStream& stream;
+    std::atomic<bool> saw_poison{};
+    std::atomic<std::chrono::steady_clock::rep> stall_until{};
+    std::jthread thread;
+};
+
+/// A running stream must leave the clear to its callback, not drop buffers the callback may be
+/// reading
+bool TestHandshake(Core::System& system) {
+    TestSinkStream stream{system, StreamType::Out};
+    stream.SetBufferConsumedCallback([] {});
+    stream.Start();
+
+    std::vector<s16> game_memory(BufferFrames * Channels, s16{1});
+    SinkBuffer buffer{BufferFrames, 0, 1, false, game_memory.data()};
+    stream.AppendBufferInPlace(buffer);
+
+    auto clear{std::async(std::launch::async, [&stream] { stream.ClearQueue(); })};
+    if (clear.wait_for(std::chrono::milliseconds(20)) != std::future_status::timeout ||
+        stream.GetQueueSize() != 1) {
+        std::printf("handshake: ClearQueue dropped buffers without waiting for the callback\n");
+        return false;
+    }
+
+    std::vector<s16> samples(BufferFrames / 4 * Channels);
+    stream.ProcessAudioOutAndRender(samples, samples.size() / Channels);
+    if (clear.wait_for(std::chrono::seconds(1)) != std::future_status::ready ||
+        stream.GetQueueSize() != 0 || stream.GetConsumedFrameCount() != BufferFrames) {
+        std::printf("handshake: the callback did not complete the clear\n");
+        return false;
+    }
+
+    std::printf("handshake: the callback cleared the queue\n");
+    return true;
+}
+
+bool TestOutputInPlace(Core::System& system) {
+    TestSinkStream stream{system, StreamType::Out};
+    stream.SetBufferConsumedCallback([] {});
+    stream.Start();
+
+    std::vector<s16> game_memory(BuffersPerIteration * BufferFrames * Channels);
+    u64 tag{1};
+    u64 appended_frames{0};
+    {
+        Backend backend{stream};
+        for (u32 iteration = 0; iteration < Iterations; iteration++) {
+            std::fill(game_memory.begin(), game_memory.end(), s16{1});
+            for (u32 i = 0; i < BuffersPerIteration; i++) {
+                SinkBuffer buffer{
+                    .frames{BufferFrames},
+                    .frames_played{0},
+                    .tag{tag++},
+                    .consumed{false},
+                    .samples{&game_memory[i * BufferFrames * Channels]},
+                };
+                stream.AppendBufferInPlace(buffer);
+                appended_frames += BufferFrames;
+            }
+            // Let the callback get part of the way through them.
+            std::this_thread::sleep_for(std::chrono::microseconds(iteration % 8 * 25));
+
+            stream.ClearQueue();
+            // The game may now reuse its buffers.
+            std::fill(game_memory.begin(), game_memory.end(), Poison);
+
+            if (stream.GetQueueSize() != 0 || stream.GetQueuedFrameCount() != 0) {
+                std::printf("out iteration %u: %u buffers, %llu frames left queued\n", iteration,
+                            stream.GetQueueSize(),
+                            static_cast<unsigned long long>(stream.GetQueuedFrameCount()));
+                return false;
+            }
+            if (stream.GetConsumedFrameCount() != appended_frames) {
+                std::printf("out iteration %u: %llu frames consumed, %llu appended\n", iteration,
+                            static_cast<unsigned long long>(stream.GetConsumedFrameCount()),
+                            static_cast<unsigned long long>(appended_frames));
+                return false;
+            }
+            if (stream.TakeConsumedBuffer(tag - 1)) {
+                std::printf("out iteration %u: a tag survived the clear\n", iteration);
+                return false;
+            }
+        }
+        if (backend.SawPoison()) {
+            std::printf("out: a cleared buffer was read after ClearQueue returned\n");
+            return false;
+        }
+    }
+
+    // Stopped streams are cleared directly.
+    stream.Stop();
+    SinkBuffer buffer{BufferFrames, 0, tag++, false, game_memory.data()};
+    stream.AppendBufferInPlace(buffer);
+    stream.ClearQueue();
+    if (stream.GetQueueSize() != 0 ||
+        stream.GetConsumedFrameCount() != appended_frames + BufferFrames) {
+        std::printf("out: clearing a stopped stream left buffers queued\n");
+        return false;
+    }
+
+    std::printf("out: %u clears while calling back\n", Iterations);
+    return true;
+}
+
+/// A backend resuming around the ClearQueue timeout must not read the buffers being dropped
+bool TestStalledBackend(Core::System& system) {
+    constexpr u32 StallIterations{12};
+    TestSinkStream stream{system, StreamType::Out};
+    stream.SetBufferConsumedCallback([] {});
+    stream.Start();
+
+    std::vector<s16> game_memory(BuffersPerIteration * BufferFrames * Channels);
+    u64 tag{1};
+    u64 appended_frames{0};
+    {
+        Backend backend{stream};
+        for (u32 iteration = 0; iteration < StallIterations; iteration++) {
+            std::fill(game_memory.begin(), game_memory.end(), s16{1});
+            for (u32 i = 0; i < BuffersPerIteration; i++) {
+                SinkBuffer buffer{BufferFrames, 0, tag++, false,
+                                  &game_memory[i * BufferFrames * Channels]};
+                stream.AppendBufferInPlace(buffer);
+                appended_frames += BufferFrames;
+            }
+
+            // Stalls either side of the timeout, so some clears are done by the callback and
+            // some directly, with the callback resuming just before or during them.
+            backend.Stall(std::chrono::microseconds(194000 + iteration * 1000));
+            stream.ClearQueue();
+            std::fill(game_memory.begin(), game_memory.end(), Poison);
+
+            if (stream.GetQueueSize() != 0 || stream.GetQueuedFrameCount() != 0 ||
+                stream.GetConsumedFrameCount() != appended_frames) {
+                std::printf("stall iteration %u: %u buffers queued, %llu of %llu frames "
+                            "consumed\n",
+                            iteration, stream.GetQueueSize(),
+                            static_cast<unsigned long long>(stream.GetConsumedFrameCount()),
+                            static_cast<unsigned long long>(appended_frames));
+                return false;
+            }
+        }
+        if (backend.SawPoison()) {
+            std::printf("stall: a cleared buffer was read after ClearQueue returned\n");
+            return false;
+        }
+    }
+
+    std::printf("stall: %u clears around the timeout\n", StallIterations);
+    return true;
+}
+
+bool TestInput(Core::System& system) {
+    TestSinkStream stream{system, StreamType::In};
+    stream.SetBufferConsumedCallback([] {});
+    stream.Start();
+
+    std::vector<s16> game_buffer(BufferFrames * Channels);
+    u64 tag{1};
+    u64 taken{0};
+    {
+        Backend backend{stream};
+        for (u32 iteration = 0; iteration < Iterations; iteration++) {
+            std::vector<s16> no_samples;
+            for (u32 i = 0; i < BuffersPerIteration; i++) {
+                SinkBuffer buffer{BufferFrames, 0, tag++, false, nullptr};
+                stream.AppendBuffer(buffer, no_samples);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(iteration % 8 * 25));
+
+            // Release what has been recorded so far, in order, as the game would.
+            for (u64 released = tag - BuffersPerIteration; released < tag; released++) {
+                if (!stream.TakeConsumedBuffer(released)) {
+                    break;
+                }
+                stream.ReleaseBuffer(game_buffer);
+                taken++;
+            }
+
+            stream.ClearQueue();
+            if (stream.GetQueueSize() != 0 || stream.TakeConsumedBuffer(tag - 1)) {
+                std::printf("in iteration %u: buffers or tags survived the clear\n", iteration);
+                return false;
+            }
+        }
+    }
+
+    std::printf("in: %u clears while calling back, %llu buffers recorded\n", Iterations,
+                static_cast<unsigned long long>(taken));
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Sink::AudioSink = "null";
+    Core::System system{};
+
+    if (!TestHandshake(system) || !TestOutputInPlace(system) || !TestStalledBackend(system) ||
+        !TestInput(system)) {
+        return 1;
+    }
+    return 0;
+}
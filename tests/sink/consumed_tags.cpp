@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Plays buffers read in place while a backend thread calls back, and recycles them from a manager
+// thread woken through Event, as the audio manager does. Every wakeup must arrive, every tag must
+// be taken once and in order, and a buffer must be finished with once its tag is taken, so the
+// game can reuse it straight away.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <audio_core/audio_event.h>
+#include <audio_core/sink/sink_details.h>
+#include <audio_core/sink/sink_stream.h>
+#include <core/core.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::Sink;
+
+constexpr u32 Channels{2};
+constexpr u64 BufferFrames{240};
+constexpr u64 BuffersInFlight{3};
+constexpr u64 BufferCount{3000};
+/// Written to buffers once their tag is taken, the callback must never output it
+constexpr s16 Poison{0x5A5A};
+
+/// A stream whose callback is driven by the test, standing in for a backend
+class TestSinkStream final : public SinkStream {
+public:
+    explicit TestSinkStream(Core::System& system_) : SinkStream{system_, StreamType::Out} {
+        device_channels = Channels;
+        system_channels = Channels;
+        name = "test";
+    }
+
+    void Start(bool resume = false) override {
+        paused = false;
+    }
+
+    void Stop() override {
+        paused = true;
+    }
+};
+
+/// Calls the stream back on its own thread until destroyed, like a device would
+class Backend {
+public:
+    explicit Backend(TestSinkStream& stream_) : stream{stream_} {
+        thread = std::jthread([this](std::stop_token stop_token) { ThreadFunc(stop_token); });
+    }
+
+    bool SawPoison() const {
+        return saw_poison;
+    }
+
+private:
+    void ThreadFunc(std::stop_token stop_token) {
+        std::vector<s16> samples(BufferFrames / 4 * Channels);
+        while (!stop_token.stop_requested()) {
+            stream.ProcessAudioOutAndRender(samples, samples.size() / Channels);
+            if (std::find(samples.begin(), samples.end(), Poison) != samples.end()) {
+                saw_poison = true;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    TestSinkStream& stream;
+    std::atomic<bool> saw_poison{};
+    std::jthread thread;
+};
+
+bool Run(Core::System& system) {
+    Event events{};
+    events.ClearEvents();
+
+    TestSinkStream stream{system};
+    stream.SetBufferConsumedCallback(
+        [&events] { events.SetAudioEvent(Event::Type::AudioOutManager, true); });
+    stream.Start();
+
+    std::vector<s16> game_memory(BuffersInFlight * BufferFrames * Channels);
+    u64 next_append{0};
+    const auto append{[&] {
+        const auto slot{&game_memory[next_append % BuffersInFlight * BufferFrames * Channels]};
+        std::fill(slot, slot + BufferFrames * Channels, s16{1});
+        SinkBuffer buffer{BufferFrames, 0, next_append, false, slot};
+        stream.AppendBufferInPlace(buffer);
+        next_append++;
+    }};
+
+    u64 next_release{0};
+    u32 wakeups{0};
+    {
+        Backend backend{stream};
+        while (next_append < BuffersInFlight) {
+            append();
+        }
+
+        while (next_release < BufferCount) {
+            if (events.Wait(std::chrono::seconds(2))) {
+                std::printf("wakeup lost, %llu of %llu appended buffers released\n",
+                            static_cast<unsigned long long>(next_release),
+                            static_cast<unsigned long long>(next_append));
+                return false;
+            }
+            if (!events.TakeAudioEvent(Event::Type::AudioOutManager)) {
+                continue;
+            }
+            wakeups++;
+
+            while (next_release < next_append && stream.TakeConsumedBuffer(next_release)) {
+                const auto end_frame{(next_release + 1) * BufferFrames};
+                if (stream.GetConsumedFrameCount() < end_frame) {
+                    std::printf("buffer %llu: tag taken at frame %llu, before its end %llu\n",
+                                static_cast<unsigned long long>(next_release),
+                                static_cast<unsigned long long>(stream.GetConsumedFrameCount()),
+                                static_cast<unsigned long long>(end_frame));
+                    return false;
+                }
+                // The game may now reuse the buffer.
+                const auto slot{&game_memory[next_release % BuffersInFlight * BufferFrames *
+                                             Channels]};
+                std::fill(slot, slot + BufferFrames * Channels, Poison);
+                next_release++;
+            }
+
+            // Refill once the batch is drained, so nothing else can set the event if the last
+            // tag's wakeup is lost.
+            if (next_release == next_append) {
+                while (next_append < std::min(next_release + BuffersInFlight, BufferCount)) {
+                    append();
+                }
+            }
+        }
+
+        if (backend.SawPoison()) {
+            std::printf("a buffer was read after its tag was taken\n");
+            return false;
+        }
+    }
+
+    std::printf("%llu buffers released in order over %u wakeups\n",
+                static_cast<unsigned long long>(next_release), wakeups);
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Sink::AudioSink = "null";
+    Core::System system{};
+
+    if (!Run(system)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
+// SPDX-License-Identifier: MPL-2.0
+
+// Runs DriftCompensator as SinkStream does, against a producer 0.3% faster and then 0.3% slower
+// than the device consumes. Checks the ring fill settles near the target, the ratio never leaves
+// MaxRatioOffset and settles at the rate difference, and every output frame is the input
+// interpolated at a position which only advances by the ratio, so the frames carried between
+// callbacks are neither dropped nor repeated.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include <audio_core/sink/drift_compensator.h>
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::Sink;
+
+constexpr u32 Channels{2};
+/// Frames in each buffer the producer queues
+constexpr u64 BufferFrames{240};
+/// Frames the device asks for in each callback
+constexpr u64 CallbackFrames{256};
+constexpr u64 TargetFrames{BufferFrames * 8};
+constexpr u32 CallbackCount{30000};
+/// Callbacks at the end the fill and ratio must have settled over
+constexpr u32 SettledCallbackCount{5000};
+constexpr std::array<f64, 2> RateOffsets{0.003, -0.003};
+
+/// The signal the producer writes, a ramp per channel which wraps
+s16 GetSample(u64 frame, u32 channel) {
+    return static_cast<s16>(frame * (channel == 0 ? 7 : 13) + channel * 1000);
+}
+
+/// The output expected at a position between two input frames
+s16 Interpolate(f64 position, u32 channel) {
+    const auto index{static_cast<u64>(position)};
+    const auto fraction{position - static_cast<f64>(index)};
+    const auto current{static_cast<f64>(GetSample(index, channel))};
+    const auto next{static_cast<f64>(GetSample(index + 1, channel))};
+    return static_cast<s16>(std::round(current + (next - current) * fraction));
+}
+
+bool Run(f64 rate_offset) {
+    DriftCompensator compensator{};
+    std::deque<s16> ring;
+    std::vector<s16> output(CallbackFrames * Channels);
+    u64 frames_produced{0};
+    f64 frames_owed{0.0};
+    f64 position{0.0};
+    f64 settled_fill{0.0};
+    f64 settled_ratio{0.0};
+
+    const auto produce = [&](u64 num_frames) {
+        for (u64 frame = 0; frame < num_frames; frame++, frames_produced++) {
+            for (u32 channel = 0; channel < Channels; channel++) {
+                ring.push_back(GetSample(frames_produced, channel));
+            }
+        }
+    };
+    produce(TargetFrames);
+
+    for (u32 callback = 0; callback < CallbackCount; callback++) {
+        // Whole buffers arrive as the producer, running at its own rate, finishes them.
+        frames_owed += static_cast<f64>(CallbackFrames) * (1.0 + rate_offset);
+        while (frames_owed >= static_cast<f64>(BufferFrames)) {
+            produce(BufferFrames);
+            frames_owed -= static_cast<f64>(BufferFrames);
+        }
+
+        const auto queued_frames{ring.size() / Channels};
+        compensator.UpdateRatio(queued_frames, TargetFrames);
+        const auto ratio{compensator.GetRatio()};
+        if (std::abs(ratio - 1.0) > DriftCompensator::MaxRatioOffset) {
+            std::printf("offset %+.3f, callback %u: ratio %.6f out of range\n", rate_offset,
+                        callback, ratio);
+            return false;
+        }
+
+        const auto input{compensator.PrepareInput(CallbackFrames, Channels)};
+        if (input.size() > ring.size()) {
+            std::printf("offset %+.3f, callback %u: ring underran\n", rate_offset, callback);
+            return false;
+        }
+        std::copy_n(ring.begin(), input.size(), input.begin());
+        ring.erase(ring.begin(), ring.begin() + static_cast<std::ptrdiff_t>(input.size()));
+        compensator.Resample(output, CallbackFrames);
+
+        for (u64 frame = 0; frame < CallbackFrames; frame++) {
+            const auto frame_position{position + static_cast<f64>(frame) * ratio};
+            for (u32 channel = 0; channel < Channels; channel++) {
+                const auto expected{Interpolate(frame_position, channel)};
+                const auto sample{output[frame * Channels + channel]};
+                if (std::abs(sample - expected) > 1) {
+                    std::printf("offset %+.3f, callback %u: frame %llu channel %u is %d, "
+                                "expected %d\n",
+                                rate_offset, callback, static_cast<unsigned long long>(frame),
+                                channel, sample, expected);
+                    return false;
+                }
+            }
+        }
+        position += static_cast<f64>(CallbackFrames) * ratio;
+
+        if (callback >= CallbackCount - SettledCallbackCount) {
+            settled_fill += static_cast<f64>(queued_frames) / SettledCallbackCount;
+            settled_ratio += ratio / SettledCallbackCount;
+        }
+    }
+
+    const auto fill_error{std::abs(settled_fill - static_cast<f64>(TargetFrames))};
+    const auto ratio_error{std::abs(settled_ratio - (1.0 + rate_offset))};
+    std::printf("offset %+.3f: fill settled at %.0f of %llu frames, ratio at %.5f\n", rate_offset,
+                settled_fill, static_cast<unsigned long long>(TargetFrames), settled_ratio);
+    if (fill_error > static_cast<f64>(BufferFrames) || ratio_error > 0.0002) {
+        std::printf("offset %+.3f: did not settle\n", rate_offset);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    for (const auto rate_offset : RateOffsets) {
+        if (!Run(rate_offset)) {
+            return 1;
+        }
+    }
+    return 0;
+}